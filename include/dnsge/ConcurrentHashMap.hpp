@@ -0,0 +1,215 @@
+#pragma once
+
+#include "HashMap.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+
+namespace dnsge {
+
+/**
+ * @brief A HashMap split into independently locked shards, for maps shared
+ * between threads. Keys are assigned to shards by hash, so threads working on
+ * different keys rarely wait on each other, and readers of the same shard
+ * share its lock.
+ *
+ * Values are only accessed through copies or callbacks run under the shard
+ * lock, since other threads may move them at any time. Callbacks must not
+ * access the map again.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>,
+          size_t ShardCount = 16>
+class ConcurrentHashMap {
+public:
+    static_assert(std::has_single_bit(ShardCount), "Shard count must be a power of two");
+
+    ConcurrentHashMap() = default;
+
+    ConcurrentHashMap(const ConcurrentHashMap &) = delete;
+    ConcurrentHashMap &operator=(const ConcurrentHashMap &) = delete;
+
+    /**
+     * @brief Insert a key-value pair. Returns whether it was inserted, i.e.
+     * whether the key had no value yet.
+     *
+     * @param key Key to insert.
+     * @param value Value to insert.
+     */
+    bool insert(const K &key, V value) {
+        auto &shard = this->shardOf(key);
+        std::unique_lock lock(shard.mu);
+        return shard.map.insert({key, std::move(value)}).has_value();
+    }
+
+    /**
+     * @brief Erase the value of a key. Returns whether a value was erased.
+     *
+     * @param key Key to erase.
+     */
+    bool erase(const K &key) {
+        auto &shard = this->shardOf(key);
+        std::unique_lock lock(shard.mu);
+        return shard.map.erase(key);
+    }
+
+    /**
+     * @brief Remove the value of a key and return it, if present.
+     *
+     * @param key Key to remove.
+     */
+    std::optional<V> take(const K &key) {
+        auto &shard = this->shardOf(key);
+        std::unique_lock lock(shard.mu);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return std::nullopt;
+        }
+        std::optional<V> value{std::move(it->second)};
+        shard.map.erase(it);
+        return value;
+    }
+
+    /**
+     * @brief Get a copy of the value of a key, if present.
+     *
+     * @param key Key to look up.
+     */
+    std::optional<V> get(const K &key) const {
+        auto &shard = this->shardOf(key);
+        std::shared_lock lock(shard.mu);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Check whether a key is present.
+     *
+     * @param key Key to look for.
+     */
+    bool contains(const K &key) const {
+        auto &shard = this->shardOf(key);
+        std::shared_lock lock(shard.mu);
+        return shard.map.contains(key);
+    }
+
+    /**
+     * @brief Call f with the value of a key while holding a shared lock on its
+     * shard. Returns whether the key was present.
+     *
+     * @param key Key to look up.
+     * @param f Functor taking a const reference to the value.
+     */
+    template <typename F>
+    bool visit(const K &key, F &&f) const {
+        auto &shard = this->shardOf(key);
+        std::shared_lock lock(shard.mu);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        std::forward<F>(f)(std::as_const(it->second));
+        return true;
+    }
+
+    /**
+     * @brief Call f with the value of a key while holding an exclusive lock on
+     * its shard. Returns whether the key was present.
+     *
+     * @param key Key to look up.
+     * @param f Functor taking a reference to the value.
+     */
+    template <typename F>
+    bool update(const K &key, F &&f) {
+        auto &shard = this->shardOf(key);
+        std::unique_lock lock(shard.mu);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            return false;
+        }
+        std::forward<F>(f)(it->second);
+        return true;
+    }
+
+    /**
+     * @brief Call f with every key-value pair. Shards are visited one at a time
+     * under a shared lock, so this is not a snapshot of the whole map: pairs in
+     * shards not visited yet may change meanwhile.
+     *
+     * @param f Functor taking a key and a const reference to its value.
+     */
+    template <typename F>
+    void forEach(F &&f) const {
+        for (const auto &shard : this->shards_) {
+            std::shared_lock lock(shard.mu);
+            for (const auto &entry : shard.map) {
+                f(entry.first, entry.second);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove all key-value pairs.
+     */
+    void clear() {
+        for (auto &shard : this->shards_) {
+            std::unique_lock lock(shard.mu);
+            shard.map.clear();
+        }
+    }
+
+    /**
+     * @brief Get the number of key-value pairs. Only exact if no other thread
+     * is modifying the map.
+     */
+    size_t size() const {
+        size_t size = 0;
+        for (const auto &shard : this->shards_) {
+            std::shared_lock lock(shard.mu);
+            size += shard.map.size();
+        }
+        return size;
+    }
+
+private:
+    // Keep each shard on its own cache line, so locking one shard doesn't
+    // invalidate its neighbors in other cores' caches
+    static constexpr size_t CacheLineSize = 64;
+
+    struct alignas(CacheLineSize) Shard {
+        mutable std::shared_mutex mu;
+        HashMap<K, V, Hash, Eq> map;
+    };
+
+    Shard &shardOf(const K &key) {
+        return this->shards_[shardIndex(key)];
+    }
+
+    const Shard &shardOf(const K &key) const {
+        return this->shards_[shardIndex(key)];
+    }
+
+    static size_t shardIndex(const K &key) {
+        // Use the top bits of the mixed hash. The shard's HashMap probes with
+        // the low bits, so keys stay spread out within each shard.
+        constexpr auto shardBits = std::countr_zero(ShardCount);
+        if constexpr (shardBits == 0) {
+            return 0;
+        } else {
+            auto hash = detail::MixHash(Hash{}(key));
+            return hash >> (sizeof(size_t) * 8 - shardBits);
+        }
+    }
+
+    std::array<Shard, ShardCount> shards_;
+};
+
+} // namespace dnsge
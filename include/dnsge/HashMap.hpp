@@ -2,16 +2,25 @@
 
 #include "FixedUninitVec.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <new>
 #include <optional>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DNSGE_HASHMAP_SSE2 1
+#endif
+
 namespace dnsge {
 
 namespace detail {
@@ -30,6 +39,29 @@ constexpr bool IsFree(metadata_t metadata) {
     return metadata >= 0b10000000;
 }
 
+/**
+ * @brief Number of slots whose metadata is matched at once. Tables are probed
+ * one group at a time.
+ */
+constexpr size_t GroupWidth = 16;
+
+/**
+ * @brief Spread the bits of a hash across the whole word. Hashes such as
+ * std::hash<int> are the identity, which would put consecutive keys into the
+ * same group and leave H2 with only a few distinct values.
+ */
+constexpr size_t MixHash(size_t hash) {
+    if constexpr (sizeof(size_t) >= 8) {
+        hash *= static_cast<size_t>(0x9e3779b97f4a7c15ULL);
+        hash ^= hash >> 32;
+    } else {
+        hash ^= hash >> 16;
+        hash *= static_cast<size_t>(0x45d9f3bU);
+        hash ^= hash >> 16;
+    }
+    return hash;
+}
+
 constexpr size_t H1(size_t hash) {
     // Remove the lower 7 bits of hash
     return hash >> 7;
@@ -44,17 +76,126 @@ static_assert(IsFree(Metadata::Empty), "Empty should be considered free");
 static_assert(IsFree(Metadata::Deleted), "Deleted should be considered free");
 static_assert(!IsFree(H2(0xFFFF)), "H2 of 0xFFFF should be not be considered free");
 
+/**
+ * @brief The metadata of GroupWidth consecutive slots. Matches return a mask
+ * where bit i is set if slot i of the group matched.
+ */
+class Group {
+public:
+    explicit Group(const metadata_t* metadata) {
+#ifdef DNSGE_HASHMAP_SSE2
+        this->metadata_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(metadata));
+#else
+        std::memcpy(this->metadata_, metadata, GroupWidth);
+#endif
+    }
+
+    /**
+     * @brief Match slots with a metadata value.
+     */
+    uint32_t match(metadata_t value) const {
+#ifdef DNSGE_HASHMAP_SSE2
+        auto matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(value)), this->metadata_);
+        return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GroupWidth; ++i) {
+            if (this->metadata_[i] == value) {
+                mask |= 1U << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+    uint32_t matchEmpty() const {
+        return this->match(Metadata::Empty);
+    }
+
+    /**
+     * @brief Match slots that are empty or deleted.
+     */
+    uint32_t matchFree() const {
+#ifdef DNSGE_HASHMAP_SSE2
+        // Free slots are exactly those with the high bit set
+        return static_cast<uint32_t>(_mm_movemask_epi8(this->metadata_));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GroupWidth; ++i) {
+            if (IsFree(this->metadata_[i])) {
+                mask |= 1U << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+private:
+#ifdef DNSGE_HASHMAP_SSE2
+    __m128i metadata_;
+#else
+    metadata_t metadata_[GroupWidth];
+#endif
+};
+
+/**
+ * @brief The sequence of groups probed for a hash. The step grows by one group
+ * every time, which visits every group when the group count is a power of two.
+ */
+class ProbeSequence {
+public:
+    ProbeSequence(size_t h1, size_t groupMask)
+        : groupMask_(groupMask)
+        , group_(h1 & groupMask) {}
+
+    /**
+     * @brief Index of the first slot of the current group.
+     */
+    size_t offset() const {
+        return this->group_ * GroupWidth;
+    }
+
+    void next() {
+        ++this->step_;
+        this->group_ = (this->group_ + this->step_) & this->groupMask_;
+    }
+
+private:
+    size_t groupMask_;
+    size_t group_;
+    size_t step_{0};
+};
+
+/**
+ * @brief Whether a hasher and key comparator accept any key type, so a map can
+ * be searched without constructing a key (e.g. std::string_view for
+ * std::string keys).
+ */
+template <typename Hash, typename Eq>
+concept TransparentLookup = requires {
+    typename Hash::is_transparent;
+    typename Eq::is_transparent;
+};
+
 // NOLINTEND(readability-magic-numbers)
 
 }; // namespace detail
 
+/**
+ * @brief An open-addressing hash map in the style of Swiss tables. Every slot
+ * has a byte of metadata holding 7 bits of its key's hash, and lookups match a
+ * group of 16 metadata bytes at once (with SSE2 when available) before
+ * comparing any keys.
+ *
+ * Elements are stored inline, so inserting may move them; erasing never moves
+ * other elements.
+ */
 template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
 class HashMap {
 public:
     static constexpr size_t DefaultInitialCapacity = 16;
     static constexpr float MaxLoadFactor = 0.875;
-    static constexpr float MaxDeletedLoadFactor = 0.875;
-    static constexpr float GrowthFactor = 2;
+    static constexpr size_t GrowthFactor = 2;
 
     using Slot = std::pair<const K, V>;
 
@@ -64,17 +205,29 @@ public:
     template <typename SlotType>
     class MapIterator {
     private:
-        MapIterator(size_t idex, SlotType* slotPtr)
+        MapIterator(size_t idex, SlotType* slots, const detail::metadata_t* metadata,
+                    size_t capacity)
             : idex_(idex)
-            , slotPtr_(slotPtr) {}
+            , slots_(slots)
+            , metadata_(metadata)
+            , capacity_(capacity) {}
 
     public:
         SlotType &operator*() const {
-            return *this->slotPtr_;
+            return this->slots_[this->idex_];
         }
 
         SlotType* operator->() const {
-            return this->slotPtr_;
+            return this->slots_ + this->idex_;
+        }
+
+        /**
+         * @brief Advance to the next element. Iteration order is unspecified.
+         */
+        MapIterator &operator++() {
+            ++this->idex_;
+            this->skipFree();
+            return *this;
         }
 
         bool operator==(const MapIterator &other) const {
@@ -87,45 +240,67 @@ public:
 
     private:
         friend class HashMap<K, V, Hash, Eq>;
+
+        void skipFree() {
+            while (this->idex_ < this->capacity_ && detail::IsFree(this->metadata_[this->idex_])) {
+                ++this->idex_;
+            }
+        }
+
         size_t idex_;
-        SlotType* slotPtr_;
+        SlotType* slots_;
+        const detail::metadata_t* metadata_;
+        size_t capacity_;
     };
 
     using iterator = MapIterator<Slot>;
     using const_iterator = MapIterator<const Slot>;
 
     /**
-     * @brief Construct a new HashMap with a default capacity.
+     * @brief Construct an empty HashMap. No slots are allocated until the first
+     * insertion.
      */
     HashMap()
-        : HashMap(DefaultInitialCapacity) {}
+        : HashMap(0) {}
 
     /**
      * @brief Construct a new HashMap with a specified capacity.
-     * 
-     * @param initialCapacity Initial slot capacity.
+     *
+     * @param initialCapacity Initial slot capacity. Rounded up to a power of two
+     * of at least one group.
      */
     HashMap(size_t initialCapacity)
-        : capacity_(initialCapacity)
+        : capacity_(roundCapacity(initialCapacity))
         , size_(0)
-        , slots_(initialCapacity)
+        , slots_(capacity_)
         , deletedCount_(0) {
-        this->metadata_.resize(initialCapacity, detail::Metadata::Empty);
+        this->metadata_.resize(this->capacity_, detail::Metadata::Empty);
     }
 
     ~HashMap() {
-        if (this->empty()) {
-            return;
-        }
+        this->destroySlots();
+    }
+
+    HashMap(const HashMap &other)
+        : capacity_(other.capacity_)
+        , size_(other.size_)
+        , metadata_(other.metadata_)
+        , slots_(other.capacity_)
+        , deletedCount_(other.deletedCount_) {
         for (size_t i = 0; i < this->capacity_; ++i) {
             if (!detail::IsFree(this->metadata_[i])) {
-                this->slots_[i].~Slot(); // Destroy slot entry
+                new (&this->slots_[i]) Slot{other.slots_[i]};
             }
         }
     }
 
-    HashMap(const HashMap &other) = default;
-    HashMap &operator=(const HashMap &other) = default;
+    HashMap &operator=(const HashMap &other) {
+        if (this != &other) {
+            HashMap temp(other);
+            *this = std::move(temp);
+        }
+        return *this;
+    }
 
     HashMap(HashMap &&other) noexcept
         : capacity_(other.capacity_)
@@ -133,17 +308,23 @@ public:
         , metadata_(std::move(other.metadata_))
         , slots_(std::move(other.slots_))
         , deletedCount_(other.deletedCount_) {
+        other.metadata_.clear();
         other.capacity_ = 0;
         other.size_ = 0;
         other.deletedCount_ = 0;
     }
 
     HashMap &operator=(HashMap &&other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        this->destroySlots();
         this->capacity_ = other.capacity_;
         this->size_ = other.size_;
         this->metadata_ = std::move(other.metadata_);
         this->slots_ = std::move(other.slots_);
         this->deletedCount_ = other.deletedCount_;
+        other.metadata_.clear();
         other.capacity_ = 0;
         other.size_ = 0;
         other.deletedCount_ = 0;
@@ -152,7 +333,7 @@ public:
 
     /**
      * @brief Find a key-value pair in the HashMap.
-     * 
+     *
      * @param key Key to look up.
      * @return Iterator to the element, or end() if not found.
      */
@@ -162,7 +343,7 @@ public:
 
     /**
      * @brief Find a key-value pair in the HashMap.
-     * 
+     *
      * @param key Key to look up.
      * @return Iterator to the element, or end() if not found.
      */
@@ -170,15 +351,53 @@ public:
         return this->iteratorAt(this->doFind(key));
     }
 
+    /**
+     * @brief Find a key-value pair by a value that is comparable with keys,
+     * without constructing a key. Requires a transparent Hash and Eq.
+     *
+     * @param key Value to look up.
+     * @return Iterator to the element, or end() if not found.
+     */
+    template <typename Q>
+        requires detail::TransparentLookup<Hash, Eq>
+    iterator find(const Q &key) {
+        return this->iteratorAt(this->doFind(key));
+    }
+
+    /**
+     * @brief Find a key-value pair by a value that is comparable with keys,
+     * without constructing a key. Requires a transparent Hash and Eq.
+     *
+     * @param key Value to look up.
+     * @return Iterator to the element, or end() if not found.
+     */
+    template <typename Q>
+        requires detail::TransparentLookup<Hash, Eq>
+    const_iterator find(const Q &key) const {
+        return this->iteratorAt(this->doFind(key));
+    }
+
     /**
      * @brief Check whether a key is present in the HashMap.
-     * 
+     *
      * @param key Key to look for.
      */
     bool contains(const K &key) const {
         return this->doFind(key).has_value();
     }
 
+    /**
+     * @brief Check whether a key is present in the HashMap, by a value that is
+     * comparable with keys. Requires a transparent Hash and Eq.
+     *
+     * @param key Value to look for.
+     */
+    template <typename Q>
+        requires detail::TransparentLookup<Hash, Eq>
+    bool contains(const Q &key) const {
+        return this->doFind(key).has_value();
+    }
+
     /**
      * @brief Get the value of a key in the HashMap. Throws std::out_of_range if
      * the key is not in the HashMap.
@@ -194,63 +413,70 @@ public:
         throw std::out_of_range("key not found");
     }
 
+    /**
+     * @brief Get the value of a key in the HashMap. Throws std::out_of_range if
+     * the key is not in the HashMap.
+     *
+     * @param key Key to look up.
+     * @return Reference to found value.
+     */
+    const V &at(const K &key) const {
+        auto res = this->doFind(key);
+        if (res) {
+            return this->slots_[res.value()].second;
+        }
+        throw std::out_of_range("key not found");
+    }
+
     /**
      * @brief Insert a key-value pair into the HashMap. Returns the iterator to
      * the inserted key-value pair, or std::nullopt if the key already has a value.
-     * 
+     *
      * @param value Key-value pair to insert.
      * @return Iterator or std::nullopt if already exists.
      */
     std::optional<iterator> insert(const std::pair<K, V> &value) {
-        // Check if we need to grow
-        if (this->needRehashBeforeInsertion()) {
-            this->growOrRehash();
-        }
-        // Perform the insert
-        return this->insertUnchecked(value);
+        return this->insertUnique(value.first, value.second);
     }
 
     /**
      * @brief Insert a key-value pair into the HashMap. Returns the iterator to
      * the inserted key-value pair, or std::nullopt if the key already has a value.
-     * 
+     *
      * @param value Key-value pair to insert.
      * @return Iterator or std::nullopt if already exists.
      */
     std::optional<iterator> insert(std::pair<K, V> &&value) {
-        // Check if we need to grow
-        if (this->needRehashBeforeInsertion()) {
-            this->growOrRehash();
-        }
-        // Perform the insert
-        return this->insertUnchecked(std::move(value));
+        return this->insertUnique(std::move(value.first), std::move(value.second));
     }
 
     /**
      * @brief Get the value of a key in the HashMap. If the key is not present,
      * a default-constructed value is first inserted.
-     * 
+     *
      * @param key Key to look up.
      * @return Reference to the value.
      */
     template <typename U = V>
     typename std::enable_if_t<std::is_default_constructible_v<U>, V &> operator[](const K &key) {
-        auto res = this->doFind(key);
+        auto hash = hashOf(key);
+        auto res = this->doFindHashed(key, hash);
         if (res) {
             return this->slots_[res.value()].second;
         }
         // Need to insert and then return
-        auto it = this->insert(std::make_pair<K, V>(K{key}, V{}));
-        assert(it.has_value());
-        return this->slots_[it->idex_].second;
+        auto idex = this->prepareInsert(hash);
+        new (&this->slots_[idex]) Slot{key, V{}};
+        return this->slots_[idex].second;
     }
 
     /**
      * @brief Erase the key-value pair at an iterator. Returns whether the
-     * key-value pair was successfully removed.
-     * 
+     * key-value pair was successfully removed. Other elements are not moved, so
+     * iterators to them stay valid.
+     *
      * @param it Iterator to delete
-     * @return Whether the key-value pair was found and removed. 
+     * @return Whether the key-value pair was found and removed.
      */
     bool erase(iterator it) {
         if (it == this->end()) {
@@ -261,53 +487,40 @@ public:
         this->destroySlot(it.idex_);
         // Decrement size
         --this->size_;
-
-        // Check if we have an elevated number of deleted slots.
-        // If so, we want to rehash everything to prevent fragmentation.
-        if (this->needRehash()) {
-            this->rehashEverything();
-        }
-
         return true;
     }
 
     /**
      * @brief Erase the key-value pair of a key. Returns whether the
      * key-value pair was successfully removed.
-     * 
+     *
      * @param key Key to erase.
-     * @return Whether the key-value pair was found and removed. 
+     * @return Whether the key-value pair was found and removed.
      */
     bool erase(const K &key) {
         return this->erase(this->find(key));
     }
 
     /**
-     * @brief Clear all elements from the HashMap.
+     * @brief Clear all elements from the HashMap. Keeps the slot capacity.
      */
     void clear() {
-        if (this->empty()) {
-            return;
-        }
-        for (size_t i = 0; i < this->capacity_; ++i) {
-            if (!detail::IsFree(this->metadata_[i])) {
-                this->slots_[i].~Slot(); // Destroy slot entry
-            }
-            this->metadata_[i] = detail::Metadata::Empty;
-        }
+        this->destroySlots();
+        std::fill(this->metadata_.begin(), this->metadata_.end(), detail::Metadata::Empty);
         this->size_ = 0;
         this->deletedCount_ = 0;
     }
 
     /**
-     * @brief Reserve at least enough empty slots. Does not consider the load factor.
-     * Causes a rehash if growing is required.
-     * @param n Number of slots to reserve.
+     * @brief Reserve enough slots to hold n elements without exceeding the load
+     * factor. Causes a rehash if growing is required.
+     *
+     * @param n Number of elements to reserve for.
      */
     void reserve(size_t n) {
-        auto target = static_cast<size_t>(n / MaxLoadFactor);
-        if (this->capacity_ >= target) {
-            return;
+        auto target = roundCapacity(n);
+        while (growthLimit(target) < n) {
+            target *= GrowthFactor;
         }
         this->growAndRehash(target);
     }
@@ -333,12 +546,30 @@ public:
         return this->size_ == 0;
     }
 
+    /**
+     * @brief Get an iterator to the first element.
+     */
+    iterator begin() {
+        auto it = this->iteratorAt(0);
+        it.skipFree();
+        return it;
+    }
+
+    /**
+     * @brief Get an iterator to the first element.
+     */
+    const_iterator begin() const {
+        auto it = this->iteratorAt(0);
+        it.skipFree();
+        return it;
+    }
+
     /**
      * @brief Get an "end" iterator. "end" points to an invalid element and is
      * returned from HashMap operations as a sentinel value.
      */
     inline iterator end() {
-        return iteratorAt(this->slots_.size());
+        return iteratorAt(this->capacity_);
     }
 
     /**
@@ -346,126 +577,149 @@ public:
      * returned from HashMap operations as a sentinel value.
      */
     inline const_iterator end() const {
-        return iteratorAt(this->slots_.size());
+        return iteratorAt(this->capacity_);
     }
 
 private:
-    struct InsertionLoc {
-        // The internal HashMap index
-        size_t idex;
-        // The level 2 hash of the key (for metadata)
-        size_t h2;
-    };
+    /**
+     * @brief Round a capacity up to a whole, power-of-two number of groups.
+     */
+    static size_t roundCapacity(size_t capacity) {
+        if (capacity == 0) {
+            return 0;
+        }
+        return std::bit_ceil(std::max(capacity, detail::GroupWidth));
+    }
 
     /**
-     * @brief Compute the internal location for inserting a key.
-     * 
-     * @param key Key for insertion.
-     * @return The insertion location, or std::nullopt if the key already exists.
+     * @brief Number of slots that may be in use (including deleted slots)
+     * before the table must grow.
      */
-    std::optional<InsertionLoc> locationForInsertion(const K &key) const {
-        Hash hasher;
-        Eq eq;
-        size_t hash = hasher(key);
-        auto h1 = detail::H1(hash);
-        auto h2 = detail::H2(hash);
+    static size_t growthLimit(size_t capacity) {
+        return static_cast<size_t>(static_cast<double>(capacity) * MaxLoadFactor);
+    }
 
-        size_t idex = h1 % this->capacity_;
-        while (true) {
-            auto metadata = this->metadata_[idex];
-            if (detail::IsFree(metadata)) {
-                // Found free spot for insertion
-                return InsertionLoc{idex, h2};
-            } else if (metadata == h2 && eq(key, this->slots_[idex].first)) {
-                // Key already exists
-                return std::nullopt;
-            }
-            idex = (idex + 1) % this->capacity_;
-        }
+    template <typename Q>
+    static size_t hashOf(const Q &key) {
+        return detail::MixHash(Hash{}(key));
+    }
+
+    size_t groupMask() const {
+        return this->capacity_ / detail::GroupWidth - 1;
     }
 
     /**
-     * @brief Insert a key-value pair without checking for capacity.
-     * 
-     * @param value Key-value pair to insert.
+     * @brief Insert a key-value pair if the key is not present yet.
+     *
      * @return Iterator to the inserted key-value pair, or std::nullopt if key already exists.
      */
-    std::optional<iterator> insertUnchecked(const std::pair<K, V> &value) {
-        if (auto loc = this->locationForInsertion(value.first)) {
-            // Insert value into slot. Update the metadata with the hash data.
-            this->metadata_[loc->idex] = loc->h2;
-            // Construct new slot entry in place
-            new (&this->slots_[loc->idex]) Slot{value.first, value.second};
-            // Increment size
-            ++this->size_;
-            return this->iteratorAt(loc->idex);
+    template <typename KeyArg, typename ValueArg>
+    std::optional<iterator> insertUnique(KeyArg &&key, ValueArg &&value) {
+        auto hash = hashOf(key);
+        if (this->doFindHashed(key, hash)) {
+            return std::nullopt;
         }
-        return std::nullopt;
+        auto idex = this->prepareInsert(hash);
+        // Construct new slot entry in place
+        new (&this->slots_[idex]) Slot{std::forward<KeyArg>(key), std::forward<ValueArg>(value)};
+        return this->iteratorAt(idex);
     }
 
     /**
-     * @brief Insert a key-value pair without checking for capacity.
-     * 
-     * @param value Key-value pair to insert.
-     * @return Iterator to the inserted key-value pair, or std::nullopt if key already exists.
+     * @brief Claim a slot for a key that is known not to be present, growing
+     * the table if needed. The caller must construct the slot entry.
+     *
+     * @param hash Mixed hash of the key.
+     * @return Index of the claimed slot.
      */
-    std::optional<iterator> insertUnchecked(std::pair<K, V> &&value) {
-        if (auto loc = this->locationForInsertion(value.first)) {
-            // Insert value into slot. Update the metadata with the hash data.
-            this->metadata_[loc->idex] = loc->h2;
-            // Construct new slot entry in place, moving the values.
-            new (&this->slots_[loc->idex]) Slot{std::move(value.first), std::move(value.second)};
-            // Increment size
-            ++this->size_;
-            return this->iteratorAt(loc->idex);
+    size_t prepareInsert(size_t hash) {
+        // Check if we need to grow
+        if (this->needRehashBeforeInsertion()) {
+            this->growOrRehash();
         }
-        return std::nullopt;
+        auto idex = this->findFreeSlot(hash);
+        if (this->metadata_[idex] == detail::Metadata::Deleted) {
+            --this->deletedCount_;
+        }
+        // Update the metadata with the hash data
+        this->metadata_[idex] = detail::H2(hash);
+        ++this->size_;
+        return idex;
     }
 
     /**
-     * @brief Insert a slot rvalue.
-     * 
-     * @param slot Slot to insert.
-     * @return Iterator to the inserted slot, or std::nullopt if key already exists.
+     * @brief Find the first empty or deleted slot in the probe sequence of a hash.
      */
-    std::optional<iterator> insertUnchecked(Slot &&slot) {
-        if (auto loc = this->locationForInsertion(slot.first)) {
-            // Insert value into slot. Update the metadata with the hash data.
-            this->metadata_[loc->idex] = loc->h2;
-            // Move old slot into new slot.
-            new (&this->slots_[loc->idex]) Slot{std::move(slot)};
-            // Increment size
-            ++this->size_;
-            return this->iteratorAt(loc->idex);
+    size_t findFreeSlot(size_t hash) const {
+        detail::ProbeSequence probe{detail::H1(hash), this->groupMask()};
+        while (true) {
+            detail::Group group{this->metadata_.data() + probe.offset()};
+            if (auto free = group.matchFree()) {
+                return probe.offset() + std::countr_zero(free);
+            }
+            probe.next();
         }
-        return std::nullopt;
+    }
+
+    /**
+     * @brief Move a slot into a table that is known not to contain its key and
+     * to have room for it.
+     */
+    void insertMoved(Slot &&slot) {
+        auto hash = hashOf(slot.first);
+        auto idex = this->findFreeSlot(hash);
+        this->metadata_[idex] = detail::H2(hash);
+        // Move old slot into new slot.
+        new (&this->slots_[idex]) Slot{std::move(slot)};
+        ++this->size_;
     }
 
     /**
      * @brief Destroy the slot at an index. Update the metadata and call the slot destructor.
-     * 
+     *
      * @param idex Index to destroy at.
      */
     void destroySlot(size_t idex) {
-        // Mark slot as deleted
-        this->metadata_[idex] = detail::Metadata::Deleted;
-        ++this->deletedCount_;
+        // Probes stop at the first group with an empty slot. If this group has
+        // one, no probe ever continued past it, so the slot can become empty
+        // instead of deleted.
+        auto groupStart = idex & ~(detail::GroupWidth - 1);
+        if (detail::Group{this->metadata_.data() + groupStart}.matchEmpty() != 0) {
+            this->metadata_[idex] = detail::Metadata::Empty;
+        } else {
+            this->metadata_[idex] = detail::Metadata::Deleted;
+            ++this->deletedCount_;
+        }
         // Call destructor on slot entry
         this->slots_[idex].~Slot();
     }
 
+    /**
+     * @brief Call the destructor of every occupied slot. Does not update the metadata.
+     */
+    void destroySlots() {
+        if (this->empty()) {
+            return;
+        }
+        for (size_t i = 0; i < this->capacity_; ++i) {
+            if (!detail::IsFree(this->metadata_[i])) {
+                this->slots_[i].~Slot(); // Destroy slot entry
+            }
+        }
+    }
+
     /**
      * @brief Get an iterator to an internal HashTable index.
      */
     inline iterator iteratorAt(size_t idex) {
-        return iterator(idex, this->slots_.data() + idex);
+        return iterator(idex, this->slots_.data(), this->metadata_.data(), this->capacity_);
     }
 
     /**
      * @brief Get an iterator to an internal HashTable index.
      */
     inline const_iterator iteratorAt(size_t idex) const {
-        return const_iterator(idex, this->slots_.data() + idex);
+        return const_iterator(idex, this->slots_.data(), this->metadata_.data(), this->capacity_);
     }
 
     /**
@@ -492,143 +746,101 @@ private:
 
     /**
      * @brief Find a key in the HashTable.
-     * 
+     *
      * @param key Key to find.
      * @return Internal HashTable index of key-value, or std::nullopt if not found.
      */
-    std::optional<size_t> doFind(const K &key) const {
+    template <typename Q>
+    std::optional<size_t> doFind(const Q &key) const {
+        if (this->empty()) {
+            return std::nullopt;
+        }
+        return this->doFindHashed(key, hashOf(key));
+    }
+
+    /**
+     * @brief Find a key in the HashTable, given its mixed hash.
+     */
+    template <typename Q>
+    std::optional<size_t> doFindHashed(const Q &key, size_t hash) const {
         if (this->empty()) {
             return std::nullopt;
         }
-        Hash hasher;
         Eq eq;
-        size_t hash = hasher(key);
-        auto h1 = detail::H1(hash);
         auto h2 = detail::H2(hash);
 
-        size_t idex = h1 % this->capacity_;
+        detail::ProbeSequence probe{detail::H1(hash), this->groupMask()};
         while (true) {
-            auto metadata = this->metadata_[idex];
-            if (metadata == h2 && eq(key, this->slots_[idex].first)) {
-                // Found key
-                return idex;
-            } else if (metadata == detail::Metadata::Empty) {
+            detail::Group group{this->metadata_.data() + probe.offset()};
+            // Only compare keys of slots whose metadata matches
+            for (auto matches = group.match(h2); matches != 0; matches &= matches - 1) {
+                auto idex = probe.offset() + std::countr_zero(matches);
+                if (eq(key, this->slots_[idex].first)) {
+                    // Found key
+                    return idex;
+                }
+            }
+            if (group.matchEmpty() != 0) {
                 // Found empty slot, must not be in hash table
                 return std::nullopt;
             }
-            idex = (idex + 1) % this->capacity_;
+            probe.next();
         }
     }
 
     void growOrRehash() {
-        size_t effectiveSize = this->effectiveSize();
-        if ((float)this->deletedCount_ / effectiveSize > MaxDeletedLoadFactor) {
+        if (this->capacity_ == 0) {
+            this->growAndRehash(DefaultInitialCapacity);
+        } else if (this->size_ + 1 <= growthLimit(this->capacity_) / 2) {
             // A lot of capacity is being used by deleted slots, rehash everything
-            this->rehashEverything();
+            this->rehash(this->capacity_);
         } else {
             // Capacity is limited due to elements, grow AND rehash everything
-            this->growAndRehash();
-        }
-    }
-
-    /**
-     * @brief Double the capacity and rehash the table.
-     */
-    void growAndRehash() {
-        size_t newCapacity = static_cast<size_t>(this->capacity_ * GrowthFactor);
-        if (this->capacity_ == 0) {
-            newCapacity = DefaultInitialCapacity;
+            this->growAndRehash(this->capacity_ * GrowthFactor);
         }
-        this->growAndRehash(newCapacity);
     }
 
     /**
      * @brief Increase the capacity and rehash the table.
-     * 
-     * @param newCapacity 
+     *
+     * @param newCapacity
      */
     void growAndRehash(size_t newCapacity) {
         if (newCapacity <= this->capacity_) {
             return;
         }
-
-        // Temporary new table to move existing elements into
-        HashMap<K, V, Hash, Eq> newTable(newCapacity);
-
-        if (!this->empty()) {
-            for (size_t i = 0; i < this->capacity_; ++i) {
-                if (!detail::IsFree(this->metadata_[i])) {
-                    // Move slot data into new table
-                    newTable.insertUnchecked(std::move(this->slots_[i]));
-                    // Call destructor on residual slot
-                    this->slots_[i].~Slot();
-                    // Decrement size to avoid additional cleanup when *this is dropped
-                    --this->size_;
-                }
-            }
-        }
-
-        // Swap internals with temporary table
-        *this = std::move(newTable);
+        this->rehash(newCapacity);
     }
 
     /**
-     * @brief Rehash the HashTable without changing capacity.
+     * @brief Move every element into a new table of a capacity.
      */
-    void rehashEverything() {
-        if (this->empty()) {
-            return;
-        }
-
+    void rehash(size_t newCapacity) {
         // Temporary new table to move existing elements into
-        HashMap<K, V, Hash, Eq> newTable(this->capacity_);
+        HashMap<K, V, Hash, Eq> newTable(newCapacity);
+
         for (size_t i = 0; i < this->capacity_; ++i) {
             if (!detail::IsFree(this->metadata_[i])) {
                 // Move slot data into new table
-                newTable.insertUnchecked(std::move(this->slots_[i]));
+                newTable.insertMoved(std::move(this->slots_[i]));
                 // Call destructor on residual slot
                 this->slots_[i].~Slot();
-                // Decrement size to avoid additional cleanup when *this is dropped
-                --this->size_;
+                // Free the slot to avoid additional cleanup when *this is dropped
+                this->metadata_[i] = detail::Metadata::Empty;
             }
         }
+        this->size_ = 0;
 
-        assert(this->size_ == 0);
         // Swap internals with temporary table
         *this = std::move(newTable);
     }
 
-    size_t effectiveSize() const {
-        return this->size_ + this->deletedCount_;
-    }
-
     /**
-     * @brief Compute the current effective load factor.
-     */
-    float effectiveLoadFactor() const {
-        return ((float)this->effectiveSize()) / this->capacity_;
-    }
-
-    /**
-     * @brief Compute the load factor after an insertion.
-     */
-    float loadFactorAfterInsertion() const {
-        return ((float)(this->size_ + 1)) / this->capacity_;
-    }
-
-    /**
-     * @brief Check whether the load factor is too high and we need to rehash.
-     */
-    bool needRehash() const {
-        static_assert(MaxLoadFactor <= 1);
-        return this->effectiveLoadFactor() >= MaxLoadFactor || this->capacity_ == 0;
-    }
-
-    /**
-     * @brief Check whether the load factor will be too high after an insertion.
+     * @brief Check whether an insertion would exceed the load factor.
      */
     bool needRehashBeforeInsertion() const {
-        return this->loadFactorAfterInsertion() >= MaxLoadFactor || this->capacity_ == 0;
+        static_assert(MaxLoadFactor <= 1);
+        return this->size_ + this->deletedCount_ + 1 > growthLimit(this->capacity_);
     }
 
     size_t capacity_;
@@ -4,7 +4,7 @@
 #include "net/Replicator.hpp"
 
 #ifdef SGE_SERVER
-#    include "server/Server.hpp"
+#    include "server/Room.hpp"
 #else
 #    include "client/Client.hpp"
 #endif
@@ -29,7 +29,7 @@ client_id_t CurrentClientID() {
 
 net::ReplicatorService &CurrentReplicatorService() {
 #ifdef SGE_SERVER
-    return server::CurrentServer().replicatorService();
+    return server::CurrentRoom().replicatorService();
 #else
     return client::CurrentClient().replicatorService();
 #endif
@@ -0,0 +1,124 @@
+#include "bench/LuaCallBench.hpp"
+
+#include <lua/lua.hpp>
+#include <LuaBridge/LuaBridge.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "scripting/Invoke.hpp"
+#include "scripting/LuaCall.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace sge::bench {
+
+namespace {
+
+using JsonWriter = rapidjson::PrettyWriter<rapidjson::StringBuffer>;
+
+constexpr float Dt = 1.0F / 60.0F;
+constexpr const char* ActorName = "BenchActor";
+
+// An empty OnUpdate isolates the cost of the call itself. The other one does
+// the kind of work a movement script does.
+constexpr const char* EmptyUpdate = "return function(self, dt) end";
+constexpr const char* MoveUpdate = "return function(self, dt) self.x = self.x + self.vx * dt end";
+
+/**
+ * @brief Time a workload, in nanoseconds per call.
+ */
+template <typename F>
+double timePerCall(std::uint64_t calls, F &&workload) {
+    auto start = std::chrono::steady_clock::now();
+    workload();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           static_cast<double>(calls);
+}
+
+/**
+ * @brief Time every way of calling one OnUpdate function on a set of
+ * component tables, and write them as a JSON object value.
+ */
+void benchFunction(JsonWriter &writer, lua_State* L, const char* source,
+                   const LuaCallBenchConfig &config) {
+    luaL_dostring(L, source);
+    auto onUpdate = luabridge::LuaRef::fromStack(L, -1);
+    lua_pop(L, 1);
+
+    std::vector<luabridge::LuaRef> components;
+    components.reserve(config.components);
+    for (unsigned int i = 0; i < config.components; ++i) {
+        auto component = luabridge::newTable(L);
+        component["x"] = 0.0F;
+        component["vx"] = 1.0F;
+        components.push_back(component);
+    }
+
+    auto calls = static_cast<std::uint64_t>(config.components) * config.rounds;
+    auto luaBridge = timePerCall(calls, [&] {
+        for (unsigned int round = 0; round < config.rounds; ++round) {
+            for (const auto &component : components) {
+                scripting::ActorInvoke(ActorName, [&] {
+                    onUpdate(component, Dt);
+                });
+            }
+        }
+    });
+    auto perCall = timePerCall(calls, [&] {
+        for (unsigned int round = 0; round < config.rounds; ++round) {
+            for (const auto &component : components) {
+                scripting::ProtectedCall call{L};
+                call.callMethod(onUpdate, component, Dt, ActorName);
+            }
+        }
+    });
+    auto batched = timePerCall(calls, [&] {
+        for (unsigned int round = 0; round < config.rounds; ++round) {
+            scripting::ProtectedCall call{L};
+            for (const auto &component : components) {
+                call.callMethod(onUpdate, component, Dt, ActorName);
+            }
+        }
+    });
+
+    writer.StartObject();
+    writer.Key("luabridge_ns");
+    writer.Double(luaBridge);
+    writer.Key("protected_call_ns");
+    writer.Double(perCall);
+    writer.Key("batched_protected_call_ns");
+    writer.Double(batched);
+    writer.Key("speedup");
+    writer.Double(luaBridge / batched);
+    writer.EndObject();
+}
+
+} // namespace
+
+void RunLuaCallBench(JsonWriter &writer, const LuaCallBenchConfig &config) {
+    auto* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    writer.StartObject();
+    writer.Key("components");
+    writer.Uint(config.components);
+    writer.Key("rounds");
+    writer.Uint(config.rounds);
+
+    writer.Key("workloads");
+    writer.StartObject();
+    writer.Key("empty_update");
+    benchFunction(writer, L, EmptyUpdate, config);
+    writer.Key("move_update");
+    benchFunction(writer, L, MoveUpdate, config);
+    writer.EndObject();
+
+    writer.EndObject();
+
+    lua_close(L);
+}
+
+} // namespace sge::bench
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+namespace sge::bench {
+
+/**
+ * @brief Shape of the Lua call micro-benchmark.
+ */
+struct LuaCallBenchConfig {
+    // Number of component tables, each with its own OnUpdate call per round
+    unsigned int components{1000};
+    // Number of times every component is updated
+    unsigned int rounds{1000};
+};
+
+/**
+ * @brief Time calling a Lua OnUpdate(self, dt) the way LuaComponent used to
+ * (LuaRef::operator() inside ActorInvoke), with a ProtectedCall per call, and
+ * with one ProtectedCall shared by every call of a frame as the scene does,
+ * and write the results as a JSON object value.
+ *
+ * @param writer Writer to write the report object to.
+ * @param config Workload sizes.
+ */
+void RunLuaCallBench(rapidjson::PrettyWriter<rapidjson::StringBuffer> &writer,
+                     const LuaCallBenchConfig &config);
+
+} // namespace sge::bench
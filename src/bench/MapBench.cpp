@@ -0,0 +1,300 @@
+#include "bench/MapBench.hpp"
+
+#include <dnsge/ConcurrentHashMap.hpp>
+#include <dnsge/HashMap.hpp>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "Types.hpp"
+#include "util/HeterogeneousLookup.hpp"
+#include "util/Symbol.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <latch>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sge::bench {
+
+namespace {
+
+using JsonWriter = rapidjson::PrettyWriter<rapidjson::StringBuffer>;
+
+// Lookup results are folded into this so the lookups can't be optimized out
+volatile std::uintptr_t Sink = 0;
+
+// Fixed, so that runs are comparable
+constexpr std::uint32_t Seed = 0x5ca1ab1e;
+
+/**
+ * @brief Time a workload, in nanoseconds per operation.
+ */
+template <typename F>
+double timePerOperation(unsigned int operations, F &&workload) {
+    auto start = std::chrono::steady_clock::now();
+    workload();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           static_cast<double>(operations);
+}
+
+/**
+ * @brief Look up existing keys in random order, like Actor.Find by id or
+ * resolving a replicated actor.
+ */
+template <typename Map, typename Key, typename Probe>
+double findHits(const std::vector<Key> &keys, const std::vector<Probe> &probes) {
+    Map map;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        map.insert({keys[i], i});
+    }
+    return timePerOperation(static_cast<unsigned int>(probes.size()), [&] {
+        std::uintptr_t sum = 0;
+        for (const auto &probe : probes) {
+            auto it = map.find(probe);
+            if (it != map.end()) {
+                sum += it->second;
+            }
+        }
+        Sink = Sink + sum;
+    });
+}
+
+/**
+ * @brief Look up keys that aren't present.
+ */
+template <typename Map, typename Key, typename Probe>
+double findMisses(const std::vector<Key> &keys, const std::vector<Probe> &probes) {
+    Map map;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        map.insert({keys[i], i});
+    }
+    return timePerOperation(static_cast<unsigned int>(probes.size()), [&] {
+        std::uintptr_t misses = 0;
+        for (const auto &probe : probes) {
+            misses += map.find(probe) == map.end() ? 1 : 0;
+        }
+        Sink = Sink + misses;
+    });
+}
+
+/**
+ * @brief Destroy the oldest actor and instantiate a new one, the way spawning
+ * scenes churn Scene's actor id map.
+ */
+template <typename Map>
+double idChurn(unsigned int keys, unsigned int operations) {
+    Map map;
+    for (actor_id_t id = 0; id < keys; ++id) {
+        map.insert({id, id});
+    }
+    return timePerOperation(operations, [&] {
+        for (actor_id_t oldest = 0; oldest < operations; ++oldest) {
+            map.erase(oldest);
+            map.insert({oldest + keys, oldest});
+        }
+        Sink = Sink + map.size();
+    });
+}
+
+/**
+ * @brief A std::unordered_map behind one shared mutex, with the interface of
+ * dnsge::ConcurrentHashMap.
+ */
+class SharedMutexMap {
+public:
+    bool insert(actor_id_t key, std::size_t value) {
+        std::unique_lock lock(this->mu_);
+        return this->map_.insert({key, value}).second;
+    }
+
+    bool erase(actor_id_t key) {
+        std::unique_lock lock(this->mu_);
+        return this->map_.erase(key) != 0;
+    }
+
+    template <typename F>
+    bool visit(actor_id_t key, F &&f) const {
+        std::shared_lock lock(this->mu_);
+        auto it = this->map_.find(key);
+        if (it == this->map_.end()) {
+            return false;
+        }
+        f(it->second);
+        return true;
+    }
+
+private:
+    mutable std::shared_mutex mu_;
+    std::unordered_map<actor_id_t, std::size_t> map_;
+};
+
+/**
+ * @brief Run threads that each read keys of a shared map, replacing some of
+ * them, and return the total operations per second.
+ */
+template <typename Map>
+double sharedMapThroughput(const MapBenchConfig &config, unsigned int threads) {
+    Map map;
+    for (actor_id_t id = 0; id < config.keys; ++id) {
+        map.insert(id, id);
+    }
+
+    // Release all threads at once, so they contend for the whole run
+    std::latch ready{threads + 1};
+    std::vector<std::jthread> workers;
+    workers.reserve(threads);
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng{Seed + t};
+            std::uniform_int_distribution<unsigned int> pick{0, config.keys - 1};
+            std::uniform_int_distribution<unsigned int> percent{0, 99};
+            std::uintptr_t sum = 0;
+            ready.arrive_and_wait();
+            for (unsigned int i = 0; i < config.operations; ++i) {
+                actor_id_t key = pick(rng);
+                if (percent(rng) < config.writePercent) {
+                    // A client disconnecting and another connecting
+                    map.erase(key);
+                    map.insert(key, i);
+                } else {
+                    map.visit(key, [&sum](std::size_t value) {
+                        sum += value;
+                    });
+                }
+            }
+            Sink = Sink + sum;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ready.arrive_and_wait();
+    workers.clear();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    auto operations = static_cast<double>(config.operations) * threads;
+    return operations / std::chrono::duration<double>(elapsed).count();
+}
+
+void writeWorkload(JsonWriter &writer, const char* name, double stdNs, double hashMapNs) {
+    writer.Key(name);
+    writer.StartObject();
+    writer.Key("std_unordered_map_ns");
+    writer.Double(stdNs);
+    writer.Key("dnsge_hash_map_ns");
+    writer.Double(hashMapNs);
+    writer.Key("speedup");
+    writer.Double(stdNs / hashMapNs);
+    writer.EndObject();
+}
+
+} // namespace
+
+void RunMapBench(JsonWriter &writer, const MapBenchConfig &config) {
+    std::mt19937 rng{Seed};
+    std::uniform_int_distribution<unsigned int> pick{0, config.keys - 1};
+
+    // Actor ids are handed out sequentially
+    std::vector<actor_id_t> ids(config.keys);
+    std::vector<actor_id_t> idProbes(config.operations);
+    std::vector<actor_id_t> idMissProbes(config.operations);
+    for (unsigned int i = 0; i < config.keys; ++i) {
+        ids[i] = i;
+    }
+    for (unsigned int i = 0; i < config.operations; ++i) {
+        idProbes[i] = ids[pick(rng)];
+        idMissProbes[i] = config.keys + pick(rng);
+    }
+
+    // Resource names, looked up by string_view
+    std::vector<std::string> names(config.keys);
+    std::vector<std::string_view> nameProbes(config.operations);
+    for (unsigned int i = 0; i < config.keys; ++i) {
+        names[i] = "resource_" + std::to_string(i);
+    }
+    for (unsigned int i = 0; i < config.operations; ++i) {
+        nameProbes[i] = names[pick(rng)];
+    }
+
+    // Component types and template names
+    std::vector<util::Symbol> symbols(config.keys);
+    std::vector<util::Symbol> symbolProbes(config.operations);
+    for (unsigned int i = 0; i < config.keys; ++i) {
+        symbols[i] = util::Intern("BenchSymbol" + std::to_string(i));
+    }
+    for (unsigned int i = 0; i < config.operations; ++i) {
+        symbolProbes[i] = symbols[pick(rng)];
+    }
+
+    using StdIdMap = std::unordered_map<actor_id_t, std::size_t>;
+    using IdMap = dnsge::HashMap<actor_id_t, std::size_t>;
+    using StdStringMap = unordered_string_map<std::size_t>;
+    using StringMap = flat_string_map<std::size_t>;
+    using StdSymbolMap = std::unordered_map<util::Symbol, std::size_t>;
+    using SymbolMap = dnsge::HashMap<util::Symbol, std::size_t>;
+
+    writer.StartObject();
+    writer.Key("keys");
+    writer.Uint(config.keys);
+    writer.Key("operations");
+    writer.Uint(config.operations);
+
+    writer.Key("workloads");
+    writer.StartObject();
+    writeWorkload(writer, "actor_id_find", findHits<StdIdMap>(ids, idProbes),
+                  findHits<IdMap>(ids, idProbes));
+    writeWorkload(writer, "actor_id_miss", findMisses<StdIdMap>(ids, idMissProbes),
+                  findMisses<IdMap>(ids, idMissProbes));
+    writeWorkload(writer, "actor_id_churn", idChurn<StdIdMap>(config.keys, config.operations),
+                  idChurn<IdMap>(config.keys, config.operations));
+    writeWorkload(writer, "string_view_find", findHits<StdStringMap>(names, nameProbes),
+                  findHits<StringMap>(names, nameProbes));
+    writeWorkload(writer, "symbol_find", findHits<StdSymbolMap>(symbols, symbolProbes),
+                  findHits<SymbolMap>(symbols, symbolProbes));
+    writer.EndObject();
+
+    writer.EndObject();
+}
+
+void RunConcurrentMapBench(JsonWriter &writer, const MapBenchConfig &config) {
+    using ShardedMap = dnsge::ConcurrentHashMap<actor_id_t, std::size_t>;
+
+    writer.StartObject();
+    writer.Key("keys");
+    writer.Uint(config.keys);
+    writer.Key("operations_per_thread");
+    writer.Uint(config.operations);
+    writer.Key("write_percent");
+    writer.Uint(config.writePercent);
+
+    writer.Key("runs");
+    writer.StartArray();
+    for (unsigned int threads = 1; threads <= config.threads; threads *= 2) {
+        auto sharedMutex = sharedMapThroughput<SharedMutexMap>(config, threads);
+        auto sharded = sharedMapThroughput<ShardedMap>(config, threads);
+
+        writer.StartObject();
+        writer.Key("threads");
+        writer.Uint(threads);
+        writer.Key("shared_mutex_ops_per_second");
+        writer.Double(sharedMutex);
+        writer.Key("sharded_ops_per_second");
+        writer.Double(sharded);
+        writer.Key("speedup");
+        writer.Double(sharded / sharedMutex);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+}
+
+} // namespace sge::bench
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+namespace sge::bench {
+
+/**
+ * @brief Shape of the hash map micro-benchmark.
+ */
+struct MapBenchConfig {
+    // Number of keys in each map
+    unsigned int keys{1000};
+    // Number of timed operations per workload, and per thread for concurrent
+    // workloads
+    unsigned int operations{1000000};
+    // Largest thread count of the concurrent workloads, which run with 1, 2,
+    // 4, ... threads up to it
+    unsigned int threads{4};
+    // Percentage of concurrent operations that replace a key instead of reading it
+    unsigned int writePercent{5};
+};
+
+/**
+ * @brief Time the key shapes the engine looks up every tick (actor ids, resource
+ * names and symbols) in std::unordered_map and dnsge::HashMap, and write the
+ * results as a JSON object value.
+ *
+ * @param writer Writer to write the report object to.
+ * @param config Workload sizes.
+ */
+void RunMapBench(rapidjson::PrettyWriter<rapidjson::StringBuffer> &writer,
+                 const MapBenchConfig &config);
+
+/**
+ * @brief Time threads reading and replacing keys of one shared map, guarded
+ * either by a single shared mutex (the way Host used to guard its connections)
+ * or by dnsge::ConcurrentHashMap's shards, and write the results as a JSON
+ * object value.
+ *
+ * @param writer Writer to write the report object to.
+ * @param config Workload sizes.
+ */
+void RunConcurrentMapBench(rapidjson::PrettyWriter<rapidjson::StringBuffer> &writer,
+                           const MapBenchConfig &config);
+
+} // namespace sge::bench
@@ -0,0 +1,367 @@
+#include "bench/Scenario.hpp"
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "resources/Resources.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace sge::bench {
+
+namespace {
+
+using JsonWriter = rapidjson::PrettyWriter<rapidjson::StringBuffer>;
+
+// Moves a transform at a constant velocity, like ConstantVelocity in the
+// laser-battle example.
+constexpr std::string_view BenchVelocitySource = R"lua(
+BenchVelocity = {
+    vel_x = 1,
+    vel_y = 1,
+    transform_component = "transform"
+}
+
+function BenchVelocity:OnStart()
+    self.t = self.actor:GetComponentByKey(self.transform_component)
+end
+
+function BenchVelocity:OnUpdate(dt)
+    self.t.x = self.t.x + self.vel_x * dt
+    self.t.y = self.t.y + self.vel_y * dt
+end
+)lua";
+
+// Keeps a transform inside a fixed area from OnLateUpdate.
+constexpr std::string_view BenchWrapSource = R"lua(
+BenchWrap = {
+    extent = 100,
+    transform_component = "transform"
+}
+
+function BenchWrap:OnStart()
+    self.t = self.actor:GetComponentByKey(self.transform_component)
+end
+
+function BenchWrap:OnLateUpdate(dt)
+    if self.t.x > self.extent then
+        self.t.x = -self.extent
+    end
+    if self.t.y > self.extent then
+        self.t.y = -self.extent
+    end
+end
+)lua";
+
+// Adds a component from OnStart, while the actor's other components are still
+// being started, and checks on its first update that the added component was
+// started too.
+constexpr std::string_view BenchAttacherSource = R"lua(
+BenchAttacher = {}
+
+function BenchAttacher:OnStart()
+    self.added = self.actor:AddComponent("BenchVelocity")
+    if self.actor:GetComponentByKey(self.added.key) == nil then
+        error("component added from OnStart can't be looked up")
+    end
+end
+
+function BenchAttacher:OnUpdate(dt)
+    if self.added ~= nil then
+        if self.added.t == nil then
+            error("component added from OnStart was not started")
+        end
+        self.added = nil
+    end
+end
+)lua";
+
+// Checks from OnLateUpdate that the transform moved by exactly its velocity
+// components since the last tick, so that native Velocity components updated
+// in parallel are caught if they lose or repeat a write. Keyed to run after
+// BenchWrap, and skips the ticks on which BenchWrap moved the transform back.
+constexpr std::string_view BenchVelocityCheckSource = R"lua(
+BenchVelocityCheck = {
+    transform_component = "transform"
+}
+
+function BenchVelocityCheck:OnStart()
+    self.t = self.actor:GetComponentByKey(self.transform_component)
+    self.x = self.t.x
+end
+
+function BenchVelocityCheck:OnLateUpdate(dt)
+    local vel_x = 0
+    for _, velocity in ipairs(self.actor:GetComponents("Velocity")) do
+        vel_x = vel_x + velocity.vel_x
+    end
+    for _, velocity in ipairs(self.actor:GetComponents("BenchVelocity")) do
+        vel_x = vel_x + velocity.vel_x
+    end
+
+    local x = self.t.x
+    if x >= self.x and math.abs(x - (self.x + vel_x * dt)) > 1e-3 then
+        error("transform moved by " .. (x - self.x) .. " instead of " .. (vel_x * dt))
+    end
+    self.x = x
+end
+)lua";
+
+// Destroys the actors spawned on the previous tick and spawns new ones. With
+// alt_template set, every other actor is spawned from that template instead,
+// and each actor is checked to have its own template's BenchVelocity
+// components, so that a pool handing out another template's components is
+// caught.
+constexpr std::string_view BenchSpawnerSource = R"lua(
+BenchSpawner = {
+    template = "BenchTransient",
+    velocities = 1,
+    alt_template = "",
+    alt_velocities = 0,
+    count = 0
+}
+
+function BenchSpawner:OnStart()
+    self.spawned = {}
+end
+
+function BenchSpawner:OnUpdate(dt)
+    for _, actor in ipairs(self.spawned) do
+        Actor.Destroy(actor)
+    end
+    self.spawned = {}
+    for i = 1, self.count do
+        local template, velocities = self.template, self.velocities
+        if self.alt_template ~= "" and i % 2 == 0 then
+            template, velocities = self.alt_template, self.alt_velocities
+        end
+        local actor = Actor.Instantiate(template)
+        if #actor:GetComponents("BenchVelocity") ~= velocities then
+            error("actor of " .. template .. " has another template's components")
+        end
+        self.spawned[i] = actor
+    end
+end
+)lua";
+
+void writeFile(const std::filesystem::path &path, std::string_view contents) {
+    std::ofstream file{path, std::ios::trunc};
+    if (!file) {
+        std::cerr << "error: failed to write " << path.string() << std::endl;
+        std::exit(1);
+    }
+    file << contents;
+}
+
+void writeJsonFile(const std::filesystem::path &path, const std::function<void(JsonWriter &)> &f) {
+    rapidjson::StringBuffer buffer;
+    JsonWriter writer{buffer};
+    f(writer);
+    writeFile(path, std::string_view{buffer.GetString(), buffer.GetSize()});
+}
+
+void writeComponent(JsonWriter &writer, const char* key, const char* type) {
+    writer.Key(key);
+    writer.StartObject();
+    writer.Key("type");
+    writer.String(type);
+    writer.Key("realm");
+    writer.String("server");
+}
+
+void writeMovingTemplate(JsonWriter &writer, const std::string &name, unsigned int luaComponents,
+                         bool nativeVelocity, bool lateUpdate, bool runtimeComponents,
+                         bool pooled, float speed) {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String(name.c_str());
+    writer.Key("pooled");
+    writer.Bool(pooled);
+    writer.Key("components");
+    writer.StartObject();
+
+    // Keyed to start before the transform, so that the component is added
+    // while the rest are still being started
+    if (runtimeComponents) {
+        writeComponent(writer, "attacher", "BenchAttacher");
+        writer.EndObject();
+    }
+
+    writeComponent(writer, "transform", "Transform");
+    writer.EndObject();
+
+    for (unsigned int i = 0; i < luaComponents; ++i) {
+        auto key = "velocity" + std::to_string(i);
+        writeComponent(writer, key.c_str(), nativeVelocity ? "Velocity" : "BenchVelocity");
+        writer.Key("vel_x");
+        writer.Double(speed);
+        writer.Key("vel_y");
+        writer.Double(speed * 0.5);
+        writer.EndObject();
+    }
+
+    if (lateUpdate) {
+        writeComponent(writer, "wrap", "BenchWrap");
+        writer.EndObject();
+    }
+
+    if (nativeVelocity) {
+        writeComponent(writer, "zcheck", "BenchVelocityCheck");
+        writer.EndObject();
+    }
+
+    writer.EndObject();
+    writer.EndObject();
+}
+
+void writeBodyTemplate(JsonWriter &writer) {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String("BenchBody");
+    writer.Key("components");
+    writer.StartObject();
+
+    writeComponent(writer, "body", "Rigidbody");
+    writer.Key("body_type");
+    writer.String("dynamic");
+    writer.Key("gravity_scale");
+    writer.Double(0.0);
+    writer.EndObject();
+
+    writer.EndObject();
+    writer.EndObject();
+}
+
+std::string movingTemplateName(unsigned int i) {
+    return "BenchActor" + std::to_string(i);
+}
+
+} // namespace
+
+void WriteScenario(const std::filesystem::path &root, const ScenarioConfig &config) {
+    auto resourcesPath = root / resources::ResourcesDirectoryPath;
+    auto componentTypesPath = root / resources::ComponentTypesPath;
+    auto actorTemplatesPath = root / resources::ActorTemplatesDirectoryPath;
+    auto scenesPath = root / resources::ScenesDirectoryPath;
+
+    // Start from an empty resources directory so stale files from a previous
+    // scenario are never picked up.
+    std::filesystem::remove_all(resourcesPath);
+    std::filesystem::create_directories(componentTypesPath);
+    std::filesystem::create_directories(actorTemplatesPath);
+    std::filesystem::create_directories(scenesPath);
+
+    // Component types
+    writeFile(componentTypesPath / "BenchVelocity.lua", BenchVelocitySource);
+    writeFile(componentTypesPath / "BenchWrap.lua", BenchWrapSource);
+    writeFile(componentTypesPath / "BenchAttacher.lua", BenchAttacherSource);
+    writeFile(componentTypesPath / "BenchSpawner.lua", BenchSpawnerSource);
+    writeFile(componentTypesPath / "BenchVelocityCheck.lua", BenchVelocityCheckSource);
+
+    // Actor templates. Each moving template gets a slightly different speed so
+    // that templates are distinguishable.
+    for (unsigned int i = 0; i < config.templates; ++i) {
+        auto name = movingTemplateName(i);
+        writeJsonFile(actorTemplatesPath / (name + ".template"), [&](JsonWriter &writer) {
+            writeMovingTemplate(writer,
+                                name,
+                                config.luaComponents,
+                                config.nativeVelocity,
+                                config.lateUpdate,
+                                config.runtimeComponents,
+                                false,
+                                1.0F + static_cast<float>(i) * 0.1F);
+        });
+    }
+    writeJsonFile(actorTemplatesPath / "BenchTransient.template", [&](JsonWriter &writer) {
+        writeMovingTemplate(writer,
+                            "BenchTransient",
+                            1,
+                            false,
+                            false,
+                            config.runtimeComponents,
+                            config.pooledSpawns,
+                            1.0F);
+    });
+    if (config.pooledSpawns) {
+        // Pooled like BenchTransient and shown under the same name, but with
+        // different components
+        writeJsonFile(actorTemplatesPath / "BenchTransientWide.template", [&](JsonWriter &writer) {
+            writeMovingTemplate(writer,
+                                "BenchTransient",
+                                2,
+                                false,
+                                false,
+                                config.runtimeComponents,
+                                true,
+                                1.0F);
+        });
+    }
+    writeJsonFile(actorTemplatesPath / "BenchBody.template", writeBodyTemplate);
+
+    // Scene
+    auto sceneFile = std::string{ScenarioSceneName} + ".scene";
+    writeJsonFile(scenesPath / sceneFile, [&](JsonWriter &writer) {
+        writer.StartObject();
+        writer.Key("actors");
+        writer.StartArray();
+
+        for (unsigned int i = 0; i < config.actors; ++i) {
+            writer.StartObject();
+            writer.Key("template");
+            writer.String(movingTemplateName(i % config.templates).c_str());
+            writer.EndObject();
+        }
+
+        // Lay out bodies on a grid so that they don't all start overlapping
+        constexpr unsigned int bodiesPerRow = 100;
+        constexpr double bodySpacing = 2.0;
+        for (unsigned int i = 0; i < config.physicsActors; ++i) {
+            writer.StartObject();
+            writer.Key("template");
+            writer.String("BenchBody");
+            writer.Key("components");
+            writer.StartObject();
+            writer.Key("body");
+            writer.StartObject();
+            writer.Key("x");
+            writer.Double(static_cast<double>(i % bodiesPerRow) * bodySpacing);
+            writer.Key("y");
+            writer.Double(static_cast<double>(i / bodiesPerRow) * bodySpacing);
+            writer.EndObject();
+            writer.EndObject();
+            writer.EndObject();
+        }
+
+        if (config.spawnPerTick > 0) {
+            writer.StartObject();
+            writer.Key("name");
+            writer.String("BenchSpawner");
+            writer.Key("components");
+            writer.StartObject();
+            writeComponent(writer, "spawner", "BenchSpawner");
+            writer.Key("count");
+            writer.Uint(config.spawnPerTick);
+            if (config.pooledSpawns) {
+                writer.Key("alt_template");
+                writer.String("BenchTransientWide");
+                writer.Key("alt_velocities");
+                writer.Uint(2);
+            }
+            writer.EndObject();
+            writer.EndObject();
+            writer.EndObject();
+        }
+
+        writer.EndArray();
+        writer.EndObject();
+    });
+}
+
+} // namespace sge::bench
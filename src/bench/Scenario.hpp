@@ -0,0 +1,50 @@
+#pragma once
+
+#include <filesystem>
+
+namespace sge::bench {
+
+/**
+ * @brief Name of the generated scene that a benchmark room loads.
+ */
+constexpr const char* ScenarioSceneName = "bench";
+
+/**
+ * @brief Shape of a synthetic benchmark scene.
+ */
+struct ScenarioConfig {
+    // Number of scene actors, each with a Transform and Lua movement components
+    unsigned int actors{1000};
+    // Number of distinct actor templates the scene actors are spread across
+    unsigned int templates{1};
+    // Number of BenchVelocity Lua components on each scene actor
+    unsigned int luaComponents{1};
+    // Whether those are native Velocity components instead, the first of
+    // which on each actor runs its OnUpdate on the job system. Each actor
+    // then also checks from Lua that it moved by its velocities.
+    bool nativeVelocity{false};
+    // Whether each scene actor also has a Lua component with OnLateUpdate
+    bool lateUpdate{false};
+    // Whether each scene and spawned actor has a Lua component that adds a
+    // BenchVelocity component to the actor from OnStart
+    bool runtimeComponents{false};
+    // Number of additional actors with a dynamic Rigidbody
+    unsigned int physicsActors{0};
+    // Number of actors instantiated (and destroyed a tick later) every tick
+    unsigned int spawnPerTick{0};
+    // Whether the spawned actors' template is pooled. Every other actor is then
+    // spawned from a second pooled template with the same display name but
+    // different components, checking that the pools are kept apart.
+    bool pooledSpawns{false};
+};
+
+/**
+ * @brief Write a self-contained resources directory (component types, actor
+ * templates and the benchmark scene) for a scenario.
+ *
+ * @param root Directory to create the resources/ directory in.
+ * @param config Scenario to generate.
+ */
+void WriteScenario(const std::filesystem::path &root, const ScenarioConfig &config);
+
+} // namespace sge::bench
@@ -0,0 +1,112 @@
+#include "bench/TickSchedulerCheck.hpp"
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "util/TickScheduler.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace sge::bench {
+
+namespace {
+
+using JsonWriter = rapidjson::PrettyWriter<rapidjson::StringBuffer>;
+using util::TickOverrunPolicy;
+using util::TickScheduler;
+
+constexpr unsigned int TickRate = 60;
+
+struct OverrunCase {
+    const char* name;
+    TickOverrunPolicy policy;
+    // How many periods past its deadline the overrunning tick finishes
+    std::uint64_t overrunPeriods;
+    // Ticks expected to start late, counting the one right after the overrun,
+    // and ticks expected to be dropped
+    std::uint64_t lateTicks;
+    std::uint64_t skippedTicks;
+};
+
+constexpr OverrunCase Cases[] = {
+    {"catch_up_within_limit", TickOverrunPolicy::CatchUp, 3, 4, 0},
+    {"catch_up_past_limit", TickOverrunPolicy::CatchUp, 20, util::MaxCatchUpTicks + 1,
+     20 - util::MaxCatchUpTicks},
+    {"skip", TickOverrunPolicy::Skip, 20, 1, 20},
+};
+
+/**
+ * @brief Run ticks that each take half a period until one overruns, then keep
+ * asking for the next tick at the time the overrun ended until one is on time
+ * again.
+ */
+bool checkOverrun(JsonWriter &writer, const OverrunCase &overrun) {
+    TickScheduler scheduler{TickRate, overrun.policy, std::chrono::microseconds{0}};
+    scheduler.start();
+    const auto period = scheduler.period();
+
+    // A few ticks on schedule
+    bool onSchedule = true;
+    for (int i = 0; i < 3; ++i) {
+        auto now = scheduler.nextDeadline() - period / 2;
+        onSchedule = onSchedule && !scheduler.advance(now);
+    }
+
+    // A tick that finishes overrunPeriods and a half past the next deadline,
+    // then ticks that take no time until the schedule is back on time
+    auto overrunEnd = scheduler.nextDeadline() + period * overrun.overrunPeriods + period / 2;
+    std::uint64_t lateTicks = 0;
+    while (scheduler.advance(overrunEnd)) {
+        ++lateTicks;
+    }
+    // The tick after the late ones is due in the future
+    bool backOnSchedule = scheduler.nextDeadline() - period > overrunEnd;
+
+    const auto &stats = scheduler.stats();
+    bool passed = onSchedule && backOnSchedule && lateTicks == overrun.lateTicks &&
+                  stats.lateTicks == overrun.lateTicks &&
+                  stats.skippedTicks == overrun.skippedTicks;
+
+    writer.Key(overrun.name);
+    writer.StartObject();
+    writer.Key("overrun_periods");
+    writer.Uint64(overrun.overrunPeriods);
+    writer.Key("late_ticks");
+    writer.Uint64(stats.lateTicks);
+    writer.Key("expected_late_ticks");
+    writer.Uint64(overrun.lateTicks);
+    writer.Key("skipped_ticks");
+    writer.Uint64(stats.skippedTicks);
+    writer.Key("expected_skipped_ticks");
+    writer.Uint64(overrun.skippedTicks);
+    writer.Key("passed");
+    writer.Bool(passed);
+    writer.EndObject();
+    return passed;
+}
+
+} // namespace
+
+bool RunTickSchedulerCheck(JsonWriter &writer) {
+    bool passed = true;
+    writer.StartObject();
+    writer.Key("tick_rate");
+    writer.Uint(TickRate);
+    writer.Key("max_catch_up_ticks");
+    writer.Uint64(util::MaxCatchUpTicks);
+
+    writer.Key("cases");
+    writer.StartObject();
+    for (const auto &overrun : Cases) {
+        passed = checkOverrun(writer, overrun) && passed;
+    }
+    writer.EndObject();
+
+    writer.Key("passed");
+    writer.Bool(passed);
+    writer.EndObject();
+    return passed;
+}
+
+} // namespace sge::bench
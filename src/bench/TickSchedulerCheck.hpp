@@ -0,0 +1,18 @@
+#pragma once
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+namespace sge::bench {
+
+/**
+ * @brief Drive a TickScheduler behind schedule with made-up times, under each
+ * overrun policy, and check how many ticks it runs late and drops. Writes the
+ * results as a JSON object value.
+ *
+ * @param writer Writer to write the report object to.
+ * @return Whether every case behaved as expected.
+ */
+bool RunTickSchedulerCheck(rapidjson::PrettyWriter<rapidjson::StringBuffer> &writer);
+
+} // namespace sge::bench
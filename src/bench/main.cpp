@@ -0,0 +1,454 @@
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include "bench/LuaCallBench.hpp"
+#include "bench/MapBench.hpp"
+#include "bench/Scenario.hpp"
+#include "bench/TickSchedulerCheck.hpp"
+#include "game/Game.hpp"
+#include "resources/Configs.hpp"
+#include "scripting/Libs.hpp"
+#include "server/Room.hpp"
+#include "server/ServerInterface.hpp"
+#include "util/Arena.hpp"
+#include "util/Trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Every heap allocation made by the process, counted by the replacement
+// operator new below
+std::atomic<std::uint64_t> HeapAllocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+using namespace sge;
+using std::chrono::nanoseconds;
+using JsonWriter = rapidjson::PrettyWriter<rapidjson::StringBuffer>;
+
+struct BenchOptions {
+    bench::ScenarioConfig scenario{};
+    unsigned int ticks{600};
+    unsigned int warmupTicks{60};
+    std::filesystem::path workdir{std::filesystem::temp_directory_path() / "sge-bench"};
+    std::optional<std::filesystem::path> output{};
+    std::optional<std::filesystem::path> trace{};
+    // Run a hash map micro-benchmark instead of a scene
+    bool maps{false};
+    bool concurrentMaps{false};
+    bench::MapBenchConfig mapConfig{};
+    // Run a Lua call micro-benchmark instead of a scene
+    bool luaCalls{false};
+    bench::LuaCallBenchConfig luaCallConfig{};
+    // Check how the tick scheduler handles overruns instead of running a scene
+    bool tickScheduler{false};
+};
+
+/**
+ * @brief Samples of one phase of the tick, one per measured tick.
+ */
+struct PhaseSamples {
+    const char* name;
+    std::vector<nanoseconds> samples{};
+};
+
+void printUsage() {
+    std::cerr << "usage: sge-bench [options]\n"
+              << "  --actors=N          scene actors with Lua movement (default 1000)\n"
+              << "  --templates=N       distinct templates for scene actors (default 1)\n"
+              << "  --lua-components=N  BenchVelocity components per actor (default 1)\n"
+              << "  --native-velocity   move actors with native Velocity components instead\n"
+              << "  --late-update       add a Lua OnLateUpdate component to each actor\n"
+              << "  --runtime-components  add a component to each actor from Lua OnStart\n"
+              << "  --physics-actors=N  additional actors with a dynamic Rigidbody (default 0)\n"
+              << "  --spawn=N           actors instantiated and destroyed per tick (default 0)\n"
+              << "  --pooled-spawns     pool the template of the spawned actors\n"
+              << "  --ticks=N           measured ticks (default 600)\n"
+              << "  --warmup=N          unmeasured ticks before measuring (default 60)\n"
+              << "  --workdir=PATH      where to generate the scenario resources\n"
+              << "  --output=PATH       write the JSON report to PATH instead of stdout\n"
+              << "  --trace=PATH        write a Chrome trace of the measured ticks to PATH\n"
+              << "  --maps              benchmark hash maps instead of running a scene\n"
+              << "  --map-keys=N        keys in each map for --maps (default 1000)\n"
+              << "  --map-ops=N         operations per map workload for --maps (default 1000000)\n"
+              << "  --concurrent-maps   benchmark shared maps under thread contention\n"
+              << "  --map-threads=N     most threads for --concurrent-maps (default 4)\n"
+              << "  --map-write-pct=N   percent of writes for --concurrent-maps (default 5)\n"
+              << "  --lua-calls         benchmark the overhead of calling Lua OnUpdate\n"
+              << "  --lua-call-components=N  component tables for --lua-calls (default 1000)\n"
+              << "  --lua-call-rounds=N updates of each table for --lua-calls (default 1000)\n"
+              << "  --tick-scheduler    check the tick scheduler's overrun handling\n";
+}
+
+unsigned int parseUnsigned(std::string_view option, std::string_view value) {
+    unsigned int result = 0;
+    const auto* end = value.data() + value.size();
+    auto [ptr, ec] = std::from_chars(value.data(), end, result);
+    if (ec != std::errc{} || ptr != end) {
+        std::cerr << "error: invalid value for " << option << ": " << value << std::endl;
+        std::exit(1);
+    }
+    return result;
+}
+
+BenchOptions parseOptions(int argc, char** argv) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        auto eq = arg.find('=');
+        auto option = arg.substr(0, eq);
+        auto value = eq == std::string_view::npos ? std::string_view{} : arg.substr(eq + 1);
+
+        if (option == "--actors") {
+            options.scenario.actors = parseUnsigned(option, value);
+        } else if (option == "--templates") {
+            options.scenario.templates = std::max(1U, parseUnsigned(option, value));
+        } else if (option == "--lua-components") {
+            options.scenario.luaComponents = parseUnsigned(option, value);
+        } else if (option == "--native-velocity") {
+            options.scenario.nativeVelocity = true;
+        } else if (option == "--late-update") {
+            options.scenario.lateUpdate = true;
+        } else if (option == "--runtime-components") {
+            options.scenario.runtimeComponents = true;
+        } else if (option == "--physics-actors") {
+            options.scenario.physicsActors = parseUnsigned(option, value);
+        } else if (option == "--spawn") {
+            options.scenario.spawnPerTick = parseUnsigned(option, value);
+        } else if (option == "--pooled-spawns") {
+            options.scenario.pooledSpawns = true;
+        } else if (option == "--ticks") {
+            options.ticks = std::max(1U, parseUnsigned(option, value));
+        } else if (option == "--warmup") {
+            options.warmupTicks = parseUnsigned(option, value);
+        } else if (option == "--workdir") {
+            options.workdir = value;
+        } else if (option == "--output") {
+            options.output = std::filesystem::absolute(value);
+        } else if (option == "--trace") {
+            options.trace = std::filesystem::absolute(value);
+        } else if (option == "--maps") {
+            options.maps = true;
+        } else if (option == "--map-keys") {
+            options.mapConfig.keys = std::max(1U, parseUnsigned(option, value));
+        } else if (option == "--map-ops") {
+            options.mapConfig.operations = std::max(1U, parseUnsigned(option, value));
+        } else if (option == "--concurrent-maps") {
+            options.concurrentMaps = true;
+        } else if (option == "--map-threads") {
+            options.mapConfig.threads = std::max(1U, parseUnsigned(option, value));
+        } else if (option == "--map-write-pct") {
+            options.mapConfig.writePercent = std::min(100U, parseUnsigned(option, value));
+        } else if (option == "--lua-calls") {
+            options.luaCalls = true;
+        } else if (option == "--lua-call-components") {
+            options.luaCallConfig.components = std::max(1U, parseUnsigned(option, value));
+        } else if (option == "--lua-call-rounds") {
+            options.luaCallConfig.rounds = std::max(1U, parseUnsigned(option, value));
+        } else if (option == "--tick-scheduler") {
+            options.tickScheduler = true;
+        } else {
+            printUsage();
+            std::exit(option == "--help" ? 0 : 1);
+        }
+    }
+    return options;
+}
+
+double toMicroseconds(nanoseconds ns) {
+    return static_cast<double>(ns.count()) / 1000.0;
+}
+
+void writePhase(JsonWriter &writer, PhaseSamples &phase) {
+    auto &samples = phase.samples;
+    std::sort(samples.begin(), samples.end());
+
+    nanoseconds total{};
+    for (auto sample : samples) {
+        total += sample;
+    }
+    auto percentile = [&samples](double p) {
+        auto index = static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1));
+        return toMicroseconds(samples[index]);
+    };
+
+    writer.Key(phase.name);
+    writer.StartObject();
+    writer.Key("total_ms");
+    writer.Double(toMicroseconds(total) / 1000.0);
+    writer.Key("mean_us");
+    writer.Double(toMicroseconds(total) / static_cast<double>(samples.size()));
+    writer.Key("p50_us");
+    writer.Double(percentile(0.50));
+    writer.Key("p95_us");
+    writer.Double(percentile(0.95));
+    writer.Key("p99_us");
+    writer.Double(percentile(0.99));
+    writer.Key("max_us");
+    writer.Double(toMicroseconds(samples.back()));
+    writer.EndObject();
+}
+
+void writeReport(const BenchOptions &options, const rapidjson::StringBuffer &buffer) {
+    if (options.output.has_value()) {
+        std::ofstream out{*options.output, std::ios::trunc};
+        out << buffer.GetString() << std::endl;
+    } else {
+        std::cout << buffer.GetString() << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto options = parseOptions(argc, argv);
+
+    if (options.tickScheduler) {
+        rapidjson::StringBuffer buffer;
+        JsonWriter writer{buffer};
+        bool passed = bench::RunTickSchedulerCheck(writer);
+        writeReport(options, buffer);
+        return passed ? 0 : 1;
+    }
+
+    if (options.maps || options.concurrentMaps || options.luaCalls) {
+        rapidjson::StringBuffer buffer;
+        JsonWriter writer{buffer};
+        if (options.luaCalls) {
+            bench::RunLuaCallBench(writer, options.luaCallConfig);
+        } else if (options.maps) {
+            bench::RunMapBench(writer, options.mapConfig);
+        } else {
+            bench::RunConcurrentMapBench(writer, options.mapConfig);
+        }
+        writeReport(options, buffer);
+        return 0;
+    }
+
+    // Generate the scenario and run from its directory, the same way the server
+    // runs from a game directory.
+    bench::WriteScenario(options.workdir, options.scenario);
+    std::filesystem::current_path(options.workdir);
+
+    resources::ServerConfig serverConfig{
+        .tick_rate = resources::DefaultServerTickRate,
+        .tick_overrun_policy = util::TickOverrunPolicy::Skip,
+        .tick_spin_us = resources::DefaultServerTickSpinUs,
+        .port = resources::DefaultServerPort,
+        .io_workers = 0,
+        .empty_behavior = resources::ServerEmptyBehavior::Run,
+        .tick_threads = 1,
+        .max_rooms = 1,
+        .stats_interval = 0,
+        .lua_gc_mode = scripting::LuaGcMode::Incremental,
+        .lua_gc_budget_us = resources::DefaultServerLuaGcBudgetUs,
+        .lua_gc_emergency_mb = resources::DefaultServerLuaGcEmergencyMb,
+        .lua_profile_slow_tick_ms = 0,
+        .initial_scene = bench::ScenarioSceneName,
+    };
+    resources::GameConfig gameConfig{
+        .physics_rate = resources::DefaultPhysicsRate,
+        .physics_max_substeps = resources::DefaultPhysicsMaxSubsteps,
+    };
+
+    scripting::InitializeInterface(std::make_unique<server::ServerInterface>());
+
+    // The room never has clients, so it doesn't need a network host
+    auto room = std::make_unique<server::Room>("bench", serverConfig, gameConfig, nullptr);
+
+    // Ticks run back-to-back, so advance the game by one server tick per tick
+    // rather than by the wall-clock time between them. Otherwise physics would
+    // barely step.
+    room->game().setFixedFrameTime(
+        std::chrono::microseconds(std::chrono::seconds(1)) / serverConfig.tick_rate);
+
+    const std::chrono::microseconds gcBudget{serverConfig.lua_gc_budget_us};
+    for (unsigned int i = 0; i < options.warmupTicks; ++i) {
+        room->tick();
+        room->collectGarbage(std::chrono::steady_clock::now() + gcBudget);
+    }
+
+    std::vector<PhaseSamples> phases{
+        {"on_start"},
+        {"on_update"},
+        {"on_late_update"},
+        {"pending_subscriptions"},
+        {"insert_instantiated_actors"},
+        {"remove_destroyed_actors"},
+        {"physics_step"},
+        {"room_tick"},
+        {"lua_gc"},
+    };
+    for (auto &phase : phases) {
+        phase.samples.reserve(options.ticks);
+    }
+
+    util::SetTraceThreadName("Bench");
+    if (options.trace.has_value()) {
+        util::StartTracing();
+    }
+
+    std::uint64_t physicsSteps = 0;
+    auto heapAllocationsStart = HeapAllocations.load(std::memory_order_relaxed);
+    auto benchStart = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < options.ticks; ++i) {
+        auto tickStart = std::chrono::steady_clock::now();
+        room->tick();
+        auto tickTime = std::chrono::steady_clock::now() - tickStart;
+
+        // Ticks run back-to-back, so give the collector its full budget as if
+        // the server were idle until the next tick
+        auto gcStart = std::chrono::steady_clock::now();
+        room->collectGarbage(gcStart + gcBudget);
+        auto gcTime = std::chrono::steady_clock::now() - gcStart;
+
+        const auto &timings = room->game().lastUpdateTimings();
+        phases[0].samples.push_back(timings.onStart);
+        phases[1].samples.push_back(timings.onUpdate);
+        phases[2].samples.push_back(timings.onLateUpdate);
+        phases[3].samples.push_back(timings.pendingSubscriptions);
+        phases[4].samples.push_back(timings.insertInstantiatedActors);
+        phases[5].samples.push_back(timings.removeDestroyedActors);
+        phases[6].samples.push_back(timings.physicsStep);
+        phases[7].samples.push_back(tickTime);
+        phases[8].samples.push_back(gcTime);
+        physicsSteps += room->game().lastPhysicsSteps();
+    }
+    auto benchTime = std::chrono::steady_clock::now() - benchStart;
+    auto heapAllocations = HeapAllocations.load(std::memory_order_relaxed) - heapAllocationsStart;
+
+    if (options.trace.has_value()) {
+        util::StopTracing();
+        if (!util::WriteChromeTrace(*options.trace)) {
+            std::cerr << "error: failed to write trace to " << options.trace->string()
+                      << std::endl;
+        }
+    }
+
+    // Build the report
+    const auto &scenario = options.scenario;
+    const auto &stats = room->stats();
+    auto benchSeconds = std::chrono::duration<double>(benchTime).count();
+
+    rapidjson::StringBuffer buffer;
+    JsonWriter writer{buffer};
+    writer.StartObject();
+
+    writer.Key("scenario");
+    writer.StartObject();
+    writer.Key("actors");
+    writer.Uint(scenario.actors);
+    writer.Key("templates");
+    writer.Uint(scenario.templates);
+    writer.Key("lua_components");
+    writer.Uint(scenario.luaComponents);
+    writer.Key("native_velocity");
+    writer.Bool(scenario.nativeVelocity);
+    writer.Key("late_update");
+    writer.Bool(scenario.lateUpdate);
+    writer.Key("runtime_components");
+    writer.Bool(scenario.runtimeComponents);
+    writer.Key("physics_actors");
+    writer.Uint(scenario.physicsActors);
+    writer.Key("spawn_per_tick");
+    writer.Uint(scenario.spawnPerTick);
+    writer.Key("pooled_spawns");
+    writer.Bool(scenario.pooledSpawns);
+    writer.EndObject();
+
+    writer.Key("ticks");
+    writer.Uint(options.ticks);
+    writer.Key("warmup_ticks");
+    writer.Uint(options.warmupTicks);
+    writer.Key("wall_time_ms");
+    writer.Double(benchSeconds * 1000.0);
+    writer.Key("ticks_per_second");
+    writer.Double(static_cast<double>(options.ticks) / benchSeconds);
+    writer.Key("final_actors");
+    writer.Uint64(stats.actors);
+    writer.Key("lua_memory_bytes");
+    writer.Uint64(stats.luaMemoryBytes);
+    writer.Key("lua_gc_emergencies");
+    writer.Uint64(stats.gcEmergencies);
+    writer.Key("physics_steps");
+    writer.Uint64(physicsSteps);
+    writer.Key("heap_allocations_per_tick");
+    writer.Double(static_cast<double>(heapAllocations) / options.ticks);
+    if (scenario.spawnPerTick > 0) {
+        writer.Key("heap_allocations_per_spawned_actor");
+        writer.Double(static_cast<double>(heapAllocations) /
+                      (static_cast<double>(options.ticks) * scenario.spawnPerTick));
+    }
+
+    const auto &arenaStats = room->game().currentScene().arena().stats();
+    const auto &poolStats = room->game().currentScene().templatePool().stats();
+    writer.Key("template_pool");
+    writer.StartObject();
+    writer.Key("hits");
+    writer.Uint64(poolStats.hits);
+    writer.Key("misses");
+    writer.Uint64(poolStats.misses);
+    writer.Key("recycled");
+    writer.Uint64(poolStats.recycled);
+    writer.Key("discarded");
+    writer.Uint64(poolStats.discarded);
+    writer.EndObject();
+
+    writer.Key("scene_arena");
+    writer.StartObject();
+    writer.Key("chunks");
+    writer.Uint64(arenaStats.chunks);
+    writer.Key("allocations");
+    writer.Uint64(arenaStats.allocations);
+    writer.Key("live");
+    writer.Uint64(arenaStats.allocations - arenaStats.deallocations);
+    writer.Key("oversized");
+    writer.Uint64(arenaStats.oversized);
+    writer.EndObject();
+
+    writer.Key("phases");
+    writer.StartObject();
+    for (auto &phase : phases) {
+        writePhase(writer, phase);
+    }
+    writer.EndObject();
+
+    writer.EndObject();
+
+    writeReport(options, buffer);
+
+    return 0;
+}
@@ -18,6 +18,7 @@
 #include "resources/Configs.hpp"
 #include "scripting/Libs.hpp"
 #include "scripting/Scripting.hpp"
+#include "util/Trace.hpp"
 
 #include <cassert>
 #include <chrono>
@@ -25,6 +26,7 @@
 #include <iostream>
 #include <memory>
 #include <set>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <variant>
@@ -60,11 +62,13 @@ Client::Client(resources::ClientConfig clientConfig, resources::GameConfig gameC
 }
 
 void Client::run() {
+    util::SetTraceThreadName("Client");
     while (this->running_) {
 #ifdef TRACK_FPS
         util::StartFrame();
 #endif
 
+        TRACE_ZONE("Client.Frame");
         this->readInput();
         this->update();
         this->render();
@@ -160,15 +164,18 @@ void Client::setNextScene(std::string_view name) {
 }
 
 void Client::render() {
+    TRACE_ZONE("Client.Render");
     Renderer::renderClear();
     this->game_->render();
 }
 
-void Client::connect(std::string_view host, std::string_view port) {
-    // Connect to host
+void Client::connect(std::string_view host, std::string_view port, std::string_view room) {
+    // Connect to host and ask to join the room
     this->state_ = State::Connecting;
     this->netClient_.connect(host, port);
-    this->netClient_.session().postMessage(net::MessageHello{});
+    this->netClient_.session().postMessage(net::MessageHello{
+        .room = std::string{room},
+    });
 }
 
 void Client::disconnect() {
@@ -186,6 +193,7 @@ void Client::disconnect() {
 }
 
 void Client::processNetwork() {
+    TRACE_ZONE("Client.ProcessNetwork");
     if (this->netClient_.session().stopped()) {
         // Session is apparently stopped. Mark current state as disconnected.
         this->disconnect();
@@ -231,8 +239,13 @@ void Client::processMessage(const net::MessageWelcome &m) {
     this->state_ = State::Connected;
 }
 
-void Client::processMessage(const net::MessageLoadScene &m) {
+void Client::processMessage(net::MessageLoadScene &m) {
     assert(this->state_ == State::Connected);
+    // The server's deltas are against the scene state from here on
+    this->baselines_.clear();
+    this->baselines_.record(m.sceneState);
+    this->resyncRequested_ = false;
+
     if (this->game_ == nullptr) {
         std::cerr << "warning: received MessageLoadScene without game" << std::endl;
         return;
@@ -261,8 +274,33 @@ void Client::processMessage(const net::MessageLoadScene &m) {
     }
 }
 
-void Client::processMessage(const net::MessageTickReplication &m) {
+void Client::processMessage(net::MessageTickReplication &m) {
     assert(this->state_ == State::Connected);
+    // Rebuild delta encoded states first, so that the baselines stay in step
+    // with the server's even if the message isn't processed
+    if (m.keyframe) {
+        // The server dropped its baselines for our resync request
+        this->baselines_.clear();
+        this->resyncRequested_ = false;
+    }
+    for (auto &req : m.replications) {
+        if (this->baselines_.decode(req)) {
+            continue;
+        }
+        std::cerr << "warning: dropping replication of " << req.componentKey << " on actor "
+                  << req.actorID << " without a baseline" << std::endl;
+        if (!this->resyncRequested_) {
+            // Have the server send full states until both ends agree again
+            this->netClient_.session().postMessage(net::MessageResyncRequest{
+                .generation = this->generation_,
+            });
+            this->resyncRequested_ = true;
+        }
+    }
+    for (auto id : net::SharedElements(m.destructions)) {
+        this->baselines_.erase(id);
+    }
+
     if (this->game_ == nullptr) {
         std::cerr << "warning: received MessageTickReplication without game" << std::endl;
         return;
@@ -273,7 +311,7 @@ void Client::processMessage(const net::MessageTickReplication &m) {
     // 3. Destroy any actors that need to be destroyed.
     auto &scene = this->game_->currentScene();
 
-    for (const auto &instantiation : m.instantiations) {
+    for (const auto &instantiation : net::SharedElements(m.instantiations)) {
         // Actually create the actor based on the template
         auto* a = scene.instantiateRuntimeActor(instantiation.actorTemplate, instantiation.owner);
         // Register the ID of the runtime actor on the server
@@ -283,11 +321,15 @@ void Client::processMessage(const net::MessageTickReplication &m) {
     }
 
     for (const auto &req : m.replications) {
+        if (req.delta) {
+            // Couldn't be rebuilt above
+            continue;
+        }
         // Perform interp on tick replications
         net::ReplicatorService::dispatchReplication(*this->game_, req, true);
     }
 
-    for (auto id : m.destructions) {
+    for (auto id : net::SharedElements(m.destructions)) {
         // Find the actor to destroy
         auto* a = scene.findActorByRemoteID(id);
         if (a == nullptr) {
@@ -400,7 +442,7 @@ void Client::processMessage(net::MessageRemoteEvents &m) {
     this->doAfterUpdate([this, publishes = std::move(m.publishes)] {
         // Dispatch all events to the game's EventSub instance
         for (const auto &p : publishes) {
-            this->game_->eventSub().publish(p.event, p.value);
+            net::ReplicatorService::dispatchEventPublish(*this->game_, p);
         }
     });
 }
@@ -408,6 +450,7 @@ void Client::processMessage(net::MessageRemoteEvents &m) {
 //-----------------------------------------------------------------------------
 
 void Client::executeReplications() {
+    TRACE_ZONE("Client.ExecuteReplications");
     auto now = std::chrono::steady_clock::now();
     if (!this->replicationRequired(now)) {
         return;
@@ -440,9 +483,10 @@ void Client::executeTickReplication() {
 
     this->netClient_.session().postMessage(net::MessageTickReplication{
         .generation = this->generation_,
-        .instantiations = std::move(instantiations),
+        .instantiations =
+            std::make_shared<std::vector<net::InstantiatedActor>>(std::move(instantiations)),
         .replications = std::move(replications),
-        .destructions = std::move(destructions),
+        .destructions = std::make_shared<std::vector<actor_id_t>>(std::move(destructions)),
     });
 }
 
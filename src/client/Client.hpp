@@ -7,6 +7,7 @@
 #include "Types.hpp"
 #include "game/Game.hpp"
 #include "net/Client.hpp"
+#include "net/DeltaReplication.hpp"
 #include "net/Messages.hpp"
 #include "net/Replicator.hpp"
 #include "render/RenderQueue.hpp"
@@ -30,7 +31,7 @@ public:
     void run();
     void destroy();
 
-    void connect(std::string_view host, std::string_view port);
+    void connect(std::string_view host, std::string_view port, std::string_view room);
     void disconnect();
 
     const resources::ClientConfig &config() const;
@@ -63,8 +64,8 @@ private:
     void processMessage(std::unique_ptr<net::SMessage> msg);
     void processMessage(const net::MessageError &m);
     void processMessage(const net::MessageWelcome &m);
-    void processMessage(const net::MessageLoadScene &m);
-    void processMessage(const net::MessageTickReplication &m);
+    void processMessage(net::MessageLoadScene &m);
+    void processMessage(net::MessageTickReplication &m);
     void processMessage(const net::MessageTickReplicationAck &m);
     void processMessage(const net::MessageTickReplicationReject &m);
     void processMessage(const net::MessageRoomState &m);
@@ -86,6 +87,10 @@ private:
 
     net::Client netClient_;
     net::ReplicatorService replicatorService_;
+    // Last component states received from the server
+    net::ReplicationBaselines baselines_;
+    // Whether a MessageResyncRequest awaits the server's keyframe
+    bool resyncRequested_{false};
     std::chrono::steady_clock::time_point lastReplication_{};
 
     std::unique_ptr<game::Game> game_{nullptr};
@@ -109,7 +109,7 @@ game::Actor* ClientInterface::actorFind(std::string_view name) {
     return CurrentScene().findActor(name);
 }
 
-std::vector<game::Actor*> ClientInterface::actorFindAll(std::string_view name) {
+const std::vector<game::Actor*> &ClientInterface::actorFindAll(std::string_view name) {
     return CurrentScene().findAllActors(name);
 }
 
@@ -257,14 +257,21 @@ std::vector<physics::HitResult> ClientInterface::physicsRaycastAll(const b2Vec2
     return CurrentGame().physicsWorld().raycastAll(pos, direction, distance);
 }
 
+float ClientInterface::physicsGetInterpolationAlpha() {
+    return CurrentGame().physicsAlpha();
+}
+
+float ClientInterface::physicsGetTimeStep() {
+    return std::chrono::duration<float>(CurrentGame().physicsStepDuration()).count();
+}
+
 void ClientInterface::eventPublish(std::string_view eventType, const luabridge::LuaRef &value) {
     CurrentGame().eventSub().publish(eventType, value);
 }
 
 void ClientInterface::eventPublishRemote(std::string_view eventType, const luabridge::LuaRef &value,
                                          bool publishLocally) {
-    auto replicableValue = value.cast<scripting::LuaValue>();
-    CurrentClient().replicatorService().eventPublish(eventType, std::move(replicableValue));
+    CurrentClient().replicatorService().eventPublish(eventType, value);
     if (publishLocally) {
         CurrentGame().eventSub().publish(eventType, value);
     }
@@ -279,8 +286,9 @@ void ClientInterface::eventUnsubscribe(scripting::subscription_handle handle) {
     CurrentGame().eventSub().unsubscribe(handle);
 }
 
-void ClientInterface::multiplayerConnect(std::string_view host, std::string_view port) {
-    CurrentClient().connect(host, port);
+void ClientInterface::multiplayerConnect(std::string_view host, std::string_view port,
+                                         std::string_view room) {
+    CurrentClient().connect(host, port, room);
 }
 
 void ClientInterface::multiplayerDisconnect() {
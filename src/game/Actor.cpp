@@ -4,6 +4,7 @@
 #include <lua/lua.hpp>
 #include <LuaBridge/LuaBridge.h>
 
+#include "Common.hpp"
 #include "Realm.hpp"
 #include "Types.hpp"
 #include "physics/Collision.hpp"
@@ -12,10 +13,14 @@
 #include "scripting/Component.hpp"
 #include "scripting/ComponentContainer.hpp"
 #include "scripting/Invoke.hpp"
+#include "scripting/TemplatePool.hpp"
+#include "scripting/components/TransformPool.hpp"
+#include "util/Arena.hpp"
+#include "util/Symbol.hpp"
+#include "util/Trace.hpp"
 
 #include <cassert>
 #include <functional>
-#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -26,8 +31,6 @@
 namespace sge::game {
 
 using namespace sge::resources;
-using namespace std::string_view_literals;
-
 namespace {
 
 template <typename Dst, typename Src>
@@ -38,78 +41,74 @@ void applyOverride(Dst &dst, const std::optional<Src> &src) {
     dst = {*src};
 }
 
-scripting::ComponentContainer constructComponentsForActor(const resources::ActorDescription &source,
-                                                          Actor &actor) {
-    std::map<std::string, std::unique_ptr<scripting::Component>, std::less<>> components;
+void constructComponentsForActor(const scripting::ActorTemplate* actorTemplate,
+                                 const resources::ActorDescription &source, Actor &actor,
+                                 scripting::TemplatePool &templatePool) {
+    // Construct in place, since the container stores its components inline
+    auto &components = actor.components;
 
-    if (source.template_name) {
-        const auto &instance = scripting::GetActorTemplateInstance(*source.template_name);
+    if (actorTemplate != nullptr) {
         // Create components based on template components
-        for (const auto &component : instance.components()) {
-            auto instance = component.second->clone();
-            instance->setActor(&actor);
-            instance->setKey(component.first);
-            instance->setEnabled(true);
-            components.emplace(component.first, std::move(instance));
-        }
+        actorTemplate->instantiateComponents(actor, components, templatePool);
     }
 
     for (const auto &item : source.components) {
-        auto existingIt = components.find(item.first);
-        if (existingIt == components.end()) {
+        auto* existing = components.getComponentByKey(item.first);
+        if (existing == nullptr) {
             // New component
             auto component = scripting::InstantiateComponent(item.second.type, item.second.realm);
             component->setActor(&actor);
             component->setKey(item.first);
             component->setValues(item.second.values);
             component->setEnabled(true);
-            components.emplace(item.first, std::move(component));
+            components.addComponent(std::move(component));
             continue;
         }
 
         // Overriding component provided by template
-        existingIt->second->setValues(item.second.values);
+        existing->setValues(item.second.values);
     }
-
-    return scripting::ComponentContainer{std::move(components)};
 }
 
 template <class... Args, class... Args2>
 void callComponentFunc(Actor &actor, void (scripting::Component::*componentFunc)(Args...),
                        Args2 &&... args) {
+    // Components removed with Actor.RemoveComponent are disabled right away, and
+    // deleted by the scene once no lifecycle dispatch is in progress.
     for (auto &entry : actor.components) {
         if (!actor.runLifecycleFunctions()) {
             break;
         }
 
-        auto &component = entry.second;
+        auto &component = entry.component;
         if (!component->lifecycleCanRunUnderActor()) {
             // Component should only run on owner client
             continue;
         }
         if (component->lifecycleShouldRun()) {
-            scripting::ActorInvoke(actor.name, [&]() {
+            scripting::ActorInvoke(actor.name.str(), [&]() {
                 (component.get()->*componentFunc)(std::forward<Args2>(args)...);
             });
         }
     }
-
-    // Clean up any removed components
-    actor.components.removeDeferred();
 }
 
 } // namespace
 
-Actor::Actor(actor_id_t id, bool runtime, const resources::ActorDescription &source)
-    : id(id) {
+Actor::Actor(ActorHandle handle, actor_id_t id, bool runtime,
+             const resources::ActorDescription &source, scripting::TemplatePool &templatePool)
+    : handle(handle)
+    , id(id) {
+    const scripting::ActorTemplate* actorTemplate = nullptr;
     if (source.template_name) {
         // Initialize with template data
-        const auto &actorTemplate = resources::GetActorTemplateDescription(*source.template_name);
-        this->name = actorTemplate.name;
-        this->deferServerDestroys = actorTemplate.deferServerDestroys;
+        actorTemplate = &scripting::GetActorTemplateInstance(*source.template_name);
+        this->templateName_ = *source.template_name;
+        this->name = actorTemplate->name();
+        this->deferServerDestroys = actorTemplate->deferServerDestroys();
     } else {
         // Initialize with defaults
-        this->name = ""sv;
+        this->name = util::Symbol{};
         this->deferServerDestroys = false;
     }
 
@@ -124,7 +123,7 @@ Actor::Actor(actor_id_t id, bool runtime, const resources::ActorDescription &sou
     applyOverride(this->deferServerDestroys, source.deferServerDestroys);
 
     // Construct component instances
-    this->components = constructComponentsForActor(source, *this);
+    constructComponentsForActor(actorTemplate, source, *this, templatePool);
 }
 
 bool Actor::destroyed() const {
@@ -135,10 +134,14 @@ bool Actor::runtime() const {
     return !this->runtimeTemplate_.empty();
 }
 
-const std::string &Actor::runtimeTemplate() {
+util::Symbol Actor::runtimeTemplate() const {
     return this->runtimeTemplate_;
 }
 
+util::Symbol Actor::templateName() const {
+    return this->templateName_;
+}
+
 bool Actor::runLifecycleFunctions() const {
     switch (this->lifecycleState) {
     case ActorLifecycleState::Alive:
@@ -150,60 +153,76 @@ bool Actor::runLifecycleFunctions() const {
     }
 }
 
-void Actor::onStart() {
+bool Actor::handlesLifecycle(scripting::Lifecycle lifecycle) const {
+    return (this->lifecycleHandlers & scripting::LifecycleBit(lifecycle)) != 0;
+}
+
+bool Actor::onStart(std::vector<scripting::Component*> &started) {
+    bool allStarted = true;
     for (auto &entry : this->components) {
         if (!this->runLifecycleFunctions()) {
             break;
         }
-        auto &component = entry.second;
+        auto &component = entry.component;
         if (component->initialized()) {
             // Only initialize once
             continue;
         }
         if (!component->lifecycleCanRunUnderActor()) {
             // Component should only run on owner client
+            allStarted = false;
             continue;
         }
         // Mark component as initialized
         component->initialize();
+        started.push_back(component.get());
+        if (component->realmMatches()) {
+            this->lifecycleHandlers |= component->lifecycleHandlers();
+        }
         if (component->lifecycleShouldRun()) {
-            scripting::ActorInvoke(this->name, [&]() {
+            scripting::ActorInvoke(this->name.str(), [&]() {
                 component->onStart();
             });
         }
     }
-}
-
-void Actor::onUpdate(float dt) {
-    callComponentFunc(*this, &scripting::Component::onUpdate, dt);
-}
-
-void Actor::onLateUpdate(float dt) {
-    callComponentFunc(*this, &scripting::Component::onLateUpdate, dt);
+    return allStarted;
 }
 
 void Actor::onDestroy() {
+    TRACE_ZONE_DETAIL("OnDestroy", this->name.str());
     callComponentFunc(*this, &scripting::Component::onDestroy);
 }
 
 void Actor::onCollisionEnter(const physics::Collision &collision) {
+    if (!this->handlesLifecycle(scripting::Lifecycle::OnCollisionEnter)) {
+        return;
+    }
     callComponentFunc(*this, &scripting::Component::onCollisionEnter, collision);
 }
 
 void Actor::onCollisionExit(const physics::Collision &collision) {
+    if (!this->handlesLifecycle(scripting::Lifecycle::OnCollisionExit)) {
+        return;
+    }
     callComponentFunc(*this, &scripting::Component::onCollisionExit, collision);
 }
 
 void Actor::onTriggerEnter(const physics::Collision &collision) {
+    if (!this->handlesLifecycle(scripting::Lifecycle::OnTriggerEnter)) {
+        return;
+    }
     callComponentFunc(*this, &scripting::Component::onTriggerEnter, collision);
 }
 
 void Actor::onTriggerExit(const physics::Collision &collision) {
+    if (!this->handlesLifecycle(scripting::Lifecycle::OnTriggerExit)) {
+        return;
+    }
     callComponentFunc(*this, &scripting::Component::onTriggerExit, collision);
 }
 
 std::string_view Actor::getName() const {
-    return this->name;
+    return this->name.str();
 }
 
 actor_id_t Actor::getID() const {
@@ -231,12 +250,18 @@ scripting::Component* Actor::addComponent(std::string_view type) {
     // will not be replicated, so assign the realm to match whether we are running
     // on the server or the client.
     auto realm = CurrentRealm() == GeneralRealm::Server ? Realm::Server : Realm::Client;
-    auto instance = scripting::InstantiateComponent(std::string(type), realm);
+    util::ArenaScope arenaScope{&CurrentScene().arena()};
+    scripting::TransformPoolScope transformPoolScope{&CurrentScene().transformPool()};
+    auto instance = scripting::InstantiateComponent(util::Intern(type), realm);
     auto key = scripting::NextRuntimeComponentKey();
     instance->setActor(this);
     instance->setKey(key);
     instance->setEnabled(true);
-    return this->components.addComponent(key, std::move(instance));
+    // This may be called from a lifecycle function that is iterating the
+    // components, so the component only joins them when the scene starts it
+    auto* component = this->components.addComponentLater(std::move(instance));
+    CurrentScene().startActorLater(this);
+    return component;
 }
 
 void Actor::removeComponent(const luabridge::LuaRef &ref) {
@@ -244,8 +269,7 @@ void Actor::removeComponent(const luabridge::LuaRef &ref) {
     if (component == nullptr) {
         return;
     }
-    component->setEnabled(false);
-    this->components.removeComponentLater(component);
+    CurrentScene().removeComponentLater(this, component);
 }
 
 bool Actor::pendingServerDestroy() const {
@@ -257,13 +281,13 @@ void Actor::destroy() {
         this->lifecycleState == ActorLifecycleState::PendingServerDestroy) {
         this->destroyLocally();
     } else {
-        this->lifecycleState = ActorLifecycleState::Destroyed;
+        this->markDestroyed();
         CurrentReplicatorService().destroy(this);
     }
 }
 
 void Actor::destroyLocally() {
-    this->lifecycleState = ActorLifecycleState::Destroyed;
+    this->markDestroyed();
     CurrentReplicatorService().erasePendingReplications(this);
 }
 
@@ -276,4 +300,23 @@ void Actor::serverRequestedDestroy() {
     }
 }
 
+void Actor::markDestroyed() {
+    if (this->destroyed()) {
+        return;
+    }
+    this->lifecycleState = ActorLifecycleState::Destroyed;
+    // The scene removes the actor at the end of the frame
+    CurrentScene().removeActorLater(this);
+}
+
+Actor* ResolveActorHandle(lua_State* L, ActorHandle handle) {
+    auto* actor = CurrentScene().resolveActor(handle);
+    if (actor == nullptr) {
+        // A C++ exception can't unwind through Lua, so raise a Lua error that
+        // the caller's message handler reports
+        luaL_error(L, "tried to use an actor that has been destroyed");
+    }
+    return actor;
+}
+
 } // namespace sge::game
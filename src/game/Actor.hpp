@@ -9,7 +9,9 @@
 #include "physics/Collision.hpp"
 #include "resources/Resources.hpp"
 #include "scripting/ComponentContainer.hpp"
+#include "util/Symbol.hpp"
 
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <string>
@@ -20,7 +22,8 @@ namespace sge {
 
 namespace scripting {
 class Component;
-}
+class TemplatePool;
+} // namespace scripting
 
 namespace game {
 
@@ -31,31 +34,55 @@ enum class ActorLifecycleState {
     Destroyed,
 };
 
+/**
+ * @brief Refers to an actor in the current scene without owning it. A handle
+ * goes stale once its actor is removed, even if another actor takes its slot.
+ */
+struct ActorHandle {
+    std::uint32_t index{0};
+    std::uint32_t generation{0};
+
+    bool operator==(const ActorHandle &other) const = default;
+};
+
 class Actor {
 public:
-    Actor(actor_id_t id, bool runtime, const resources::ActorDescription &source);
+    Actor(ActorHandle handle, actor_id_t id, bool runtime,
+          const resources::ActorDescription &source, scripting::TemplatePool &templatePool);
 
+    ActorHandle handle;
     actor_id_t id;
     std::optional<actor_id_t> remoteID{std::nullopt};
     std::optional<client_id_t> ownerClient{std::nullopt};
 
-    std::string_view name{};
+    util::Symbol name{};
     scripting::ComponentContainer components{};
     ActorLifecycleState lifecycleState{ActorLifecycleState::Uninitialized};
     bool persistent{false};
     bool deferServerDestroys{false};
+    // Lifecycle functions implemented by any of the actor's started components
+    scripting::LifecycleMask lifecycleHandlers{0};
 
     bool destroyed() const;
     bool runtime() const;
-    const std::string &runtimeTemplate();
+    util::Symbol runtimeTemplate() const;
+    // Template the actor was created from, or an empty symbol
+    util::Symbol templateName() const;
 
     // ===================
     // Lifecycle functions
     // ===================
     bool runLifecycleFunctions() const;
-    void onStart();
-    void onUpdate(float dt);
-    void onLateUpdate(float dt);
+    bool handlesLifecycle(scripting::Lifecycle lifecycle) const;
+
+    /**
+     * @brief Initialize and start any components that haven't been started.
+     *
+     * @param started Receives the components that were started.
+     * @return Whether every component has been started. Components that may
+     * only run under the owning client are left for a later call.
+     */
+    bool onStart(std::vector<scripting::Component*> &started);
     void onDestroy();
     void onCollisionEnter(const physics::Collision &collision);
     void onCollisionExit(const physics::Collision &collision);
@@ -82,13 +109,51 @@ public:
     void serverRequestedDestroy();
 
 private:
-    std::string runtimeTemplate_{};
+    void markDestroyed();
+
+    util::Symbol runtimeTemplate_{};
+    util::Symbol templateName_{};
 };
 
+/**
+ * @brief Get the actor of the current scene that a handle refers to, for a
+ * binding called from Lua.
+ *
+ * Raises a Lua error if the actor has been removed, so it must only be called
+ * from a protected call.
+ */
+Actor* ResolveActorHandle(lua_State* L, ActorHandle handle);
+
 } // namespace game
 
 } // namespace sge
 
+// Lua holds actors by handle, so scripts that keep an actor around after it is
+// removed get an error instead of a dangling pointer.
+template <>
+struct luabridge::Stack<sge::game::Actor*> {
+    static void push(lua_State* L, sge::game::Actor* actor) {
+        if (actor == nullptr) {
+            luabridge::Stack<luabridge::Nil>::push(L, luabridge::Nil{});
+            return;
+        }
+        luabridge::Stack<sge::game::ActorHandle>::push(L, actor->handle);
+    }
+
+    static sge::game::Actor* get(lua_State* L, int index) {
+        if (lua_isnil(L, index)) {
+            return nullptr;
+        }
+        return sge::game::ResolveActorHandle(
+            L, luabridge::Stack<sge::game::ActorHandle>::get(L, index));
+    }
+
+    static bool isInstance(lua_State* L, int index) {
+        return lua_isnil(L, index) ||
+               luabridge::Stack<sge::game::ActorHandle>::isInstance(L, index);
+    }
+};
+
 template <>
 struct std::less<const sge::game::Actor*> {
     bool operator()(const sge::game::Actor* a1, const sge::game::Actor* a2) const {
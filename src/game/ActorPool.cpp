@@ -0,0 +1,134 @@
+#include "game/ActorPool.hpp"
+
+#include "Types.hpp"
+#include "game/Actor.hpp"
+#include "resources/Resources.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace sge::game {
+
+ActorPool::~ActorPool() {
+    this->clear();
+}
+
+ActorPool::ActorPool(ActorPool &&other) noexcept
+    : chunks_(std::exchange(other.chunks_, {}))
+    , freeSlots_(std::exchange(other.freeSlots_, {}))
+    , active_(std::exchange(other.active_, {})) {}
+
+ActorPool &ActorPool::operator=(ActorPool &&other) noexcept {
+    if (this != &other) {
+        this->clear();
+        this->chunks_ = std::exchange(other.chunks_, {});
+        this->freeSlots_ = std::exchange(other.freeSlots_, {});
+        this->active_ = std::exchange(other.active_, {});
+    }
+    return *this;
+}
+
+Actor* ActorPool::create(actor_id_t id, bool runtime, const resources::ActorDescription &source,
+                         scripting::TemplatePool &templatePool) {
+    if (this->freeSlots_.empty()) {
+        // Allocate another chunk, handing out its lowest slots first
+        auto first = static_cast<std::uint32_t>(this->chunks_.size() * ActorPoolChunkSize);
+        this->chunks_.push_back(std::make_unique<Slot[]>(ActorPoolChunkSize));
+        for (auto i = static_cast<std::uint32_t>(ActorPoolChunkSize); i > 0; --i) {
+            this->freeSlots_.push_back(first + i - 1);
+        }
+    }
+
+    auto index = this->freeSlots_.back();
+    auto &slot = this->slot(index);
+    // The actor hands its handle to its components while being constructed, so
+    // the handle has to be known up front.
+    new (slot.storage)
+        Actor(ActorHandle{index, slot.generation}, id, runtime, source, templatePool);
+    this->freeSlots_.pop_back();
+    slot.occupied = true;
+    return slot.actor();
+}
+
+void ActorPool::activate(Actor* actor) {
+    auto &slot = this->slot(actor->handle.index);
+    assert(slot.occupied && slot.activeIndex == Inactive);
+    slot.activeIndex = static_cast<std::uint32_t>(this->active_.size());
+    this->active_.push_back(actor);
+}
+
+bool ActorPool::active(const Actor* actor) const {
+    return this->slot(actor->handle.index).activeIndex != Inactive;
+}
+
+void ActorPool::destroy(Actor* actor) {
+    auto index = actor->handle.index;
+    auto &slot = this->slot(index);
+    assert(slot.occupied && slot.actor() == actor);
+
+    if (slot.activeIndex != Inactive) {
+        // Swap with the last active actor
+        auto* last = this->active_.back();
+        this->active_[slot.activeIndex] = last;
+        this->slot(last->handle.index).activeIndex = slot.activeIndex;
+        this->active_.pop_back();
+        slot.activeIndex = Inactive;
+    }
+
+    actor->~Actor();
+    slot.occupied = false;
+    ++slot.generation;
+    this->freeSlots_.push_back(index);
+}
+
+void ActorPool::clear() {
+    for (auto &chunk : this->chunks_) {
+        for (std::size_t i = 0; i < ActorPoolChunkSize; ++i) {
+            auto &slot = chunk[i];
+            if (slot.occupied) {
+                slot.actor()->~Actor();
+                slot.occupied = false;
+            }
+        }
+    }
+    this->chunks_.clear();
+    this->freeSlots_.clear();
+    this->active_.clear();
+}
+
+Actor* ActorPool::get(ActorHandle handle) const {
+    if (handle.index >= this->chunks_.size() * ActorPoolChunkSize) {
+        return nullptr;
+    }
+    auto &slot = this->slot(handle.index);
+    if (!slot.occupied || slot.generation != handle.generation) {
+        return nullptr;
+    }
+    return slot.actor();
+}
+
+ActorPool::const_iterator ActorPool::begin() const {
+    return this->active_.begin();
+}
+
+ActorPool::const_iterator ActorPool::end() const {
+    return this->active_.end();
+}
+
+std::size_t ActorPool::size() const {
+    return this->active_.size();
+}
+
+bool ActorPool::empty() const {
+    return this->active_.empty();
+}
+
+ActorPool::Slot &ActorPool::slot(std::uint32_t index) const {
+    return this->chunks_[index / ActorPoolChunkSize][index % ActorPoolChunkSize];
+}
+
+} // namespace sge::game
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Types.hpp"
+#include "game/Actor.hpp"
+#include "resources/Resources.hpp"
+#include "scripting/TemplatePool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace sge::game {
+
+/**
+ * @brief Number of actor slots allocated at once by an ActorPool.
+ */
+constexpr std::size_t ActorPoolChunkSize = 128;
+
+/**
+ * @brief Owns the actors of a scene. Actors are constructed in place in chunks
+ * of slots, so they never move and don't each need an allocation. The slot of
+ * a destroyed actor is reused by later actors under a new generation, which
+ * makes handles to the destroyed actor stale.
+ *
+ * Iteration only visits activated actors, in no particular order, so a scene
+ * can hold actors instantiated mid-frame back until the end of the frame.
+ */
+class ActorPool {
+public:
+    using const_iterator = std::vector<Actor*>::const_iterator;
+
+    ActorPool() = default;
+    ~ActorPool();
+
+    ActorPool(const ActorPool &) = delete;
+    ActorPool &operator=(const ActorPool &) = delete;
+    ActorPool(ActorPool &&other) noexcept;
+    ActorPool &operator=(ActorPool &&other) noexcept;
+
+    /**
+     * @brief Construct a new actor. The actor can be resolved from its handle
+     * right away, but is not iterated until activated.
+     */
+    Actor* create(actor_id_t id, bool runtime, const resources::ActorDescription &source,
+                  scripting::TemplatePool &templatePool);
+    void activate(Actor* actor);
+    bool active(const Actor* actor) const;
+
+    /**
+     * @brief Destroy an actor and free its slot. O(1).
+     */
+    void destroy(Actor* actor);
+    void clear();
+
+    /**
+     * @brief Get the actor a handle refers to, or nullptr if it is stale.
+     */
+    Actor* get(ActorHandle handle) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    std::size_t size() const;
+    bool empty() const;
+
+private:
+    static constexpr std::uint32_t Inactive = UINT32_MAX;
+
+    struct Slot {
+        alignas(Actor) std::byte storage[sizeof(Actor)];
+        // Starts at 1, so a default ActorHandle never resolves
+        std::uint32_t generation{1};
+        std::uint32_t activeIndex{Inactive};
+        bool occupied{false};
+
+        Actor* actor() {
+            return std::launder(reinterpret_cast<Actor*>(this->storage));
+        }
+    };
+
+    Slot &slot(std::uint32_t index) const;
+
+    std::vector<std::unique_ptr<Slot[]>> chunks_;
+    std::vector<std::uint32_t> freeSlots_;
+    // Activated actors, packed for iteration
+    std::vector<Actor*> active_;
+};
+
+} // namespace sge::game
@@ -11,11 +11,12 @@
 #include "resources/Configs.hpp"
 #include "resources/Resources.hpp"
 #include "scripting/EventSub.hpp"
-#include "scripting/Tracing.hpp"
+#include "util/Trace.hpp"
 
 #include <cassert>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -23,7 +24,10 @@ namespace sge::game {
 
 Game::Game(resources::GameConfig gameConfig)
     : gameConfig_(std::move(gameConfig))
-    , physicsWorld_(std::make_unique<physics::World>(this)) {}
+    , physicsWorld_(std::make_unique<physics::World>(this))
+    , physicsStepDuration_(std::chrono::nanoseconds(std::chrono::seconds(1)) /
+                           this->gameConfig_.physics_rate)
+    , physicsStepSeconds_(1.0F / static_cast<float>(this->gameConfig_.physics_rate)) {}
 
 Game::~Game() {
     this->destroy();
@@ -32,7 +36,9 @@ Game::~Game() {
 void Game::update() {
     auto now = std::chrono::high_resolution_clock::now();
     std::chrono::microseconds dtUs{};
-    if (this->lastFrameValid_) [[likely]] {
+    if (this->fixedFrameTime_.has_value()) {
+        dtUs = *this->fixedFrameTime_;
+    } else if (this->lastFrameValid_) [[likely]] {
         dtUs = std::chrono::duration_cast<std::chrono::microseconds>(now - this->lastFrame_);
     } else {
         dtUs = SixtyFPSFrameDuration;
@@ -47,21 +53,66 @@ void Game::update() {
         return;
     }
 
+    TRACE_ZONE("Game.Update");
+
+    // Time each phase of the update, ending one phase and starting the next
+    // with a single clock read.
+    auto &timings = this->lastUpdateTimings_;
+    auto phaseStart = std::chrono::steady_clock::now();
+    auto endPhase = [&phaseStart](std::chrono::nanoseconds &phase) {
+        auto phaseEnd = std::chrono::steady_clock::now();
+        phase = phaseEnd - phaseStart;
+        phaseStart = phaseEnd;
+    };
+
     // Run lifecycle functions
     this->updateOnStart();
+    endPhase(timings.onStart);
     this->updateOnUpdate(dtS);
+    endPhase(timings.onUpdate);
     this->updateOnLateUpdate(dtS);
+    endPhase(timings.onLateUpdate);
 
     // Process Event.Subscribe/Event.Unsubscribe calls made during the frame
     this->eventSub_.executePendingSubscriptions();
+    endPhase(timings.pendingSubscriptions);
 
     // Insert any actors that were created during the frame
     this->scene_->insertInstantiatedActors();
+    endPhase(timings.insertInstantiatedActors);
     // Remove any actors that were destroyed during the frame
     this->scene_->removeDestroyedActors();
+    endPhase(timings.removeDestroyedActors);
 
     // Step physics world
-    this->physicsWorld_->step();
+    this->updatePhysics(dtUs);
+    endPhase(timings.physicsStep);
+}
+
+void Game::updatePhysics(std::chrono::microseconds dt) {
+    TRACE_ZONE("Game.UpdatePhysics");
+    this->physicsAccumulator_ += dt;
+
+    unsigned int steps = 0;
+    while (this->physicsAccumulator_ >= this->physicsStepDuration_) {
+        if (steps == this->gameConfig_.physics_max_substeps) {
+            // Too far behind to catch up. Drop the whole steps that are left
+            // instead of running them next frame, which would only put us
+            // further behind.
+            this->physicsAccumulator_ %= this->physicsStepDuration_;
+            break;
+        }
+        this->physicsWorld_->step(this->physicsStepSeconds_);
+        this->physicsAccumulator_ -= this->physicsStepDuration_;
+        ++steps;
+    }
+    this->lastPhysicsSteps_ = steps;
+    // Draw bodies between the last two steps, so that they don't move only at
+    // the physics rate
+    this->physicsWorld_->interpolate(this->physicsAlpha());
+
+    // Delete any components removed by collision handlers
+    this->scene_->flushRemovedComponents();
 }
 
 void Game::destroy() {
@@ -76,35 +127,20 @@ void Game::destroy() {
 
 void Game::updateOnStart() {
     assert(this->scene_ != nullptr);
-    // Execute all pending OnStart calls
-    for (auto &actor : this->scene_->actors()) {
-        if (actor->lifecycleState == ActorLifecycleState::Uninitialized) {
-            actor->lifecycleState = ActorLifecycleState::Alive;
-        }
-        TRACE_BEGIN("OnStart", actor->getName());
-        actor->onStart();
-        TRACE_END;
-    }
+    TRACE_ZONE("Game.OnStart");
+    this->scene_->runOnStart();
 }
 
 void Game::updateOnUpdate(float dt) {
     assert(this->scene_ != nullptr);
-    // Execute all OnUpdate calls
-    for (auto &actor : this->scene_->actors()) {
-        TRACE_BEGIN("OnUpdate", actor->getName());
-        actor->onUpdate(dt);
-        TRACE_END;
-    }
+    TRACE_ZONE("Game.OnUpdate");
+    this->scene_->runOnUpdate(dt);
 }
 
 void Game::updateOnLateUpdate(float dt) {
     assert(this->scene_ != nullptr);
-    // Execute all OnLateUpdate calls
-    for (auto &actor : this->scene_->actors()) {
-        TRACE_BEGIN("OnLateUpdate", actor->getName());
-        actor->onLateUpdate(dt);
-        TRACE_END;
-    }
+    TRACE_ZONE("Game.OnLateUpdate");
+    this->scene_->runOnLateUpdate(dt);
 }
 
 void Game::render() {
@@ -115,20 +151,24 @@ void Game::BeginContact(b2Contact* contact) {
     const auto &[collisionA, collisionB, kind] = physics::CollisionFromContactEnter(contact);
     switch (kind) {
     case physics::CollisionKind::Collider:
-        TRACE_BEGIN("OnCollisionEnter", collisionA.me->name);
-        collisionA.me->onCollisionEnter(collisionA.collision);
-        TRACE_END;
-        TRACE_BEGIN("OnCollisionEnter", collisionB.me->name);
-        collisionB.me->onCollisionEnter(collisionB.collision);
-        TRACE_END;
+        {
+            TRACE_ZONE_DETAIL("OnCollisionEnter", collisionA.me->name.str());
+            collisionA.me->onCollisionEnter(collisionA.collision);
+        }
+        {
+            TRACE_ZONE_DETAIL("OnCollisionEnter", collisionB.me->name.str());
+            collisionB.me->onCollisionEnter(collisionB.collision);
+        }
         break;
     case physics::CollisionKind::Trigger:
-        TRACE_BEGIN("OnTriggerEnter", collisionA.me->name);
-        collisionA.me->onTriggerEnter(collisionA.collision);
-        TRACE_END;
-        TRACE_BEGIN("OnTriggerEnter", collisionB.me->name);
-        collisionB.me->onTriggerEnter(collisionB.collision);
-        TRACE_END;
+        {
+            TRACE_ZONE_DETAIL("OnTriggerEnter", collisionA.me->name.str());
+            collisionA.me->onTriggerEnter(collisionA.collision);
+        }
+        {
+            TRACE_ZONE_DETAIL("OnTriggerEnter", collisionB.me->name.str());
+            collisionB.me->onTriggerEnter(collisionB.collision);
+        }
         break;
     }
 }
@@ -137,25 +177,30 @@ void Game::EndContact(b2Contact* contact) {
     const auto &[collisionA, collisionB, kind] = physics::CollisionFromContactExit(contact);
     switch (kind) {
     case physics::CollisionKind::Collider:
-        TRACE_BEGIN("OnCollisionExit", collisionA.me->name);
-        collisionA.me->onCollisionExit(collisionA.collision);
-        TRACE_END;
-        TRACE_BEGIN("OnCollisionExit", collisionB.me->name);
-        collisionB.me->onCollisionExit(collisionB.collision);
-        TRACE_END;
+        {
+            TRACE_ZONE_DETAIL("OnCollisionExit", collisionA.me->name.str());
+            collisionA.me->onCollisionExit(collisionA.collision);
+        }
+        {
+            TRACE_ZONE_DETAIL("OnCollisionExit", collisionB.me->name.str());
+            collisionB.me->onCollisionExit(collisionB.collision);
+        }
         break;
     case physics::CollisionKind::Trigger:
-        TRACE_BEGIN("OnTriggerExit", collisionA.me->name);
-        collisionA.me->onTriggerExit(collisionA.collision);
-        TRACE_END;
-        TRACE_BEGIN("OnTriggerExit", collisionB.me->name);
-        collisionB.me->onTriggerExit(collisionB.collision);
-        TRACE_END;
+        {
+            TRACE_ZONE_DETAIL("OnTriggerExit", collisionA.me->name.str());
+            collisionA.me->onTriggerExit(collisionA.collision);
+        }
+        {
+            TRACE_ZONE_DETAIL("OnTriggerExit", collisionB.me->name.str());
+            collisionB.me->onTriggerExit(collisionB.collision);
+        }
         break;
     }
 }
 
 void Game::loadScene(const std::string &name) {
+    TRACE_ZONE_DETAIL("Game.LoadScene", name);
     this->physicsWorld_->disableCollisionReporting();
 
     // Load scene from resources
@@ -194,6 +239,27 @@ scripting::EventSub &Game::eventSub() {
     return this->eventSub_;
 }
 
+const UpdateTimings &Game::lastUpdateTimings() const {
+    return this->lastUpdateTimings_;
+}
+
+unsigned int Game::lastPhysicsSteps() const {
+    return this->lastPhysicsSteps_;
+}
+
+std::chrono::nanoseconds Game::physicsStepDuration() const {
+    return this->physicsStepDuration_;
+}
+
+float Game::physicsAlpha() const {
+    return static_cast<float>(this->physicsAccumulator_.count()) /
+           static_cast<float>(this->physicsStepDuration_.count());
+}
+
+void Game::setFixedFrameTime(std::optional<std::chrono::microseconds> frameTime) {
+    this->fixedFrameTime_ = frameTime;
+}
+
 std::chrono::microseconds Game::tickDuration() const {
     return this->tickDuration_;
 }
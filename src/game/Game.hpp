@@ -10,12 +10,26 @@
 
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace sge::game {
 
 constexpr auto SixtyFPSFrameDuration = std::chrono::microseconds{16667};
 
+/**
+ * @brief Wall-clock time spent in each phase of a Game::update call.
+ */
+struct UpdateTimings {
+    std::chrono::nanoseconds onStart{};
+    std::chrono::nanoseconds onUpdate{};
+    std::chrono::nanoseconds onLateUpdate{};
+    std::chrono::nanoseconds pendingSubscriptions{};
+    std::chrono::nanoseconds insertInstantiatedActors{};
+    std::chrono::nanoseconds removeDestroyedActors{};
+    std::chrono::nanoseconds physicsStep{};
+};
+
 class Game : public b2ContactListener {
 public:
     Game(resources::GameConfig gameConfig);
@@ -31,6 +45,39 @@ public:
     render::RenderQueue &renderQueue();
     scripting::EventSub &eventSub();
 
+    /**
+     * @brief Phase timings of the most recent update() that had a scene to
+     * update.
+     */
+    const UpdateTimings &lastUpdateTimings() const;
+
+    /**
+     * @brief Number of fixed physics steps run by the most recent update().
+     */
+    unsigned int lastPhysicsSteps() const;
+
+    /**
+     * @brief Simulated time advanced by each physics step.
+     */
+    std::chrono::nanoseconds physicsStepDuration() const;
+
+    /**
+     * @brief How far the current frame is between the last physics step and
+     * the next one, in [0, 1). Rendering can blend between the previous and
+     * current physics state with this to hide the difference between the
+     * physics rate and the frame rate.
+     */
+    float physicsAlpha() const;
+
+    /**
+     * @brief Advance update() by a fixed frame time instead of the measured
+     * wall-clock time. Used to run headless simulations faster than real time.
+     *
+     * @param frameTime Time per update() call, or std::nullopt to measure
+     * wall-clock time again.
+     */
+    void setFixedFrameTime(std::optional<std::chrono::microseconds> frameTime);
+
     std::chrono::microseconds tickDuration() const;
     void setTickDuration(std::chrono::microseconds tickDuration);
 
@@ -54,6 +101,7 @@ private:
     void updateOnStart();
     void updateOnUpdate(float dt);
     void updateOnLateUpdate(float dt);
+    void updatePhysics(std::chrono::microseconds dt);
 
     resources::GameConfig gameConfig_;
 
@@ -68,6 +116,15 @@ private:
     std::chrono::time_point<std::chrono::high_resolution_clock> lastFrame_{};
     bool lastFrameValid_{false};
     std::chrono::microseconds tickDuration_{SixtyFPSFrameDuration};
+    std::optional<std::chrono::microseconds> fixedFrameTime_{};
+    UpdateTimings lastUpdateTimings_{};
+
+    // Fixed-timestep physics. Frame time is accumulated and consumed in whole
+    // physics steps; the remainder carries over to the next frame.
+    std::chrono::nanoseconds physicsStepDuration_;
+    float physicsStepSeconds_;
+    std::chrono::nanoseconds physicsAccumulator_{0};
+    unsigned int lastPhysicsSteps_{0};
 
     glm::vec2 cameraPos_{0.0F, 0.0F};
     float zoom_{1.0F};
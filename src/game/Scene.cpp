@@ -1,25 +1,81 @@
 #include "game/Scene.hpp"
 
+#include <dnsge/HashMap.hpp>
 #include <glm/glm.hpp>
 
+#include "Common.hpp"
 #include "Realm.hpp"
 #include "Types.hpp"
 #include "game/Actor.hpp"
+#include "game/ActorPool.hpp"
 #include "resources/Resources.hpp"
+#include "scripting/ActorTemplate.hpp"
+#include "scripting/Component.hpp"
+#include "scripting/Invoke.hpp"
+#include "scripting/LuaCall.hpp"
+#include "scripting/Profiler.hpp"
+#include "scripting/Scripting.hpp"
+#include "scripting/TemplatePool.hpp"
+#include "scripting/components/TransformPool.hpp"
+#include "util/Arena.hpp"
+#include "util/JobSystem.hpp"
+#include "util/Symbol.hpp"
+#include "util/Trace.hpp"
 
 #include <algorithm>
-#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 namespace sge::game {
 
+namespace {
+
+// Parallel OnUpdate handlers run in chunks of this many components, so each
+// job does enough work to be worth handing to a worker
+constexpr std::size_t ParallelUpdateGrain = 64;
+
+bool handlerCanRun(const Actor* actor, const scripting::Component* component) {
+    return actor->runLifecycleFunctions() && component->lifecycleCanRunUnderActor() &&
+           component->getEnabled();
+}
+
+template <typename Handlers, typename F>
+void dispatchLifecycle(const Handlers &handlers, scripting::Lifecycle lifecycle,
+                       const char* lifecycleName, float dt, F &&f) {
+    // Lua functions are called directly, sharing one message handler
+    scripting::ProtectedCall call{scripting::GetGlobalState()};
+    // Index rather than iterate, in case a handler is registered mid-dispatch
+    for (std::size_t i = 0; i < handlers.size(); ++i) {
+        auto [actor, component] = handlers[i];
+        if (!handlerCanRun(actor, component)) {
+            continue;
+        }
+        TRACE_ZONE_DETAIL(lifecycleName, actor->getName());
+        if (const auto* function = component->luaFunction(lifecycle)) {
+            scripting::ProfileZone zone{*component, lifecycleName};
+            call.callMethod(*function, component->ref(), dt, actor->name.str());
+            continue;
+        }
+        scripting::ActorInvoke(actor->name.str(), [&]() {
+            f(component);
+        });
+    }
+}
+
+} // namespace
+
 Scene::Scene(const resources::SceneDescription &source)
-    : name_(source.name) {
+    : name_(source.name)
+    , arena_(std::make_unique<util::Arena>())
+    , transformPool_(std::make_unique<scripting::TransformPool>()) {
     for (const auto &description : source.actors) {
         this->instantiateActor(false, description, std::nullopt);
     }
@@ -28,28 +84,66 @@ Scene::Scene(const resources::SceneDescription &source)
 
 Scene::Scene(const resources::SceneDescription &source, Scene &oldScene)
     : name_(source.name)
+    // The persistent actors' components live in the old scene's arena
+    , arena_(std::move(oldScene.arena_))
+    , transformPool_(std::move(oldScene.transformPool_))
+    , templatePool_(std::move(oldScene.templatePool_))
     , nextActorId_(oldScene.nextActorId_) {
-    // Copy any persistent existing actors
-    for (auto &oldActor : oldScene.actors_) {
-        if (oldActor->persistent) {
-            this->actorIDMap_.emplace(oldActor->id, oldActor.get());
-            this->actors_.emplace_back(std::move(oldActor));
-        } else {
+    oldScene.flushRemovedComponents();
+
+    // Run OnDestroy for the actors that don't carry over while the old scene is
+    // still intact
+    for (auto* oldActor : oldScene.actors_) {
+        if (!oldActor->persistent) {
             oldActor->onDestroy();
         }
     }
-    oldScene.actors_.clear();
-    oldScene.actorIDMap_.clear();
 
-    // Copy any pending persistent actors
-    for (auto &oldActor : oldScene.pendingInstantiatedActors_) {
-        if (oldActor->persistent) {
-            this->actorIDMap_.emplace(oldActor->id, oldActor.get());
-            this->actors_.emplace_back(std::move(oldActor));
+    // Take over the old scene's actors. They stay in their slots, so pointers
+    // and handles to persistent actors remain valid.
+    this->actors_ = std::move(oldScene.actors_);
+    this->actorsByName_ = std::move(oldScene.actorsByName_);
+    for (auto it = this->actorsByName_.begin(); it != this->actorsByName_.end();) {
+        auto &bucket = it->second;
+        std::erase_if(bucket.actors, [](const Actor* actor) {
+            return !actor->persistent || actor->destroyed();
+        });
+        bucket.stale = false;
+        it = bucket.actors.empty() ? this->actorsByName_.erase(it) : std::next(it);
+    }
+
+    std::vector<Actor*> dropped;
+    for (auto* actor : this->actors_) {
+        if (actor->persistent) {
+            this->actorIDMap_.insert({actor->id, actor});
+            this->registerStartedHandlers(actor);
+            this->pendingStartActors_.push_back(actor);
+        } else {
+            dropped.push_back(actor);
+        }
+    }
+
+    // Carry over any pending persistent actors
+    for (auto* actor : oldScene.pendingInstantiatedActors_) {
+        if (actor->persistent) {
+            this->actorIDMap_.insert({actor->id, actor});
+            this->pendingStartActors_.push_back(actor);
+            this->actors_.activate(actor);
+        } else {
+            dropped.push_back(actor);
         }
     }
     oldScene.pendingInstantiatedActors_.clear();
 
+    for (auto* actor : dropped) {
+        this->actors_.destroy(actor);
+    }
+
+    // Persistent actors destroyed before the load are still removed. Handles
+    // of dropped actors are stale by now and get skipped.
+    this->destroyedActors_ = std::move(oldScene.destroyedActors_);
+    oldScene.clear();
+
     // Proceed with standard instantiation of new actors for scene
     for (const auto &description : source.actors) {
         this->instantiateActor(false, description, std::nullopt);
@@ -58,18 +152,38 @@ Scene::Scene(const resources::SceneDescription &source, Scene &oldScene)
 }
 
 void Scene::clear() {
+    this->pendingStartActors_.clear();
+    this->onUpdateHandlers_.clear();
+    this->parallelUpdateHandlers_.clear();
+    this->onLateUpdateHandlers_.clear();
+    this->pendingComponentRemovals_.clear();
     this->actorIDMap_.clear();
     this->remoteActorIDMap_.clear();
-    this->actors_.clear();
+    this->actorsByName_.clear();
+    this->staleActorNames_.clear();
+    this->destroyedActors_.clear();
     this->pendingInstantiatedActors_.clear();
+    this->actors_.clear();
 }
 
-std::vector<std::unique_ptr<Actor>> &Scene::actors() {
+const ActorPool &Scene::actors() const {
     return this->actors_;
 }
 
-const std::vector<std::unique_ptr<Actor>> &Scene::actors() const {
-    return this->actors_;
+util::Arena &Scene::arena() {
+    return *this->arena_;
+}
+
+const util::Arena &Scene::arena() const {
+    return *this->arena_;
+}
+
+const scripting::TemplatePool &Scene::templatePool() const {
+    return this->templatePool_;
+}
+
+scripting::TransformPool &Scene::transformPool() {
+    return *this->transformPool_;
 }
 
 const std::string &Scene::name() const {
@@ -78,16 +192,19 @@ const std::string &Scene::name() const {
 
 Actor* Scene::instantiateActor(bool runtime, const sge::resources::ActorDescription &source,
                                std::optional<client_id_t> ownerClient) {
-    // 1. Create new actor instance
-    this->pendingInstantiatedActors_.emplace_back(
-        std::make_unique<Actor>(this->nextActorId_++, runtime, source));
-    auto* newActor = this->pendingInstantiatedActors_.back().get();
+    // 1. Create new actor instance, with its components in the scene's arena
+    util::ArenaScope arenaScope{this->arena_.get()};
+    scripting::TransformPoolScope transformPoolScope{this->transformPool_.get()};
+    auto* newActor =
+        this->actors_.create(this->nextActorId_++, runtime, source, this->templatePool_);
+    this->pendingInstantiatedActors_.push_back(newActor);
 
     // Set owner client
     newActor->ownerClient = ownerClient;
 
-    // Update local actor id mapping
-    this->actorIDMap_.emplace(newActor->id, newActor);
+    // Update local actor id and name mappings
+    this->actorIDMap_.insert({newActor->id, newActor});
+    this->indexActorName(newActor);
 
     // If this is a non-runtime actor (i.e. defined in a scene file), we know
     // the local actor id and remote actor id are the same. Register the id.
@@ -105,78 +222,314 @@ Actor* Scene::instantiateActor(bool runtime, const sge::resources::ActorDescript
 Actor* Scene::instantiateRuntimeActor(std::string_view templateName,
                                       std::optional<client_id_t> ownerClient) {
     auto source = resources::ActorDescription{
-        std::string{templateName}, // template name
-        std::nullopt,              // actor name
-        {}                         // components
+        util::Intern(templateName), // template name
+        std::nullopt,               // actor name
+        {}                          // components
     };
     return this->instantiateActor(true, source, ownerClient);
 }
 
 void Scene::removeDestroyedActors() {
-    auto it = std::remove_if(
-        this->actors_.begin(), this->actors_.end(), [&](const std::unique_ptr<Actor> &a) {
-            assert(a != nullptr);
-            if (!a->destroyed()) {
-                return false;
+    this->flushRemovedComponents();
+
+    std::vector<ActorHandle> notInserted;
+    std::vector<Actor*> removed;
+    // OnDestroy may destroy more actors, so repeat until the queue stays empty
+    while (!this->destroyedActors_.empty()) {
+        removed.clear();
+        for (auto handle : std::exchange(this->destroyedActors_, {})) {
+            auto* actor = this->actors_.get(handle);
+            if (actor == nullptr) {
+                // Already deleted by a scene load
+                continue;
+            }
+            if (!this->actors_.active(actor)) {
+                // Remove it once it has been inserted
+                notInserted.push_back(handle);
+                continue;
             }
+            removed.push_back(actor);
+        }
+        if (removed.empty()) {
+            break;
+        }
+
+        // Forget the destroyed actors' handlers while the actors are still alive
+        this->dropDestroyedActors();
 
-            // Run OnDestroy lifecycle
-            a->onDestroy();
+        // Run OnDestroy lifecycle
+        for (auto* actor : removed) {
+            actor->onDestroy();
+        }
 
+        for (auto* actor : removed) {
             // First, update any state we need to maintain to no longer contain
             // the actor we are removing.
-            this->actorIDMap_.erase(a->id);
-            if (a->remoteID.has_value()) {
-                this->remoteActorIDMap_.erase(*a->remoteID);
+            this->actorIDMap_.erase(actor->id);
+            if (actor->remoteID.has_value()) {
+                this->remoteActorIDMap_.erase(*actor->remoteID);
+            }
+            if (actor->runtime()) {
+                const auto &actorTemplate =
+                    scripting::GetActorTemplateInstance(actor->runtimeTemplate());
+                if (actorTemplate.pooled()) {
+                    this->templatePool_.recycle(actorTemplate, actor->components);
+                }
             }
+            this->actors_.destroy(actor);
+        }
+    }
 
-            return true;
-        });
-    this->actors_.erase(it, this->actors_.end());
+    this->destroyedActors_.insert(
+        this->destroyedActors_.end(), notInserted.begin(), notInserted.end());
 }
 
 void Scene::insertInstantiatedActors() {
-    for (auto &ptr : this->pendingInstantiatedActors_) {
-        this->actors_.emplace_back(std::move(ptr));
+    for (auto* actor : this->pendingInstantiatedActors_) {
+        this->pendingStartActors_.push_back(actor);
+        this->actors_.activate(actor);
     }
     this->pendingInstantiatedActors_.clear();
 }
 
-Actor* Scene::findActor(std::string_view name) {
-    auto nameCompare = [&](const auto &a) -> bool {
-        return a->name == name && !a->destroyed();
+void Scene::removeActorLater(Actor* actor) {
+    // Destroyed actors can no longer be found by name
+    this->unindexActorName(actor);
+    this->destroyedActors_.push_back(actor->handle);
+}
+
+Actor* Scene::resolveActor(ActorHandle handle) const {
+    return this->actors_.get(handle);
+}
+
+void Scene::runOnStart() {
+    std::vector<Actor*> notStarted;
+    std::vector<scripting::Component*> started;
+
+    // Index rather than iterate, since starting an actor may queue others
+    for (std::size_t i = 0; i < this->pendingStartActors_.size(); ++i) {
+        auto* actor = this->pendingStartActors_[i];
+        if (actor->lifecycleState == ActorLifecycleState::Uninitialized) {
+            actor->lifecycleState = ActorLifecycleState::Alive;
+        }
+
+        // Nothing iterates the actor's components between starting actors
+        actor->components.addDeferred();
+
+        started.clear();
+        bool allStarted = false;
+        {
+            TRACE_ZONE_DETAIL("OnStart", actor->getName());
+            allStarted = actor->onStart(started);
+        }
+        for (auto* component : started) {
+            this->registerHandlers(actor, component);
+        }
+        if (!allStarted) {
+            // Try the remaining components again next frame
+            notStarted.push_back(actor);
+        }
+    }
+
+    std::sort(notStarted.begin(), notStarted.end());
+    notStarted.erase(std::unique(notStarted.begin(), notStarted.end()), notStarted.end());
+    this->pendingStartActors_ = std::move(notStarted);
+
+    this->flushRemovedComponents();
+}
+
+void Scene::runOnUpdate(float dt) {
+    if (CurrentRealm() == GeneralRealm::Client) {
+        // Move every InterpTransform before any script sees it this frame
+        TRACE_ZONE("InterpTransform");
+        this->transformPool_->interpolate(std::chrono::steady_clock::now(),
+                                          CurrentGame().tickDuration());
+    }
+    this->runParallelUpdate(dt);
+    dispatchLifecycle(this->onUpdateHandlers_, scripting::Lifecycle::OnUpdate, "OnUpdate", dt,
+                      [dt](scripting::Component* c) {
+                          c->onUpdate(dt);
+                      });
+    this->flushRemovedComponents();
+}
+
+void Scene::runParallelUpdate(float dt) {
+    // Decide what runs here, since the checks read thread-local game state
+    this->parallelUpdateBatch_.clear();
+    for (auto [actor, component] : this->parallelUpdateHandlers_) {
+        if (handlerCanRun(actor, component)) {
+            this->parallelUpdateBatch_.push_back(component);
+        }
+    }
+
+    TRACE_ZONE("ParallelOnUpdate");
+    const auto &batch = this->parallelUpdateBatch_;
+    util::Jobs().parallelFor(
+        batch.size(), ParallelUpdateGrain, [&batch, dt](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                batch[i]->onUpdate(dt);
+            }
+        });
+}
+
+void Scene::runOnLateUpdate(float dt) {
+    dispatchLifecycle(this->onLateUpdateHandlers_, scripting::Lifecycle::OnLateUpdate,
+                      "OnLateUpdate", dt, [dt](scripting::Component* c) {
+                          c->onLateUpdate(dt);
+                      });
+    this->flushRemovedComponents();
+}
+
+void Scene::startActorLater(Actor* actor) {
+    if (actor->lifecycleState == ActorLifecycleState::Uninitialized) {
+        // Already queued, or will be once inserted
+        return;
+    }
+    this->pendingStartActors_.push_back(actor);
+}
+
+void Scene::removeComponentLater(Actor* actor, scripting::Component* component) {
+    component->setEnabled(false);
+    actor->components.removeComponentLater(component);
+    this->pendingComponentRemovals_.push_back(actor);
+}
+
+void Scene::flushRemovedComponents() {
+    if (this->pendingComponentRemovals_.empty()) {
+        return;
+    }
+
+    std::unordered_set<scripting::Component*> removed;
+    for (auto* actor : this->pendingComponentRemovals_) {
+        const auto &pending = actor->components.pendingRemoval();
+        removed.insert(pending.begin(), pending.end());
+    }
+    auto isRemoved = [&removed](const LifecycleHandler &handler) {
+        return removed.contains(handler.component);
     };
+    std::erase_if(this->onUpdateHandlers_, isRemoved);
+    std::erase_if(this->parallelUpdateHandlers_, isRemoved);
+    std::erase_if(this->onLateUpdateHandlers_, isRemoved);
 
-    // Check existing actors
-    auto it = std::find_if(this->actors_.begin(), this->actors_.end(), nameCompare);
-    if (it != this->actors_.end()) {
-        return it->get();
+    for (auto* actor : this->pendingComponentRemovals_) {
+        actor->components.removeDeferred();
     }
+    this->pendingComponentRemovals_.clear();
+}
 
-    // Check pending instantiation actors
-    it = std::find_if(this->pendingInstantiatedActors_.begin(),
-                      this->pendingInstantiatedActors_.end(),
-                      nameCompare);
-    if (it != this->pendingInstantiatedActors_.end()) {
-        return it->get();
+void Scene::registerHandlers(Actor* actor, scripting::Component* component) {
+    if (!component->realmMatches()) {
+        // Never runs in this realm
+        return;
     }
 
-    return nullptr;
+    using scripting::Lifecycle;
+    using scripting::LifecycleBit;
+    auto handlers = component->lifecycleHandlers();
+    if ((handlers & LifecycleBit(Lifecycle::OnUpdate)) != 0) {
+        auto &updateHandlers = component->parallelUpdate() ? this->parallelUpdateHandlers_
+                                                           : this->onUpdateHandlers_;
+        updateHandlers.push_back(LifecycleHandler{actor, component});
+    }
+    if ((handlers & LifecycleBit(Lifecycle::OnLateUpdate)) != 0) {
+        this->onLateUpdateHandlers_.push_back(LifecycleHandler{actor, component});
+    }
 }
 
-std::vector<Actor*> Scene::findAllActors(std::string_view name) {
-    std::vector<Actor*> results;
-    for (auto &actor : this->actors_) {
-        if (actor->name == name && !actor->destroyed()) {
-            results.push_back(actor.get());
+void Scene::registerStartedHandlers(Actor* actor) {
+    for (auto &entry : actor->components) {
+        if (entry.component->initialized()) {
+            this->registerHandlers(actor, entry.component.get());
         }
     }
-    for (auto &actor : this->pendingInstantiatedActors_) {
-        if (actor->name == name && !actor->destroyed()) {
-            results.push_back(actor.get());
+}
+
+void Scene::dropDestroyedActors() {
+    auto isDestroyed = [](const LifecycleHandler &handler) {
+        return handler.actor->destroyed();
+    };
+    std::erase_if(this->onUpdateHandlers_, isDestroyed);
+    std::erase_if(this->parallelUpdateHandlers_, isDestroyed);
+    std::erase_if(this->onLateUpdateHandlers_, isDestroyed);
+    std::erase_if(this->pendingStartActors_, [](const Actor* actor) {
+        return actor->destroyed();
+    });
+    // Before the actors are deleted, so no bucket points at a deleted actor
+    this->dropStaleActorNames();
+}
+
+void Scene::NameBucket::dropDestroyed() {
+    // Keep the remaining actors in instantiation order
+    std::erase_if(this->actors, [](const Actor* actor) {
+        return actor->destroyed();
+    });
+    this->stale = false;
+}
+
+void Scene::indexActorName(Actor* actor) {
+    this->actorsByName_[actor->name].actors.push_back(actor);
+}
+
+void Scene::unindexActorName(Actor* actor) {
+    // Erasing from the bucket now would shift the rest of it for every
+    // destroyed actor, so only note that the bucket has destroyed actors
+    auto it = this->actorsByName_.find(actor->name);
+    if (it == this->actorsByName_.end() || it->second.stale) {
+        return;
+    }
+    it->second.stale = true;
+    this->staleActorNames_.push_back(actor->name);
+}
+
+void Scene::dropStaleActorNames() {
+    for (const auto &name : this->staleActorNames_) {
+        auto it = this->actorsByName_.find(name);
+        if (it == this->actorsByName_.end()) {
+            continue;
+        }
+        it->second.dropDestroyed();
+        if (it->second.actors.empty()) {
+            this->actorsByName_.erase(it);
+        }
+    }
+    this->staleActorNames_.clear();
+}
+
+Actor* Scene::findActor(std::string_view name) const {
+    // A name that was never interned can't belong to an actor
+    auto symbol = util::FindSymbol(name);
+    if (!symbol.has_value()) {
+        return nullptr;
+    }
+    auto it = this->actorsByName_.find(*symbol);
+    if (it == this->actorsByName_.end()) {
+        return nullptr;
+    }
+    for (auto* actor : it->second.actors) {
+        if (!actor->destroyed()) {
+            return actor;
         }
     }
-    return results;
+    return nullptr;
+}
+
+const std::vector<Actor*> &Scene::findAllActors(std::string_view name) {
+    static const std::vector<Actor*> noActors{};
+    auto symbol = util::FindSymbol(name);
+    if (!symbol.has_value()) {
+        return noActors;
+    }
+    auto it = this->actorsByName_.find(*symbol);
+    if (it == this->actorsByName_.end()) {
+        return noActors;
+    }
+    auto &bucket = it->second;
+    if (bucket.stale) {
+        // The name stays in staleActorNames_, so the bucket is still erased at
+        // the end of the frame if this emptied it
+        bucket.dropDestroyed();
+    }
+    return bucket.actors;
 }
 
 Actor* Scene::findActorByID(actor_id_t id) {
@@ -188,6 +541,11 @@ Actor* Scene::findActorByID(actor_id_t id) {
 }
 
 Actor* Scene::findActorByRemoteID(actor_id_t remoteID) {
+    if (CurrentRealm() == GeneralRealm::Server) {
+        // Remote ids are local ids on the server
+        return this->findActorByID(remoteID);
+    }
+
     auto it = this->remoteActorIDMap_.find(remoteID);
     if (it == this->remoteActorIDMap_.end()) {
         return nullptr;
@@ -196,6 +554,12 @@ Actor* Scene::findActorByRemoteID(actor_id_t remoteID) {
 }
 
 void Scene::registerActorRemoteID(Actor* actor, actor_id_t remoteID) {
+    if (CurrentRealm() == GeneralRealm::Server) {
+        // Looked up through actorIDMap_ instead
+        actor->remoteID.emplace(remoteID);
+        return;
+    }
+
     if (actor->remoteID.has_value()) {
         // Remove old mapping of remote id
         this->remoteActorIDMap_.erase(*actor->remoteID);
@@ -204,7 +568,7 @@ void Scene::registerActorRemoteID(Actor* actor, actor_id_t remoteID) {
     // Update actor remoteID field
     actor->remoteID.emplace(remoteID);
     // Store mapping for later lookup
-    this->remoteActorIDMap_.emplace(remoteID, actor);
+    this->remoteActorIDMap_.insert({remoteID, actor});
 }
 
 } // namespace sge::game
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <dnsge/HashMap.hpp>
 #include <glm/glm.hpp>
 
 #include "Types.hpp"
 #include "game/Actor.hpp"
+#include "game/ActorPool.hpp"
 #include "resources/Resources.hpp"
+#include "scripting/TemplatePool.hpp"
+#include "scripting/components/TransformPool.hpp"
+#include "util/Arena.hpp"
+#include "util/Symbol.hpp"
 
 #include <memory>
 #include <optional>
@@ -22,30 +28,150 @@ public:
 
     void clear();
 
-    std::vector<std::unique_ptr<Actor>> &actors();
-    const std::vector<std::unique_ptr<Actor>> &actors() const;
+    /**
+     * @brief Actors inserted into the scene, excluding those instantiated
+     * since the last insertInstantiatedActors.
+     */
+    const ActorPool &actors() const;
+    util::Arena &arena();
+    const util::Arena &arena() const;
+    const scripting::TemplatePool &templatePool() const;
+    scripting::TransformPool &transformPool();
     const std::string &name() const;
 
     Actor* instantiateActor(bool runtime, const sge::resources::ActorDescription &source,
                             std::optional<client_id_t> ownerClient);
     Actor* instantiateRuntimeActor(std::string_view templateName,
                                    std::optional<client_id_t> ownerClient);
+    /**
+     * @brief Run OnDestroy for and delete the actors passed to
+     * removeActorLater.
+     */
     void removeDestroyedActors();
     void insertInstantiatedActors();
 
-    Actor* findActor(std::string_view name);
-    std::vector<Actor*> findAllActors(std::string_view name);
+    /**
+     * @brief Queue a destroyed actor for the next removeDestroyedActors.
+     */
+    void removeActorLater(Actor* actor);
+
+    /**
+     * @brief Get the actor a handle refers to, including actors that haven't
+     * been inserted yet, or nullptr if the handle is stale.
+     */
+    Actor* resolveActor(ActorHandle handle) const;
+
+    /**
+     * @brief Start the actors inserted since the last call and any components
+     * added to existing actors.
+     */
+    void runOnStart();
+    /**
+     * @brief Interpolate transforms, then run the OnUpdate of parallel-safe
+     * engine components on the job system, then every other OnUpdate in order.
+     */
+    void runOnUpdate(float dt);
+    void runOnLateUpdate(float dt);
+
+    /**
+     * @brief Queue an actor for the next runOnStart, e.g. after adding a
+     * component to it.
+     */
+    void startActorLater(Actor* actor);
+
+    /**
+     * @brief Disable a component and delete it at the next
+     * flushRemovedComponents.
+     */
+    void removeComponentLater(Actor* actor, scripting::Component* component);
+
+    /**
+     * @brief Delete the components passed to removeComponentLater. Must not be
+     * called while lifecycle functions are being dispatched.
+     */
+    void flushRemovedComponents();
+
+    /**
+     * @brief Get the oldest actor with a name that hasn't been destroyed. O(1),
+     * besides skipping actors of the name destroyed this frame.
+     */
+    Actor* findActor(std::string_view name) const;
+
+    /**
+     * @brief Get every actor with a name that hasn't been destroyed, oldest
+     * first. The result is only valid until actors are instantiated or
+     * destroyed.
+     */
+    const std::vector<Actor*> &findAllActors(std::string_view name);
 
     Actor* findActorByID(actor_id_t id);
     Actor* findActorByRemoteID(actor_id_t remoteID);
     void registerActorRemoteID(Actor* actor, actor_id_t remoteID);
 
 private:
+    /**
+     * @brief A started component that implements a lifecycle function.
+     */
+    struct LifecycleHandler {
+        Actor* actor;
+        scripting::Component* component;
+    };
+
+    void runParallelUpdate(float dt);
+    void registerHandlers(Actor* actor, scripting::Component* component);
+    void registerStartedHandlers(Actor* actor);
+    void dropDestroyedActors();
+    void indexActorName(Actor* actor);
+    void unindexActorName(Actor* actor);
+    void dropStaleActorNames();
+
     std::string name_;
-    std::vector<std::unique_ptr<Actor>> actors_;
-    std::vector<std::unique_ptr<Actor>> pendingInstantiatedActors_;
-    std::unordered_map<actor_id_t, Actor*> actorIDMap_;
-    std::unordered_map<actor_id_t, Actor*> remoteActorIDMap_;
+    // Engine components of the actors are allocated from here. Declared before
+    // the actors so that it outlives them, and boxed so that it can be handed
+    // to the next scene along with persistent actors.
+    std::unique_ptr<util::Arena> arena_;
+    // Values of the Transform and InterpTransform components of the actors.
+    // Handed to the next scene like the arena.
+    std::unique_ptr<scripting::TransformPool> transformPool_;
+    // Recycled components of pooled templates. Some are in the arena, so this
+    // is declared after it.
+    scripting::TemplatePool templatePool_;
+    // Owns every actor of the scene, including pending ones
+    ActorPool actors_;
+    std::vector<Actor*> pendingInstantiatedActors_;
+    // Handles rather than pointers, since a scene load may delete queued
+    // actors before they are removed
+    std::vector<ActorHandle> destroyedActors_;
+    dnsge::HashMap<actor_id_t, Actor*> actorIDMap_;
+    // Only used on the client. On the server, remote ids are local ids.
+    dnsge::HashMap<actor_id_t, Actor*> remoteActorIDMap_;
+    /**
+     * @brief Actors with a name, in instantiation order. Destroyed actors are
+     * dropped in one pass per frame rather than one at a time, so until then a
+     * stale bucket also holds actors destroyed this frame.
+     */
+    struct NameBucket {
+        std::vector<Actor*> actors;
+        bool stale{false};
+
+        void dropDestroyed();
+    };
+
+    std::unordered_map<util::Symbol, NameBucket> actorsByName_;
+    // Names whose buckets are stale
+    std::vector<util::Symbol> staleActorNames_;
+
+    // Lifecycle dispatch lists. Only components that implement a lifecycle
+    // function are visited for it, so the cost of a frame follows the number
+    // of handlers rather than the number of actors and components.
+    std::vector<Actor*> pendingStartActors_;
+    std::vector<LifecycleHandler> onUpdateHandlers_;
+    // OnUpdate handlers of components with parallelUpdate, and those of them
+    // that run this frame
+    std::vector<LifecycleHandler> parallelUpdateHandlers_;
+    std::vector<scripting::Component*> parallelUpdateBatch_;
+    std::vector<LifecycleHandler> onLateUpdateHandlers_;
+    std::vector<Actor*> pendingComponentRemovals_;
 
     actor_id_t nextActorId_{0};
 };
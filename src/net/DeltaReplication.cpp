@@ -0,0 +1,185 @@
+#include "net/DeltaReplication.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace sge::net {
+
+namespace {
+
+// Largest state a delta may claim to rebuild, so that a corrupt size can't
+// allocate arbitrary memory
+constexpr std::size_t MaxDeltaStateSize = 16 * 1024 * 1024;
+
+// A delta is the state size, followed by (unchanged run, changed run, XORed
+// bytes of the changed run) triples covering the state. Sizes are varints.
+
+void writeVarint(std::vector<char> &out, std::size_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+std::optional<std::size_t> readVarint(std::span<const char> data, std::size_t &offset) {
+    std::size_t v = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        if (offset >= data.size()) {
+            return std::nullopt;
+        }
+        auto byte = static_cast<std::uint8_t>(data[offset++]);
+        v |= static_cast<std::size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return v;
+        }
+    }
+    return std::nullopt;
+}
+
+char baselineByte(std::span<const char> baseline, std::size_t i) {
+    return i < baseline.size() ? baseline[i] : char{0};
+}
+
+} // namespace
+
+std::optional<std::vector<char>> EncodeDelta(std::span<const char> baseline,
+                                             std::span<const char> state) {
+    std::vector<char> delta;
+    delta.reserve(state.size());
+    writeVarint(delta, state.size());
+
+    std::size_t i = 0;
+    while (i < state.size()) {
+        auto unchangedStart = i;
+        while (i < state.size() && state[i] == baselineByte(baseline, i)) {
+            ++i;
+        }
+        auto changedStart = i;
+        while (i < state.size() && state[i] != baselineByte(baseline, i)) {
+            ++i;
+        }
+        writeVarint(delta, changedStart - unchangedStart);
+        writeVarint(delta, i - changedStart);
+        for (auto j = changedStart; j < i; ++j) {
+            delta.push_back(static_cast<char>(state[j] ^ baselineByte(baseline, j)));
+        }
+        if (delta.size() >= state.size()) {
+            return std::nullopt;
+        }
+    }
+    if (delta.size() >= state.size()) {
+        return std::nullopt;
+    }
+    return delta;
+}
+
+std::optional<std::vector<char>> ApplyDelta(std::span<const char> baseline,
+                                            std::span<const char> delta) {
+    std::size_t offset = 0;
+    auto size = readVarint(delta, offset);
+    if (!size.has_value() || *size > MaxDeltaStateSize) {
+        return std::nullopt;
+    }
+
+    std::vector<char> state(*size);
+    std::size_t i = 0;
+    while (i < state.size()) {
+        auto unchanged = readVarint(delta, offset);
+        auto changed = readVarint(delta, offset);
+        if (!unchanged.has_value() || !changed.has_value() || *unchanged > state.size() - i ||
+            *changed > state.size() - i - *unchanged || *changed > delta.size() - offset) {
+            return std::nullopt;
+        }
+        for (auto end = i + *unchanged; i < end; ++i) {
+            state[i] = baselineByte(baseline, i);
+        }
+        for (auto end = i + *changed; i < end; ++i) {
+            state[i] = static_cast<char>(delta[offset++] ^ baselineByte(baseline, i));
+        }
+    }
+    if (offset != delta.size()) {
+        return std::nullopt;
+    }
+    return state;
+}
+
+ComponentReplication ReplicationBaselines::encode(const ComponentReplication &replication) {
+    auto* baseline = this->find(replication);
+    if (baseline != nullptr) {
+        if (auto delta = EncodeDelta(*baseline, replication.packed)) {
+            // The replication is about to be sent, so the state becomes the baseline
+            baseline->assign(replication.packed.begin(), replication.packed.end());
+            ComponentReplication encoded{replication.actorID, replication.componentKey,
+                                         *std::move(delta)};
+            encoded.delta = true;
+            return encoded;
+        }
+    }
+    this->store(replication);
+    return ComponentReplication{replication.actorID, replication.componentKey,
+                                std::vector<char>{replication.packed}};
+}
+
+bool ReplicationBaselines::decode(ComponentReplication &replication) {
+    if (replication.delta) {
+        auto* baseline = this->find(replication);
+        if (baseline == nullptr) {
+            return false;
+        }
+        auto state = ApplyDelta(*baseline, replication.packed);
+        if (!state.has_value()) {
+            return false;
+        }
+        replication.packed = *std::move(state);
+        replication.delta = false;
+        *baseline = replication.packed;
+        return true;
+    }
+    this->store(replication);
+    return true;
+}
+
+void ReplicationBaselines::record(const std::vector<ComponentReplication> &replications) {
+    for (const auto &replication : replications) {
+        if (!replication.delta) {
+            this->store(replication);
+        }
+    }
+}
+
+void ReplicationBaselines::erase(actor_id_t actorID) {
+    this->baselines_.erase(actorID);
+}
+
+void ReplicationBaselines::clear() {
+    this->baselines_.clear();
+}
+
+std::vector<char>* ReplicationBaselines::find(const ComponentReplication &replication) {
+    auto actorIt = this->baselines_.find(replication.actorID);
+    if (actorIt == this->baselines_.end()) {
+        return nullptr;
+    }
+    auto it = actorIt->second.find(replication.componentKey);
+    if (it == actorIt->second.end()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+void ReplicationBaselines::store(const ComponentReplication &replication) {
+    auto &states = this->baselines_[replication.actorID];
+    auto it = states.find(replication.componentKey);
+    if (it == states.end()) {
+        states.emplace(replication.componentKey, replication.packed);
+    } else {
+        it->second = replication.packed;
+    }
+}
+
+} // namespace sge::net
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Types.hpp"
+#include "net/Replicator.hpp"
+#include "util/HeterogeneousLookup.hpp"
+
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace sge::net {
+
+/**
+ * @brief Encode a packed component state as the XOR of it with a baseline,
+ * with the runs of unchanged bytes left out. A baseline shorter than the state
+ * is treated as padded with zero bytes.
+ *
+ * @return The delta, or nothing if it wouldn't be smaller than the state.
+ */
+std::optional<std::vector<char>> EncodeDelta(std::span<const char> baseline,
+                                             std::span<const char> state);
+
+/**
+ * @brief Rebuild a packed component state from its baseline and a delta made
+ * by EncodeDelta.
+ *
+ * @return The state, or nothing if the delta is malformed.
+ */
+std::optional<std::vector<char>> ApplyDelta(std::span<const char> baseline,
+                                            std::span<const char> delta);
+
+/**
+ * @brief The last state of each replicated component exchanged with one peer.
+ *
+ * The server keeps one per joined client and sends each ComponentReplication
+ * as a delta against what it last sent that client, and the client keeps one
+ * to turn those deltas back into full states. Messages are delivered in order
+ * over a single connection, so both ends always agree on the baseline without
+ * acknowledging every state. Both ends drop their baselines when a scene is
+ * loaded, and a state without a baseline is sent in full. If the client still
+ * gets a delta it can't apply, it asks for a resync, after which both ends
+ * drop their baselines again.
+ */
+class ReplicationBaselines {
+public:
+    /**
+     * @brief Make the replication to send for a full one: a delta against the
+     * baseline if that is smaller, otherwise a copy. Its state becomes the new
+     * baseline.
+     */
+    ComponentReplication encode(const ComponentReplication &replication);
+
+    /**
+     * @brief Turn a received replication into a full one, and make its state
+     * the new baseline.
+     *
+     * @return false if the replication is a delta that can't be applied, in
+     * which case it is left as is.
+     */
+    bool decode(ComponentReplication &replication);
+
+    /**
+     * @brief Make the states of full replications the baselines, e.g. the scene
+     * state sent to a client that just joined.
+     */
+    void record(const std::vector<ComponentReplication> &replications);
+
+    /**
+     * @brief Forget the baselines of a destroyed actor.
+     */
+    void erase(actor_id_t actorID);
+    void clear();
+
+private:
+    std::vector<char>* find(const ComponentReplication &replication);
+    void store(const ComponentReplication &replication);
+
+    std::unordered_map<actor_id_t, unordered_string_map<std::vector<char>>> baselines_;
+};
+
+} // namespace sge::net
@@ -19,11 +19,11 @@
 #include <boost/asio/write.hpp>
 #include <boost/system/detail/error_code.hpp>
 #include <boost/system/system_error.hpp>
-#include <boost/thread/lock_guard.hpp>
-#include <boost/thread/lock_types.hpp>
+#include <dnsge/ConcurrentHashMap.hpp>
 
 #include "net/MessageSocket.hpp"
 #include "net/Messages.hpp"
+#include "util/Trace.hpp"
 
 #include <cassert>
 #include <iostream>
@@ -138,9 +138,7 @@ void TcpClientConnection::removeConnection() {
 }
 
 Host::Host(boost::asio::io_context &ioContext, int port)
-    : acceptor_{ioContext, tcp::endpoint(tcp::v4(), port)}
-    , messageQueue_{ioContext.get_executor()}
-    , clientEventQueue_{ioContext.get_executor()} {
+    : acceptor_{ioContext, tcp::endpoint(tcp::v4(), port)} {
     boost::asio::socket_base::reuse_address option(true);
     this->acceptor_.set_option(option);
 }
@@ -160,20 +158,19 @@ void Host::start() {
 }
 
 void Host::disconnectClient(client_id_t id) {
-    {
-        boost::lock_guard guard(this->mu_);
-        auto it = this->connections_.find(id);
-        if (it == this->connections_.end()) {
-            return;
-        }
-        it->second->stop();
-        this->connections_.erase(it);
+    auto conn = this->connections_.take(id);
+    if (!conn.has_value()) {
+        return;
     }
+    (*conn)->stop();
 
-    this->clientEventQueue_.push(ClientEvent{
+    bool pushed = this->clientEventQueue_.push(ClientEvent{
         .clientID = id,
         .event = ClientEventType::Disconnected,
     });
+    if (!pushed) {
+        std::cerr << "warning: failed to push client disconnect event to queue" << std::endl;
+    }
 }
 
 boost::asio::awaitable<void> Host::listen() {
@@ -181,15 +178,15 @@ boost::asio::awaitable<void> Host::listen() {
         auto sock = co_await this->acceptor_.async_accept(use_awaitable);
         auto clientID = this->nextClientID_++;
         auto conn = TcpClientConnection::create(clientID, std::move(sock), weak_from_this());
-        {
-            boost::lock_guard guard(this->mu_);
-            this->connections_.emplace(clientID, conn);
-        }
+        this->connections_.insert(clientID, conn);
 
-        this->clientEventQueue_.push(ClientEvent{
+        bool pushed = this->clientEventQueue_.push(ClientEvent{
             .clientID = clientID,
             .event = ClientEventType::Connected,
         });
+        if (!pushed) {
+            std::cerr << "warning: failed to push client connect event to queue" << std::endl;
+        }
         conn->start();
     }
 }
@@ -205,28 +202,24 @@ void Host::processMessage(client_id_t clientID, std::unique_ptr<CMessage> msg) {
 }
 
 void Host::postMessage(client_id_t clientID, const SMessage &msg) {
-    boost::shared_lock guard(this->mu_);
-    auto it = this->connections_.find(clientID);
-    if (it == this->connections_.end()) {
-        return;
-    }
-    it->second->postMessage(std::make_unique<SMessage>(msg));
+    TRACE_ZONE("Host.PostMessage");
+    this->connections_.visit(clientID, [&](const TcpClientConnection::pointer &conn) {
+        conn->postMessage(std::make_unique<SMessage>(msg));
+    });
 }
 
 void Host::postMessage(client_id_t clientID, SMessage &&msg) {
-    boost::shared_lock guard(this->mu_);
-    auto it = this->connections_.find(clientID);
-    if (it == this->connections_.end()) {
-        return;
-    }
-    it->second->postMessage(std::make_unique<SMessage>(std::move(msg)));
+    TRACE_ZONE("Host.PostMessage");
+    this->connections_.visit(clientID, [&](const TcpClientConnection::pointer &conn) {
+        conn->postMessage(std::make_unique<SMessage>(std::move(msg)));
+    });
 }
 
 void Host::broadcastMessage(const SMessage &msg) {
-    boost::shared_lock guard(this->mu_);
-    for (const auto &connEntry : this->connections_) {
-        connEntry.second->postMessage(std::make_unique<SMessage>(msg));
-    }
+    TRACE_ZONE("Host.BroadcastMessage");
+    this->connections_.forEach([&](client_id_t, const TcpClientConnection::pointer &conn) {
+        conn->postMessage(std::make_unique<SMessage>(msg));
+    });
 }
 
 } // namespace sge::net
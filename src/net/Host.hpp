@@ -10,18 +10,17 @@
 #include <boost/asio/streambuf.hpp>
 #include <boost/system/detail/error_code.hpp>
 #include <boost/system/system_error.hpp>
-#include <boost/thread/lock_types.hpp>
-#include <boost/thread/shared_mutex.hpp>
+#include <dnsge/ConcurrentHashMap.hpp>
 
 #include "net/MessageSocket.hpp"
 #include "net/Messages.hpp"
 #include "util/AsyncSpscQueue.hpp"
+#include "util/MpscQueue.hpp"
 
 #include <atomic>
 #include <cstddef>
 #include <memory>
 #include <msgpack.hpp>
-#include <unordered_map>
 #include <utility>
 
 namespace sge::net {
@@ -115,12 +114,11 @@ public:
      */
     template <typename Pred>
     void broadcastMessage(const SMessage &msg, Pred p) {
-        boost::shared_lock guard(this->mu_);
-        for (const auto &connEntry : this->connections_) {
-            if (p(connEntry.first)) {
-                connEntry.second->postMessage(std::make_unique<SMessage>(msg));
+        this->connections_.forEach([&](client_id_t clientID, const auto &conn) {
+            if (p(clientID)) {
+                conn->postMessage(std::make_unique<SMessage>(msg));
             }
-        }
+        });
     }
 
     /**
@@ -164,12 +162,14 @@ private:
 
     tcp::acceptor acceptor_;
 
-    boost::shared_mutex mu_;
     client_id_t nextClientID_{1};
-    std::unordered_map<client_id_t, TcpClientConnection::pointer> connections_;
+    // Accessed from the io threads and from the tick threads of rooms
+    dnsge::ConcurrentHashMap<client_id_t, TcpClientConnection::pointer> connections_;
 
-    util::AsyncSpscQueue<ClientMessage> messageQueue_;
-    util::AsyncSpscQueue<ClientEvent, 10> clientEventQueue_;
+    // Pushed onto from the io threads, the tick threads of rooms and the
+    // server thread, and consumed by the server thread
+    util::MpscQueue<ClientMessage> messageQueue_;
+    util::MpscQueue<ClientEvent> clientEventQueue_;
 };
 
 } // namespace sge::net
@@ -0,0 +1,469 @@
+#include "net/LuaPacking.hpp"
+
+#include <lua/lua.hpp>
+#include <LuaBridge/LuaBridge.h>
+
+#include "util/Trace.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <msgpack.hpp>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace sge::net {
+
+namespace {
+
+// Variant indices of the scripting::LuaValue alternatives
+enum LuaValueIndex : std::uint8_t {
+    IndexNil = 0,
+    IndexNumber = 1,
+    IndexBoolean = 2,
+    IndexString = 3,
+    IndexArray = 4,
+    IndexTable = 5,
+};
+
+// Deepest nesting of tables that can be replicated. Also stops cyclic tables.
+constexpr int MaxTableDepth = 64;
+
+// Most entries preallocated for a decoded table, whatever its header claims
+constexpr std::uint32_t MaxPreallocatedEntries = 1024;
+
+/**
+ * @brief msgpack stream appending to a byte vector.
+ */
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<char> &out)
+        : out_(out) {}
+
+    void write(const char* data, std::size_t size) {
+        this->out_.insert(this->out_.end(), data, data + size);
+    }
+
+private:
+    std::vector<char> &out_;
+};
+
+using Packer = msgpack::packer<ByteWriter>;
+
+//-----------------------------------------------------------------------------
+// Encoding
+
+bool tableIsProbablyArray(lua_State* L, int index) {
+    lua_rawgeti(L, index, 1);
+    bool exists = !lua_isnil(L, -1);
+    lua_pop(L, 1);
+    return exists;
+}
+
+std::uint32_t countEntries(lua_State* L, int index) {
+    std::uint32_t count = 0;
+    lua_pushnil(L);
+    while (lua_next(L, index) != 0) {
+        ++count;
+        lua_pop(L, 1);
+    }
+    return count;
+}
+
+void packString(Packer &packer, lua_State* L, int index) {
+    std::size_t size = 0;
+    const char* s = lua_tolstring(L, index, &size);
+    packer.pack_str(static_cast<std::uint32_t>(size));
+    packer.pack_str_body(s, static_cast<std::uint32_t>(size));
+}
+
+void packKey(Packer &packer, lua_State* L, int index) {
+    switch (lua_type(L, index)) {
+    case LUA_TSTRING:
+        packString(packer, L, index);
+        return;
+    case LUA_TNUMBER:
+        // Convert a copy, since converting the key itself would confuse lua_next
+        lua_pushvalue(L, index);
+        packString(packer, L, -1);
+        lua_pop(L, 1);
+        return;
+    default:
+        throw std::runtime_error("lua table key type does not support event replication");
+    }
+}
+
+void packValue(Packer &packer, lua_State* L, int index, int depth) {
+    switch (lua_type(L, index)) {
+    case LUA_TNIL:
+        packer.pack_map(1);
+        packer.pack_uint8(IndexNil);
+        packer.pack_nil();
+        return;
+    case LUA_TNUMBER:
+        packer.pack_map(1);
+        packer.pack_uint8(IndexNumber);
+        packer.pack_double(lua_tonumber(L, index));
+        return;
+    case LUA_TBOOLEAN:
+        packer.pack_map(1);
+        packer.pack_uint8(IndexBoolean);
+        if (lua_toboolean(L, index) != 0) {
+            packer.pack_true();
+        } else {
+            packer.pack_false();
+        }
+        return;
+    case LUA_TSTRING:
+        packer.pack_map(1);
+        packer.pack_uint8(IndexString);
+        packString(packer, L, index);
+        return;
+    case LUA_TTABLE:
+        break;
+    default:
+        throw std::runtime_error("lua type does not support event replication");
+    }
+
+    if (depth >= MaxTableDepth) {
+        throw std::runtime_error("lua table is nested too deeply for event replication");
+    }
+    if (lua_checkstack(L, 3) == 0) {
+        throw std::runtime_error("lua stack overflow during event replication");
+    }
+
+    const bool isArray = tableIsProbablyArray(L, index);
+    const auto count = countEntries(L, index);
+    packer.pack_map(1);
+    if (isArray) {
+        packer.pack_uint8(IndexArray);
+        packer.pack_array(count);
+    } else {
+        packer.pack_uint8(IndexTable);
+        packer.pack_map(count);
+    }
+
+    lua_pushnil(L);
+    while (lua_next(L, index) != 0) {
+        auto valueIndex = lua_gettop(L);
+        if (!isArray) {
+            packKey(packer, L, valueIndex - 1);
+        }
+        packValue(packer, L, valueIndex, depth + 1);
+        lua_pop(L, 1);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Decoding
+
+/**
+ * @brief Pushes a packed value onto the Lua stack as msgpack parses it, so that
+ * tables are filled in straight from the wire.
+ */
+class LuaValueBuilder : public msgpack::null_visitor {
+public:
+    explicit LuaValueBuilder(lua_State* L)
+        : L_(L) {
+        this->frames_.reserve(16);
+    }
+
+    bool complete() const {
+        return this->complete_;
+    }
+
+    bool visit_nil() {
+        return this->pushPayload(IndexNil, [](lua_State* L) {
+            lua_pushnil(L);
+        });
+    }
+
+    bool visit_boolean(bool v) {
+        return this->pushPayload(IndexBoolean, [v](lua_State* L) {
+            lua_pushboolean(L, v ? 1 : 0);
+        });
+    }
+
+    bool visit_positive_integer(std::uint64_t v) {
+        if (!this->frames_.empty()) {
+            auto &top = this->frames_.back();
+            if (top.kind == Frame::Kind::Variant && top.index < 0) {
+                // Key of a variant
+                if (v > IndexTable) {
+                    return false;
+                }
+                top.index = static_cast<int>(v);
+                return true;
+            }
+        }
+        return this->pushNumber(static_cast<lua_Number>(v));
+    }
+
+    bool visit_negative_integer(std::int64_t v) {
+        return this->pushNumber(static_cast<lua_Number>(v));
+    }
+
+    bool visit_float32(float v) {
+        return this->pushNumber(static_cast<lua_Number>(v));
+    }
+
+    bool visit_float64(double v) {
+        return this->pushNumber(static_cast<lua_Number>(v));
+    }
+
+    bool visit_str(const char* v, std::uint32_t size) {
+        if (!this->frames_.empty()) {
+            auto &top = this->frames_.back();
+            if (top.kind == Frame::Kind::Table && top.inKey) {
+                if (lua_checkstack(this->L_, 1) == 0) {
+                    return false;
+                }
+                lua_pushlstring(this->L_, v, size);
+                return true;
+            }
+        }
+        return this->pushPayload(IndexString, [v, size](lua_State* L) {
+            lua_pushlstring(L, v, size);
+        });
+    }
+
+    bool start_array(std::uint32_t num) {
+        if (!this->atPayload(IndexArray) || !this->enterTable()) {
+            return false;
+        }
+        lua_createtable(this->L_, static_cast<int>(std::min(num, MaxPreallocatedEntries)), 0);
+        this->frames_.back().done = true;
+        this->frames_.push_back(Frame{.kind = Frame::Kind::Array});
+        return true;
+    }
+
+    bool end_array_item() {
+        auto &top = this->frames_.back();
+        lua_rawseti(this->L_, -2, top.next++);
+        return true;
+    }
+
+    bool end_array() {
+        this->frames_.pop_back();
+        --this->tableDepth_;
+        return true;
+    }
+
+    bool start_map(std::uint32_t num) {
+        if (this->atValue()) {
+            // Every value is a one-entry map from its variant index
+            if (num != 1) {
+                return false;
+            }
+            this->frames_.push_back(Frame{.kind = Frame::Kind::Variant});
+            return true;
+        }
+        if (!this->atPayload(IndexTable) || !this->enterTable()) {
+            return false;
+        }
+        lua_createtable(this->L_, 0, static_cast<int>(std::min(num, MaxPreallocatedEntries)));
+        this->frames_.back().done = true;
+        this->frames_.push_back(Frame{.kind = Frame::Kind::Table});
+        return true;
+    }
+
+    bool start_map_key() {
+        this->frames_.back().inKey = true;
+        return true;
+    }
+
+    bool end_map_key() {
+        this->frames_.back().inKey = false;
+        return true;
+    }
+
+    bool end_map_value() {
+        auto &top = this->frames_.back();
+        if (top.kind == Frame::Kind::Table) {
+            lua_rawset(this->L_, -3);
+            return true;
+        }
+        return top.done;
+    }
+
+    bool end_map() {
+        auto kind = this->frames_.back().kind;
+        this->frames_.pop_back();
+        if (kind == Frame::Kind::Table) {
+            --this->tableDepth_;
+        } else if (this->frames_.empty()) {
+            this->complete_ = true;
+        }
+        return true;
+    }
+
+private:
+    struct Frame {
+        enum class Kind { Variant, Array, Table };
+
+        Kind kind;
+        // Variant: index read from its key, or -1 before the key
+        int index{-1};
+        // Variant: whether its payload has been pushed
+        bool done{false};
+        // Table: whether a key is being read
+        bool inKey{false};
+        // Array: Lua index of the next item
+        lua_Integer next{1};
+    };
+
+    // Whether a whole packed value is expected next
+    bool atValue() const {
+        if (this->frames_.empty()) {
+            return !this->complete_;
+        }
+        const auto &top = this->frames_.back();
+        return top.kind == Frame::Kind::Array || (top.kind == Frame::Kind::Table && !top.inKey);
+    }
+
+    // Whether the payload of a variant with the index is expected next
+    bool atPayload(int index) const {
+        if (this->frames_.empty()) {
+            return false;
+        }
+        const auto &top = this->frames_.back();
+        return top.kind == Frame::Kind::Variant && top.index == index && !top.done;
+    }
+
+    bool enterTable() {
+        if (this->tableDepth_ >= MaxTableDepth || lua_checkstack(this->L_, 3) == 0) {
+            return false;
+        }
+        ++this->tableDepth_;
+        return true;
+    }
+
+    template <typename Push>
+    bool pushPayload(int index, Push push) {
+        if (!this->atPayload(index) || lua_checkstack(this->L_, 1) == 0) {
+            return false;
+        }
+        push(this->L_);
+        this->frames_.back().done = true;
+        return true;
+    }
+
+    bool pushNumber(lua_Number n) {
+        return this->pushPayload(IndexNumber, [n](lua_State* L) {
+            lua_pushnumber(L, n);
+        });
+    }
+
+    lua_State* L_;
+    std::vector<Frame> frames_;
+    int tableDepth_{0};
+    bool complete_{false};
+};
+
+//-----------------------------------------------------------------------------
+// Validation
+
+bool isPackedLuaValue(const msgpack::object &o, int depth) {
+    if (o.type != msgpack::type::MAP || o.via.map.size != 1) {
+        return false;
+    }
+    const auto &key = o.via.map.ptr[0].key;
+    const auto &value = o.via.map.ptr[0].val;
+    if (key.type != msgpack::type::POSITIVE_INTEGER) {
+        return false;
+    }
+
+    switch (key.via.u64) {
+    case IndexNil:
+        return value.type == msgpack::type::NIL;
+    case IndexNumber:
+        return value.type == msgpack::type::FLOAT64 || value.type == msgpack::type::FLOAT32 ||
+               value.type == msgpack::type::POSITIVE_INTEGER ||
+               value.type == msgpack::type::NEGATIVE_INTEGER;
+    case IndexBoolean:
+        return value.type == msgpack::type::BOOLEAN;
+    case IndexString:
+        return value.type == msgpack::type::STR;
+    case IndexArray:
+        if (value.type != msgpack::type::ARRAY || depth >= MaxTableDepth) {
+            return false;
+        }
+        return std::all_of(value.via.array.ptr, value.via.array.ptr + value.via.array.size,
+                           [depth](const msgpack::object &item) {
+                               return isPackedLuaValue(item, depth + 1);
+                           });
+    case IndexTable:
+        if (value.type != msgpack::type::MAP || depth >= MaxTableDepth) {
+            return false;
+        }
+        return std::all_of(value.via.map.ptr, value.via.map.ptr + value.via.map.size,
+                           [depth](const msgpack::object_kv &entry) {
+                               return entry.key.type == msgpack::type::STR &&
+                                      isPackedLuaValue(entry.val, depth + 1);
+                           });
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+PackedLuaValue PackLuaValue(lua_State* L, int index) {
+    TRACE_ZONE("Replicator.PackLuaValue");
+    PackedLuaValue packed;
+    ByteWriter writer{packed.data};
+    Packer packer{writer};
+
+    const auto top = lua_gettop(L);
+    try {
+        packValue(packer, L, lua_absindex(L, index), 0);
+    } catch (...) {
+        lua_settop(L, top);
+        throw;
+    }
+    return packed;
+}
+
+PackedLuaValue PackLuaValue(const luabridge::LuaRef &value) {
+    auto* L = value.state();
+    value.push(L);
+    PackedLuaValue packed;
+    try {
+        packed = PackLuaValue(L, -1);
+    } catch (...) {
+        lua_pop(L, 1);
+        throw;
+    }
+    lua_pop(L, 1);
+    return packed;
+}
+
+bool PushLuaValue(lua_State* L, std::span<const char> data) {
+    TRACE_ZONE("Replicator.PushLuaValue");
+    const auto top = lua_gettop(L);
+    LuaValueBuilder builder{L};
+    std::size_t offset = 0;
+    if (!msgpack::parse(data.data(), data.size(), offset, builder) || !builder.complete() ||
+        offset != data.size() || lua_gettop(L) != top + 1) {
+        lua_settop(L, top);
+        return false;
+    }
+    return true;
+}
+
+namespace detail {
+
+bool CopyPackedLuaValue(const msgpack::object &o, std::vector<char> &out) {
+    if (!isPackedLuaValue(o, 0)) {
+        return false;
+    }
+    out.clear();
+    ByteWriter writer{out};
+    msgpack::pack(writer, o);
+    return true;
+}
+
+} // namespace detail
+
+} // namespace sge::net
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <lua/lua.hpp>
+#include <LuaBridge/LuaBridge.h>
+
+#include <cstdint>
+#include <msgpack.hpp>
+#include <span>
+#include <vector>
+
+namespace sge::net {
+
+/**
+ * @brief A Lua value encoded as msgpack, in exactly the layout msgpack gives a
+ * scripting::LuaValue: each value is a one-entry map from its variant index to
+ * its payload. Lua values are encoded and decoded without building a LuaValue
+ * tree, while peers that still use LuaValue can read and write the same bytes.
+ */
+struct PackedLuaValue {
+    std::vector<char> data;
+};
+
+/**
+ * @brief Encode the Lua value at index with the same rules as
+ * luabridge::Stack<scripting::LuaValue>::get: a table whose [1] is non-nil is
+ * an array of its values, any other table a map with string keys.
+ *
+ * @throws std::runtime_error if the value, or anything in it, can't be
+ * replicated.
+ */
+PackedLuaValue PackLuaValue(lua_State* L, int index);
+PackedLuaValue PackLuaValue(const luabridge::LuaRef &value);
+
+/**
+ * @brief Decode a packed value and push it onto the Lua stack.
+ *
+ * @return Whether the value was pushed. Nothing is pushed if the data is not
+ * a valid packed value.
+ */
+bool PushLuaValue(lua_State* L, std::span<const char> data);
+
+namespace detail {
+
+/**
+ * @brief Check that an object has the layout of a packed value, and copy its
+ * encoding into out.
+ */
+bool CopyPackedLuaValue(const msgpack::object &o, std::vector<char> &out);
+
+} // namespace detail
+
+} // namespace sge::net
+
+namespace msgpack {
+MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS) {
+    namespace adaptor {
+
+    template <>
+    struct convert<sge::net::PackedLuaValue> {
+        msgpack::object const &operator()(msgpack::object const &msgpack_o,
+                                          sge::net::PackedLuaValue &msgpack_v) const {
+            if (!sge::net::detail::CopyPackedLuaValue(msgpack_o, msgpack_v.data)) {
+                throw msgpack::type_error();
+            }
+            return msgpack_o;
+        }
+    };
+
+    template <>
+    struct pack<sge::net::PackedLuaValue> {
+        template <typename Stream>
+        msgpack::packer<Stream> &operator()(msgpack::packer<Stream> &msgpack_o,
+                                            const sge::net::PackedLuaValue &msgpack_v) const {
+            if (msgpack_v.data.empty()) {
+                // Same as a nil LuaValue
+                msgpack_o.pack_map(1);
+                msgpack_o.pack_uint8(0);
+                msgpack_o.pack_nil();
+                return msgpack_o;
+            }
+            // The data is already msgpack, so it is written out verbatim
+            msgpack_o.pack_bin_body(msgpack_v.data.data(),
+                                    static_cast<std::uint32_t>(msgpack_v.data.size()));
+            return msgpack_o;
+        }
+    };
+
+    } // namespace adaptor
+}
+
+} // namespace msgpack
@@ -10,6 +10,7 @@
 #include "net/Messages.hpp"
 #include "net/Protocol.hpp"
 #include "util/AsyncLock.hpp"
+#include "util/Trace.hpp"
 
 #include <cstddef>
 #include <exception>
@@ -79,8 +80,13 @@ public:
         // 1. Read message from socket
         std::size_t size = co_await ReadMessageAsync(*this->socket_, this->readBuffer_);
         // 2. Parse message
-        auto data = std::span<const char>{this->readBuffer_.data(), size};
-        auto msg = ParseMessage<ReadMessage>(data);
+        std::unique_ptr<ReadMessage> msg;
+        {
+            // Zones must not span a co_await, which may resume on another thread
+            TRACE_ZONE("Net.ParseMessage");
+            auto data = std::span<const char>{this->readBuffer_.data(), size};
+            msg = ParseMessage<ReadMessage>(data);
+        }
 #if defined(NET_DEBUG)
         if (msg) {
             std::cout << "[ sock " << this->socket_->remote_endpoint() << " ] recv "
@@ -99,8 +105,11 @@ public:
     boost::asio::awaitable<void> writeMessage(const Msg &msg) {
         auto guard = util::LockGuard(this->lock_);
         // 1. Serialize message to buffer
-        this->writeBuffer_.clear();
-        SerializeMessage(this->writeBuffer_, msg);
+        {
+            TRACE_ZONE("Net.SerializeMessage");
+            this->writeBuffer_.clear();
+            SerializeMessage(this->writeBuffer_, msg);
+        }
         // 2. Write data to socket
         auto data = std::span<const char>{this->writeBuffer_.data(), this->writeBuffer_.size()};
 #if defined(NET_DEBUG)
@@ -118,8 +127,11 @@ public:
     boost::asio::awaitable<void> writeMessage(const WriteMessage &msg) {
         auto guard = util::LockGuard(this->lock_);
         // 1. Serialize message to buffer
-        this->writeBuffer_.clear();
-        SerializeMessage(this->writeBuffer_, msg);
+        {
+            TRACE_ZONE("Net.SerializeMessage");
+            this->writeBuffer_.clear();
+            SerializeMessage(this->writeBuffer_, msg);
+        }
         // 2. Write data to socket
         auto data = std::span<const char>{this->writeBuffer_.data(), this->writeBuffer_.size()};
 #if defined(NET_DEBUG)
@@ -28,6 +28,7 @@ enum MessageType : uint8_t {
     MessageTypeTickReplicationReject = 7,
     MessageTypeRoomState = 8,
     MessageTypeRemoteEvent = 9,
+    MessageTypeResyncRequest = 10,
 };
 
 constexpr std::string_view StringOfMessageType(MessageType mty) {
@@ -53,6 +54,8 @@ constexpr std::string_view StringOfMessageType(MessageType mty) {
         return "MessageTypeRoomState"sv;
     case MessageTypeRemoteEvent:
         return "MessageTypeRemoteEvent"sv;
+    case MessageTypeResyncRequest:
+        return "MessageTypeResyncRequest"sv;
     default:
         return "<invalid message type>"sv;
     }
@@ -79,11 +82,14 @@ struct MessageError {
 
 /**
  * @brief Sent by client after connecting to server. The server should register
- * the client and respond with MessageWelcome.
+ * the client in the requested room and respond with MessageWelcome.
  */
 struct MessageHello {
     static constexpr MessageType Mty = MessageTypeHello;
-    MSGPACK_DEFINE();
+    // Name of the room to join. Empty joins the server's default room.
+    std::string room;
+
+    MSGPACK_DEFINE(room);
 };
 
 /**
@@ -132,11 +138,38 @@ struct MessageLoadSceneRequest {
 struct MessageTickReplication {
     static constexpr MessageType Mty = MessageTypeTickReplication;
     unsigned int generation;
-    std::vector<InstantiatedActor> instantiations;
+    // Set by the server on the first message to a client after it dropped its
+    // baselines for the client's MessageResyncRequest. The client then drops
+    // its own before decoding the replications.
+    bool keyframe{false};
+    // Shared by the copies of a message the server sends to each client, since
+    // only the replications are encoded per client. Null is the same as empty.
+    std::shared_ptr<std::vector<InstantiatedActor>> instantiations;
     std::vector<ComponentReplication> replications;
-    std::vector<actor_id_t> destructions;
+    std::shared_ptr<std::vector<actor_id_t>> destructions;
+
+    MSGPACK_DEFINE(generation, keyframe, instantiations, replications, destructions);
+};
+
+/**
+ * @brief The elements of a shared message field, or none if it is null.
+ */
+template <typename T>
+std::span<T> SharedElements(const std::shared_ptr<std::vector<T>> &elements) {
+    return elements != nullptr ? std::span<T>{*elements} : std::span<T>{};
+}
+
+/**
+ * @brief Sent by client when it can't rebuild a delta encoded replication,
+ * e.g. because it has no baseline for the component. The server drops its
+ * baselines for the client and marks its next MessageTickReplication to the
+ * client as a keyframe, so that both ends start over from full states.
+ */
+struct MessageResyncRequest {
+    static constexpr MessageType Mty = MessageTypeResyncRequest;
+    unsigned int generation;
 
-    MSGPACK_DEFINE(generation, instantiations, replications, destructions);
+    MSGPACK_DEFINE(generation);
 };
 
 /**
@@ -190,7 +223,7 @@ struct MessageRemoteEvents {
  * @brief A message sent by a client to a server.
  */
 using CMessage = std::variant<MessageError, MessageHello, MessageLoadSceneRequest,
-                              MessageTickReplication, MessageRemoteEvents>;
+                              MessageTickReplication, MessageRemoteEvents, MessageResyncRequest>;
 
 /**
  * @brief A message sent by a server to a client.
@@ -5,10 +5,14 @@
 #include "game/Actor.hpp"
 #include "game/Game.hpp"
 #include "scripting/Component.hpp"
+#include "scripting/EventSub.hpp"
 #include "scripting/Invoke.hpp"
+#include "scripting/Scripting.hpp"
+#include "util/Trace.hpp"
 
 #include <cassert>
 #include <cstdint>
+#include <iostream>
 #include <memory>
 #include <msgpack.hpp>
 #include <optional>
@@ -29,7 +33,7 @@ void replicateComponent(ReplicatePush &pusher, scripting::Component* component,
         component->actor->remoteID.has_value() ? *component->actor->remoteID : component->actor->id;
     // 1. Pack component representation into pusher
     pusher.clear();
-    bool ok = scripting::ActorInvoke(component->actor->name, [&] {
+    bool ok = scripting::ActorInvoke(component->actor->name.str(), [&] {
         component->replicatePush(pusher);
     });
     if (!ok) {
@@ -40,14 +44,15 @@ void replicateComponent(ReplicatePush &pusher, scripting::Component* component,
     auto packedData = pusher.data();
 
     // 3. Create replication request, copying data of pusher
-    out.emplace_back(id, component->key, std::vector<char>{packedData.begin(), packedData.end()});
+    out.emplace_back(id, std::string{component->key.str()},
+                     std::vector<char>{packedData.begin(), packedData.end()});
 }
 
 void replicateComponent(ReplicatePush &pusher, scripting::Component* component,
                         std::vector<InstantiatedActorComponentState> &out) {
     // 1. Pack component representation into pusher
     pusher.clear();
-    bool ok = scripting::ActorInvoke(component->actor->name, [&] {
+    bool ok = scripting::ActorInvoke(component->actor->name.str(), [&] {
         component->replicatePush(pusher);
     });
     if (!ok) {
@@ -58,7 +63,7 @@ void replicateComponent(ReplicatePush &pusher, scripting::Component* component,
     auto packedData = pusher.data();
 
     // 3. Create replication request, copying data of pusher
-    out.emplace_back(component->key, std::vector<char>{packedData.begin(), packedData.end()});
+    out.emplace_back(std::string{component->key.str()}, std::vector<char>{packedData.begin(), packedData.end()});
 }
 
 void dispatchComponentReplication(game::Actor* actor, const std::string &componentKey,
@@ -106,11 +111,11 @@ RemoteIDMapping::RemoteIDMapping(client_id_t clientID, client_id_t serverID)
     : clientID(clientID)
     , serverID(serverID) {}
 
-EventPublish::EventPublish(std::string event, scripting::LuaValue value)
+EventPublish::EventPublish(std::string event, PackedLuaValue value)
     : event(std::move(event))
     , value(std::move(value)) {}
 
-EventPublish::EventPublish(std::string_view event, scripting::LuaValue value)
+EventPublish::EventPublish(std::string_view event, PackedLuaValue value)
     : event(event)
     , value(std::move(value)) {}
 
@@ -234,18 +239,20 @@ void ReplicatorService::destroy(game::Actor* actor) {
     this->erasePendingReplications(actor);
 }
 
-void ReplicatorService::eventPublish(std::string_view event, scripting::LuaValue value) {
-    this->toPublish_.emplace_back(event, std::move(value));
+void ReplicatorService::eventPublish(std::string_view event, const luabridge::LuaRef &value) {
+    // Packed straight from Lua now, so the message is ready to send
+    this->toPublish_.emplace_back(event, PackLuaValue(value));
 }
 
 std::vector<ComponentReplication> ReplicatorService::replicateGame(game::Game &game) {
+    TRACE_ZONE("Replicator.ReplicateGame");
     std::vector<ComponentReplication> res;
     for (const auto &actor : game.currentScene().actors()) {
         for (const auto &componentEntry : actor->components) {
-            if (componentEntry.second->realm != Realm::ServerReplicated) {
+            if (componentEntry.component->realm != Realm::ServerReplicated) {
                 continue;
             }
-            replicateComponent(this->pusher_, componentEntry.second.get(), res);
+            replicateComponent(this->pusher_, componentEntry.component.get(), res);
         }
     }
     return res;
@@ -257,6 +264,7 @@ bool ReplicatorService::hasPendingReplications() const {
 }
 
 std::vector<InstantiatedActor> ReplicatorService::serializeInstantiations() {
+    TRACE_ZONE("Replicator.SerializeInstantiations");
     if (this->toInstantiate_.empty()) {
         return {};
     }
@@ -267,12 +275,12 @@ std::vector<InstantiatedActor> ReplicatorService::serializeInstantiations() {
     for (auto* a : this->toInstantiate_) {
         std::vector<InstantiatedActorComponentState> cs;
         for (const auto &componentEntry : a->components) {
-            if (componentEntry.second->realm != Realm::ServerReplicated) {
+            if (componentEntry.component->realm != Realm::ServerReplicated) {
                 continue;
             }
-            replicateComponent(this->pusher_, componentEntry.second.get(), cs);
+            replicateComponent(this->pusher_, componentEntry.component.get(), cs);
         }
-        res.emplace_back(a->runtimeTemplate(), a->id, a->ownerClient, std::move(cs));
+        res.emplace_back(std::string{a->runtimeTemplate().str()}, a->id, a->ownerClient, std::move(cs));
     }
 
     // Instantiations have been consumed
@@ -281,6 +289,7 @@ std::vector<InstantiatedActor> ReplicatorService::serializeInstantiations() {
 }
 
 std::vector<ComponentReplication> ReplicatorService::serializeComponents() {
+    TRACE_ZONE("Replicator.SerializeComponents");
     if (this->toReplicate_.empty()) {
         return {};
     }
@@ -305,6 +314,7 @@ std::vector<ComponentReplication> ReplicatorService::serializeComponents() {
 }
 
 std::vector<actor_id_t> ReplicatorService::serializeDestructions() {
+    TRACE_ZONE("Replicator.SerializeDestructions");
     std::vector<actor_id_t> res;
     std::swap(res, this->toDestroy_);
     return res;
@@ -315,6 +325,7 @@ bool ReplicatorService::hasPendingEventPublishes() const {
 }
 
 std::vector<EventPublish> ReplicatorService::serializeEventPublishes() {
+    TRACE_ZONE("Replicator.SerializeEventPublishes");
     std::vector<EventPublish> res;
     std::swap(res, this->toPublish_);
     return res;
@@ -323,8 +334,8 @@ std::vector<EventPublish> ReplicatorService::serializeEventPublishes() {
 void ReplicatorService::erasePendingReplications(game::Actor* actor) {
     // Un-replicate any components on the actor
     for (const auto &entry : actor->components) {
-        if (entry.second->realm == Realm::ServerReplicated) {
-            this->toReplicate_.erase(entry.second.get());
+        if (entry.component->realm == Realm::ServerReplicated) {
+            this->toReplicate_.erase(entry.component.get());
         }
     }
     // Un-instantiate the actor
@@ -349,6 +360,7 @@ void ReplicatorService::dispatchReplication(
 void ReplicatorService::dispatchReplication(game::Game &game,
                                             const ComponentReplication &replication,
                                             bool doInterp) {
+    TRACE_ZONE("Replicator.DispatchReplication");
     // 1. Locate target actor containing component
     auto* actor = game.currentScene().findActorByRemoteID(replication.actorID);
     if (actor == nullptr) {
@@ -367,13 +379,35 @@ void ReplicatorService::dispatchReplication(game::Game &game,
     dispatchComponentReplication(actor, replication.componentKey, replication.packed, doInterp);
 }
 
+void ReplicatorService::dispatchEventPublish(game::Game &game, const EventPublish &publish) {
+    TRACE_ZONE("Replicator.DispatchEventPublish");
+    auto &eventSub = game.eventSub();
+    auto channel = eventSub.findChannel(publish.event);
+    if (!channel.has_value() || !eventSub.hasHandlers(*channel)) {
+        // Nobody is listening, so don't bother decoding the payload
+        return;
+    }
+
+    // Decode the payload straight into a Lua table
+    auto* L = scripting::GetGlobalState();
+    if (!PushLuaValue(L, publish.value.data)) {
+        std::cerr << "warning: dropping remote event " << publish.event
+                  << " with an invalid payload" << std::endl;
+        return;
+    }
+    auto payload = luabridge::LuaRef::fromStack(L, -1);
+    lua_pop(L, 1);
+    eventSub.publishReplicated(*channel, payload);
+}
+
 std::vector<RuntimeActor> ReplicatorService::replicateRuntimeActors(const game::Game &game) {
+    TRACE_ZONE("Replicator.ReplicateRuntimeActors");
     std::vector<RuntimeActor> res;
     for (const auto &actor : game.currentScene().actors()) {
         if (!actor->runtime()) {
             continue;
         }
-        res.emplace_back(actor->runtimeTemplate(), actor->id, actor->ownerClient);
+        res.emplace_back(std::string{actor->runtimeTemplate().str()}, actor->id, actor->ownerClient);
     }
     return res;
 }
@@ -1,10 +1,11 @@
 #pragma once
 
 #include <msgpack/adaptor/cpp17/variant.hpp>
+#include <LuaBridge/LuaBridge.h>
 
 #include "Types.hpp"
+#include "net/LuaPacking.hpp"
 #include "net/Packing.hpp" // IWYU pragma: keep
-#include "scripting/LuaValue.hpp"
 
 #include <cstddef>
 #include <memory>
@@ -33,11 +34,14 @@ struct ComponentReplication {
     actor_id_t actorID;
     std::string componentKey;
     std::vector<char> packed;
+    // Whether packed is a delta against the receiver's baseline of the
+    // component, see ReplicationBaselines
+    bool delta{false};
 
     ComponentReplication() = default;
     ComponentReplication(actor_id_t actorID, std::string componentKey, std::vector<char> &&packed);
 
-    MSGPACK_DEFINE(actorID, componentKey, packed);
+    MSGPACK_DEFINE(actorID, componentKey, packed, delta);
 };
 
 struct RuntimeActor {
@@ -86,11 +90,12 @@ struct RemoteIDMapping {
 
 struct EventPublish {
     std::string event;
-    scripting::LuaValue value;
+    // Encoded as a scripting::LuaValue would be
+    PackedLuaValue value;
 
     EventPublish() = default;
-    EventPublish(std::string event, scripting::LuaValue value);
-    EventPublish(std::string_view event, scripting::LuaValue value);
+    EventPublish(std::string event, PackedLuaValue value);
+    EventPublish(std::string_view event, PackedLuaValue value);
 
     MSGPACK_DEFINE(event, value);
 };
@@ -148,7 +153,7 @@ public:
     void instantiate(game::Actor* actor);
     void replicate(scripting::Component* component);
     void destroy(game::Actor* actor);
-    void eventPublish(std::string_view event, scripting::LuaValue value);
+    void eventPublish(std::string_view event, const luabridge::LuaRef &value);
     std::vector<ComponentReplication> replicateGame(game::Game &game);
 
     bool hasPendingReplications() const;
@@ -166,6 +171,7 @@ public:
         game::Actor* actor, const std::vector<InstantiatedActorComponentState> &componentState);
     static void dispatchReplication(game::Game &game, const ComponentReplication &replication,
                                     bool doInterp);
+    static void dispatchEventPublish(game::Game &game, const EventPublish &publish);
     static std::vector<RuntimeActor> replicateRuntimeActors(const game::Game &game);
 
 private:
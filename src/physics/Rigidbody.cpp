@@ -11,6 +11,7 @@
 #include "scripting/Scripting.hpp"
 #include "scripting/components/CppComponent.hpp"
 #include "util/B2Ptr.hpp"
+#include "util/Symbol.hpp"
 
 #include <cassert>
 #include <cstdint>
@@ -36,6 +37,8 @@ inline float degreesOfRadians(float radians) {
 constexpr int16_t CategoryCollider = 1 << 0;
 constexpr int16_t CategoryTrigger = 1 << 1;
 
+const auto RigidbodyType = util::Intern("Rigidbody");
+
 } // namespace
 
 using namespace scripting;
@@ -43,7 +46,7 @@ using namespace util;
 
 Rigidbody::Rigidbody(b2World* world)
     // TODO: Physics only on server?
-    : CppComponent("Rigidbody", Realm::Server)
+    : CppComponent(RigidbodyType, Realm::Server)
     , __opaquePointer{this}
     , ref_{GetGlobalState(), this}
     , world_(world) {}
@@ -69,8 +72,11 @@ void Rigidbody::initialize() {
     bodyDef.gravityScale = this->gravity_scale;
     bodyDef.angularDamping = this->angular_friction;
     bodyDef.angle = radiansOfDegrees(this->rotation);
+    bodyDef.userData.pointer = reinterpret_cast<uintptr_t>(this);
 
     this->body_ = b2BodyPtr{this->world_->CreateBody(&bodyDef), B2BodyDestroyer{this->world_}};
+    this->beginStep();
+    this->interpolate(0.0F);
 
     // Set up fixtures
     if (this->has_collider) {
@@ -86,32 +92,43 @@ void Rigidbody::initialize() {
 
 std::unique_ptr<Component> Rigidbody::clone() const {
     auto newRb = std::make_unique<Rigidbody>(this->world_);
+    newRb->copyValues(*this);
+    assert(!newRb->initialized());
+    return newRb;
+}
+
+bool Rigidbody::reset(const Component &prototype) {
+    // The body is created again when the component is initialized
+    this->body_.reset();
+    this->copyValues(static_cast<const Rigidbody &>(prototype));
+    this->resetLifecycle();
+    return true;
+}
+
+void Rigidbody::copyValues(const Rigidbody &other) {
     // General properties
-    newRb->x = this->x;
-    newRb->y = this->y;
-    newRb->body_type = this->body_type;
-    newRb->precise = this->precise;
-    newRb->gravity_scale = this->gravity_scale;
-    newRb->density = this->density;
-    newRb->angular_friction = this->angular_friction;
-    newRb->rotation = this->rotation;
+    this->x = other.x;
+    this->y = other.y;
+    this->body_type = other.body_type;
+    this->precise = other.precise;
+    this->gravity_scale = other.gravity_scale;
+    this->density = other.density;
+    this->angular_friction = other.angular_friction;
+    this->rotation = other.rotation;
     // Collider properties
-    newRb->has_collider = this->has_collider;
-    newRb->collider_type = this->collider_type;
-    newRb->width = this->width;
-    newRb->height = this->height;
-    newRb->radius = this->radius;
-    newRb->friction = this->friction;
-    newRb->bounciness = this->bounciness;
+    this->has_collider = other.has_collider;
+    this->collider_type = other.collider_type;
+    this->width = other.width;
+    this->height = other.height;
+    this->radius = other.radius;
+    this->friction = other.friction;
+    this->bounciness = other.bounciness;
     // Trigger properties
-    newRb->has_trigger = this->has_trigger;
-    newRb->trigger_type = this->trigger_type;
-    newRb->trigger_width = this->trigger_width;
-    newRb->trigger_height = this->trigger_height;
-    newRb->trigger_radius = this->trigger_radius;
-
-    assert(!newRb->initialized());
-    return newRb;
+    this->has_trigger = other.has_trigger;
+    this->trigger_type = other.trigger_type;
+    this->trigger_width = other.trigger_width;
+    this->trigger_height = other.trigger_height;
+    this->trigger_radius = other.trigger_radius;
 }
 
 void Rigidbody::setValues(const std::vector<std::pair<std::string, ComponentValueType>> &values) {
@@ -308,6 +325,34 @@ b2Vec2 Rigidbody::GetRightDirection() {
     return b2Vec2{x, y};
 }
 
+b2Vec2 Rigidbody::GetRenderPosition() {
+    if (this->body_ == nullptr) {
+        return b2Vec2{this->x, this->y};
+    }
+
+    return this->renderPosition_;
+}
+
+float Rigidbody::GetRenderRotation() {
+    if (this->body_ == nullptr) {
+        return this->rotation;
+    }
+
+    return degreesOfRadians(this->renderAngle_);
+}
+
+void Rigidbody::beginStep() {
+    this->stepStartPosition_ = this->body_->GetPosition();
+    this->stepStartAngle_ = this->body_->GetAngle();
+}
+
+void Rigidbody::interpolate(float alpha) {
+    const auto &start = this->stepStartPosition_;
+    this->renderPosition_ = start + alpha * (this->body_->GetPosition() - start);
+    this->renderAngle_ =
+        this->stepStartAngle_ + alpha * (this->body_->GetAngle() - this->stepStartAngle_);
+}
+
 void Rigidbody::AddForce(const b2Vec2 &f) {
     if (this->body_ == nullptr) {
         return;
@@ -332,6 +377,9 @@ void Rigidbody::SetPosition(const b2Vec2 &position) {
     }
 
     this->body_->SetTransform(position, this->body_->GetAngle());
+    // Teleport rather than slide there
+    this->beginStep();
+    this->interpolate(0.0F);
 }
 
 void Rigidbody::SetRotation(float degreesClockwise) {
@@ -342,6 +390,8 @@ void Rigidbody::SetRotation(float degreesClockwise) {
 
     auto angleRadians = radiansOfDegrees(degreesClockwise);
     this->body_->SetTransform(this->body_->GetPosition(), angleRadians);
+    this->beginStep();
+    this->interpolate(0.0F);
 }
 
 void Rigidbody::SetAngularVelocity(float w) {
@@ -29,6 +29,7 @@ public:
     std::unique_ptr<Component> clone() const override;
     void initialize() override;
     void setValues(const std::vector<std::pair<std::string, ComponentValueType>> &values) override;
+    bool reset(const Component &prototype) override;
 
     b2Vec2 GetPosition();
     float GetRotation();
@@ -47,6 +48,23 @@ public:
     void SetUpDirection(b2Vec2 dir);
     void SetRightDirection(b2Vec2 dir);
 
+    /**
+     * @brief Position and rotation to draw the body at, blended between the
+     * last two physics steps so that it moves smoothly between them.
+     */
+    b2Vec2 GetRenderPosition();
+    float GetRenderRotation();
+
+    /**
+     * @brief Remember where the body is before the world steps.
+     */
+    void beginStep();
+    /**
+     * @brief Blend the transforms before and after the last step by alpha, the
+     * fraction of a step that has passed since it.
+     */
+    void interpolate(float alpha);
+
     scripting::OpaqueComponentPointer __opaquePointer;
 
     float x{0.0F}, y{0.0F};
@@ -70,6 +88,7 @@ public:
     float trigger_radius{0.5F};
 
 private:
+    void copyValues(const Rigidbody &other);
     void initializeColliderFixture();
     void initializeTriggerFixture();
     void initializeDefaultFixture();
@@ -77,6 +96,12 @@ private:
     luabridge::LuaRef ref_;
     b2World* world_;
     b2BodyPtr body_{nullptr};
+
+    // Transform before the last step, and the one to render
+    b2Vec2 stepStartPosition_{0.0F, 0.0F};
+    float stepStartAngle_{0.0F};
+    b2Vec2 renderPosition_{0.0F, 0.0F};
+    float renderAngle_{0.0F};
 };
 
 // NOLINTEND(readability-identifier-naming)
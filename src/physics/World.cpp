@@ -4,6 +4,7 @@
 
 #include "physics/Raycast.hpp"
 #include "physics/Rigidbody.hpp"
+#include "util/Trace.hpp"
 
 #include <algorithm>
 #include <functional>
@@ -51,15 +52,29 @@ std::unique_ptr<Rigidbody> World::newRigidbody() {
     return std::make_unique<Rigidbody>(this->world_.get());
 }
 
-void World::step() {
+void World::step(float dt) {
     if (this->world_ == nullptr) {
         return;
     }
 
-    constexpr auto TimeStep = 1.0F / 60.0F;
+    TRACE_ZONE("Physics.Step");
     constexpr auto VelocityIterations = 8;
     constexpr auto PositionIterations = 3;
-    this->world_->Step(TimeStep, VelocityIterations, PositionIterations);
+    for (auto* body = this->world_->GetBodyList(); body != nullptr; body = body->GetNext()) {
+        RigidbodyOfBody(body)->beginStep();
+    }
+    this->world_->Step(dt, VelocityIterations, PositionIterations);
+}
+
+void World::interpolate(float alpha) {
+    if (this->world_ == nullptr) {
+        return;
+    }
+
+    TRACE_ZONE("Physics.Interpolate");
+    for (auto* body = this->world_->GetBodyList(); body != nullptr; body = body->GetNext()) {
+        RigidbodyOfBody(body)->interpolate(alpha);
+    }
 }
 
 void World::enableCollisionReporting() {
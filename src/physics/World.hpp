@@ -17,12 +17,27 @@ inline game::Actor* ActorPointerOfFixture(b2Fixture* fixture) {
     // NOLINTEND(performance-no-int-to-ptr)
 }
 
+inline Rigidbody* RigidbodyOfBody(b2Body* body) {
+    // NOLINTBEGIN(performance-no-int-to-ptr)
+    return reinterpret_cast<Rigidbody*>(body->GetUserData().pointer);
+    // NOLINTEND(performance-no-int-to-ptr)
+}
+
 class World {
 public:
     World(b2ContactListener* contactListener);
     ~World();
 
-    void step();
+    /**
+     * @brief Advance the simulation by dt seconds.
+     */
+    void step(float dt);
+    /**
+     * @brief Blend every body's rendered transform between the last two steps.
+     *
+     * @param alpha Fraction of a step that has passed since the last one.
+     */
+    void interpolate(float alpha);
     void enableCollisionReporting();
     void disableCollisionReporting();
 
@@ -28,9 +28,25 @@ GameConfig LoadGameConfig() {
     rapidjson::Document doc;
     ReadJsonFile(GameConfigPath, doc);
 
+    auto physicsRate = GetKeySafe<unsigned int>(doc, "physics_rate").value_or(DefaultPhysicsRate);
+    if (physicsRate == 0 || physicsRate > MaxPhysicsRate) {
+        std::cout << "error: " << GameConfigPath.string() << ": "
+                  << "physics_rate must be between 1 and " << MaxPhysicsRate << std::endl;
+        std::exit(0);
+    }
+    auto physicsMaxSubsteps =
+        GetKeySafe<unsigned int>(doc, "physics_max_substeps").value_or(DefaultPhysicsMaxSubsteps);
+    if (physicsMaxSubsteps == 0) {
+        std::cout << "error: " << GameConfigPath.string() << ": "
+                  << "physics_max_substeps must be greater than zero" << std::endl;
+        std::exit(0);
+    }
+
     return GameConfig{
         .window_title = GetKeyOrZero<std::string>(doc, "window_title"),
         .font = GetKeyOrZero<std::string>(doc, "font"),
+        .physics_rate = physicsRate,
+        .physics_max_substeps = physicsMaxSubsteps,
     };
 }
 
@@ -52,12 +68,28 @@ ServerConfig LoadServerConfig() {
 
     return ServerConfig{
         .tick_rate = GetKeySafe<unsigned int>(doc, "tick_rate").value_or(DefaultServerTickRate),
+        .tick_overrun_policy =
+            util::TickOverrunPolicyOfString(GetKeyOrZero<std::string>(doc, "tick_overrun_policy")),
+        .tick_spin_us =
+            GetKeySafe<unsigned int>(doc, "tick_spin_us").value_or(DefaultServerTickSpinUs),
 
         .port = GetKeySafe<int>(doc, "port").value_or(DefaultServerPort),
         .io_workers = GetKeySafe<unsigned int>(doc, "io_workers").value_or(DefaultServerIoWorkers),
         .empty_behavior =
             ServerEmptyBehaviorOfString(GetKeyOrZero<std::string>(doc, "empty_behavior")),
 
+        .tick_threads =
+            GetKeySafe<unsigned int>(doc, "tick_threads").value_or(DefaultServerTickThreads),
+        .max_rooms = GetKeySafe<unsigned int>(doc, "max_rooms").value_or(DefaultServerMaxRooms),
+        .stats_interval = GetKeyOrZero<unsigned int>(doc, "stats_interval"),
+
+        .lua_gc_mode = scripting::LuaGcModeOfString(GetKeyOrZero<std::string>(doc, "lua_gc_mode")),
+        .lua_gc_budget_us = GetKeySafe<unsigned int>(doc, "lua_gc_budget_us")
+                                .value_or(DefaultServerLuaGcBudgetUs),
+        .lua_gc_emergency_mb = GetKeySafe<unsigned int>(doc, "lua_gc_emergency_mb")
+                                   .value_or(DefaultServerLuaGcEmergencyMb),
+        .lua_profile_slow_tick_ms = GetKeyOrZero<unsigned int>(doc, "lua_profile_slow_tick_ms"),
+
         .initial_scene = std::move(*initialScene),
     };
 }
@@ -2,6 +2,9 @@
 
 #include <glm/glm.hpp>
 
+#include "scripting/GcController.hpp"
+#include "util/TickScheduler.hpp"
+
 #include <optional>
 #include <string>
 #include <string_view>
@@ -11,12 +14,27 @@ namespace sge::resources {
 constexpr unsigned int DefaultXResolution = 640;
 constexpr unsigned int DefaultYResolution = 360;
 constexpr unsigned int DefaultServerTickRate = 60;
+constexpr unsigned int MaxServerTickRate = 1000;
+constexpr unsigned int DefaultServerTickSpinUs = 500;
 constexpr unsigned int DefaultServerIoWorkers = 1;
+constexpr unsigned int DefaultServerTickThreads = 1;
+constexpr unsigned int DefaultServerMaxRooms = 64;
 constexpr int DefaultServerPort = 7462;
+constexpr unsigned int DefaultServerLuaGcBudgetUs = 2000;
+constexpr unsigned int DefaultServerLuaGcEmergencyMb = 256;
+constexpr unsigned int DefaultPhysicsRate = 60;
+constexpr unsigned int MaxPhysicsRate = 1000;
+constexpr unsigned int DefaultPhysicsMaxSubsteps = 8;
 
 struct GameConfig {
     std::string window_title;
     std::string font;
+
+    // Fixed physics steps per second, independent of the frame or tick rate
+    unsigned int physics_rate;
+    // Maximum physics steps run in one update. Time beyond this is dropped so a
+    // slow frame can't make the next frame even slower.
+    unsigned int physics_max_substeps;
 };
 
 struct RenderingConfig {
@@ -51,11 +69,33 @@ constexpr ServerEmptyBehavior ServerEmptyBehaviorOfString(std::string_view s) {
 
 struct ServerConfig {
     unsigned int tick_rate;
+    // What to do when a tick runs past the start of the next one
+    util::TickOverrunPolicy tick_overrun_policy;
+    // Microseconds before each tick deadline to stop sleeping and spin instead
+    unsigned int tick_spin_us;
 
     int port;
     unsigned int io_workers;
     ServerEmptyBehavior empty_behavior;
 
+    // Number of threads that rooms are spread across for ticking
+    unsigned int tick_threads;
+    // Maximum number of rooms hosted at once, including the default room
+    unsigned int max_rooms;
+    // Seconds between room/thread statistics reports. Zero disables reporting.
+    unsigned int stats_interval;
+
+    // Lua collector of each room, which only runs in the idle time between ticks
+    scripting::LuaGcMode lua_gc_mode;
+    // Most microseconds of each tick's idle time spent collecting per room
+    unsigned int lua_gc_budget_us;
+    // Lua heap size in MiB at which a room runs a full collection right away.
+    // Zero disables it.
+    unsigned int lua_gc_emergency_mb;
+    // Tick time in milliseconds above which a room writes a Lua profile of the
+    // tick. Zero disables it, and with it profiling every tick.
+    unsigned int lua_profile_slow_tick_ms;
+
     std::string initial_scene;
 };
 
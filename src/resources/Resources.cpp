@@ -12,6 +12,7 @@
 #include "gea/AudioHelper.h"
 #include "resources/Deserialize.hpp"
 #include "util/HeterogeneousLookup.hpp"
+#include "util/Symbol.hpp"
 
 #include <cassert>
 #include <cstdlib>
@@ -19,9 +20,10 @@
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 #include <utility>
 
 namespace sge::resources {
@@ -31,7 +33,7 @@ namespace {
 ComponentDefinition deserializeComponentDefinition(const rapidjson::Value::ConstObject &obj) {
     ComponentDefinition def;
 
-    def.type = GetKeyOrZero<std::string>(obj, "type");
+    def.type = util::Intern(GetKeyOrZero<std::string>(obj, "type"));
 
     auto realmStr = GetKeySafe<std::string>(obj, "realm");
     if (realmStr.has_value()) {
@@ -77,15 +79,19 @@ void EnsureResourcesDirectoryExists() {
 }
 
 void DeserializeActor(const rapidjson::Value::ConstObject &doc, ActorDescription &actor) {
-    actor.template_name = GetKeySafe<std::string>(doc, "template");
-    actor.name = GetKeySafe<std::string>(doc, "name");
+    if (auto templateName = GetKeySafe<std::string>(doc, "template")) {
+        actor.template_name = util::Intern(*templateName);
+    }
+    if (auto name = GetKeySafe<std::string>(doc, "name")) {
+        actor.name = util::Intern(*name);
+    }
     actor.deferServerDestroys = GetKeyOrZero<bool>(doc, "defer_server_destroys");
 
     auto components = GetObjectSafe(doc, "components");
     if (components.has_value()) {
         for (const auto &member : *components) {
             actor.components.insert({
-                member.name.GetString(),
+                util::Intern(member.name.GetString()),
                 deserializeComponentDefinition(member.value.GetObject()),
             });
         }
@@ -120,11 +126,15 @@ SDL_Rect Image::rect() const {
     return SDL_Rect{0, 0, this->width_, this->height_};
 }
 
-unordered_string_map<ActorTemplateDescription> LoadedActorTemplates;
-unordered_string_map<SceneDescription> LoadedScenes;
-unordered_string_map<Mix_Chunk*> LoadedAudio;
+// Template and scene descriptions are shared by every game in the process, which
+// may be running on different threads. They are boxed so that references handed
+// out stay valid while other descriptions are loaded.
+std::mutex LoadedDescriptionsMutex;
+flat_string_map<std::unique_ptr<ActorTemplateDescription>> LoadedActorTemplates;
+flat_string_map<std::unique_ptr<SceneDescription>> LoadedScenes;
+flat_string_map<Mix_Chunk*> LoadedAudio;
 std::map<std::pair<std::string, int>, TTF_Font*, std::less<>> LoadedFonts;
-unordered_string_map<Image> LoadedImages;
+flat_string_map<Image> LoadedImages;
 
 ActorTemplateDescription LoadActorTemplate(std::string_view name) {
     auto nameWithExtension = std::string(name) + ".template";
@@ -138,13 +148,14 @@ ActorTemplateDescription LoadActorTemplate(std::string_view name) {
     rapidjson::Document doc;
     ReadJsonFile(scenePath, doc);
 
-    actor.name = GetKeyOrZero<std::string>(doc, "name");
+    actor.name = util::Intern(GetKeyOrZero<std::string>(doc, "name"));
     actor.deferServerDestroys = GetKeyOrZero<bool>(doc, "defer_server_destroys");
+    actor.pooled = GetKeyOrZero<bool>(doc, "pooled");
     auto components = GetObjectSafe(doc, "components");
     if (components.has_value()) {
         for (const auto &member : *components) {
             actor.components.insert({
-                member.name.GetString(),
+                util::Intern(member.name.GetString()),
                 deserializeComponentDefinition(member.value.GetObject()),
             });
         }
@@ -154,18 +165,19 @@ ActorTemplateDescription LoadActorTemplate(std::string_view name) {
 }
 
 const ActorTemplateDescription &GetActorTemplateDescription(std::string_view name) {
+    std::lock_guard guard(LoadedDescriptionsMutex);
     auto it = LoadedActorTemplates.find(name);
     if (it != LoadedActorTemplates.end()) {
         // Template has already been loaded
-        return it->second;
+        return *it->second;
     }
 
     // Load requested template and insert into cache
-    auto scene = LoadActorTemplate(name);
-    auto inserted = LoadedActorTemplates.insert({std::string{name}, std::move(scene)});
+    auto actorTemplate = std::make_unique<ActorTemplateDescription>(LoadActorTemplate(name));
+    const auto &loaded = *actorTemplate;
+    LoadedActorTemplates.insert({std::string{name}, std::move(actorTemplate)});
 
-    // Return reference to inserted node
-    return inserted.first->second;
+    return loaded;
 }
 
 SceneDescription LoadSceneDescription(std::string_view name) {
@@ -194,18 +206,19 @@ SceneDescription LoadSceneDescription(std::string_view name) {
 }
 
 const SceneDescription &GetSceneDescription(std::string_view name) {
+    std::lock_guard guard(LoadedDescriptionsMutex);
     auto it = LoadedScenes.find(name);
     if (it != LoadedScenes.end()) {
         // Scene has already been loaded
-        return it->second;
+        return *it->second;
     }
 
     // Load requested scene and insert into cache
-    auto scene = LoadSceneDescription(name);
-    auto inserted = LoadedScenes.insert({std::string{name}, std::move(scene)});
+    auto scene = std::make_unique<SceneDescription>(LoadSceneDescription(name));
+    const auto &loaded = *scene;
+    LoadedScenes.insert({std::string{name}, std::move(scene)});
 
-    // Return reference to inserted node
-    return inserted.first->second;
+    return loaded;
 }
 
 Mix_Chunk* MaybeLoadAudio(std::string_view name) {
@@ -310,7 +323,7 @@ const Image &GetImage(std::string_view name) {
     auto img = Image{texture};
     auto inserted = LoadedImages.insert({std::string{name}, img});
 
-    return inserted.first->second;
+    return (*inserted)->second;
 }
 
 } // namespace sge::resources
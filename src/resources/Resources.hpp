@@ -9,6 +9,7 @@
 
 #include "Realm.hpp"
 #include "resources/Deserialize.hpp"
+#include "util/Symbol.hpp"
 
 #include <filesystem>
 #include <map>
@@ -37,26 +38,30 @@ const auto ImagesDirectoryPath = ResourcesDirectoryPath / "images";
 const auto FontsDirectoryPath = ResourcesDirectoryPath / "fonts";
 const auto AudioDirectoryPath = ResourcesDirectoryPath / "audio";
 const auto ComponentTypesPath = ResourcesDirectoryPath / "component_types";
+// Compiled component types, written by the engine
+const auto LuaChunkCachePath = ResourcesDirectoryPath / ".cache" / "lua";
 
 struct ComponentDefinition {
-    std::string type{};
+    util::Symbol type{};
     Realm realm{Realm::Server};
     std::vector<std::pair<std::string, ComponentValueType>> values{};
 };
 
 struct ActorDescription {
-    std::optional<std::string> template_name{};
-    std::optional<std::string> name{};
+    std::optional<util::Symbol> template_name{};
+    std::optional<util::Symbol> name{};
     std::optional<bool> deferServerDestroys{};
-    std::map<std::string, ComponentDefinition> components{};
+    std::map<util::Symbol, ComponentDefinition> components{};
 };
 
 void DeserializeActor(const rapidjson::Value::ConstObject &doc, ActorDescription &actor);
 
 struct ActorTemplateDescription {
-    std::string name;
+    util::Symbol name;
     bool deferServerDestroys{false};
-    std::map<std::string, ComponentDefinition> components{};
+    // Recycle the components of destroyed actors for new ones
+    bool pooled{false};
+    std::map<util::Symbol, ComponentDefinition> components{};
 };
 
 class Image {
@@ -2,46 +2,93 @@
 
 #include "resources/Resources.hpp"
 #include "scripting/Component.hpp"
-#include "util/HeterogeneousLookup.hpp"
+#include "scripting/ComponentContainer.hpp"
+#include "scripting/Environment.hpp"
+#include "scripting/TemplatePool.hpp"
+#include "scripting/components/TransformPool.hpp"
+#include "util/Arena.hpp"
+#include "util/Symbol.hpp"
 
-#include <map>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace sge::scripting {
 
 ActorTemplate::ActorTemplate(const resources::ActorTemplateDescription &description)
-    : name_(description.name) {
-    for (const auto &componentDescription : description.components) {
-        auto component = InstantiateComponent(componentDescription.second.type,
-                                              componentDescription.second.realm);
-        component->setValues(componentDescription.second.values);
-        this->components_.insert({componentDescription.first, std::move(component)});
+    : name_(description.name)
+    , deferServerDestroys_(description.deferServerDestroys)
+    , pooled_(description.pooled) {
+    this->components_.reserve(description.components.size());
+    for (const auto &[key, definition] : description.components) {
+        auto component = InstantiateComponent(definition.type, definition.realm);
+        component->setValues(definition.values);
+        this->components_.push_back(Prototype{key, std::move(component)});
     }
+    std::sort(this->components_.begin(), this->components_.end(),
+              [](const Prototype &a, const Prototype &b) {
+                  return a.key.str() < b.key.str();
+              });
 }
 
-const std::string &ActorTemplate::name() const {
+util::Symbol ActorTemplate::name() const {
     return this->name_;
 }
 
-const std::map<std::string, std::unique_ptr<Component>> &ActorTemplate::components() const {
+bool ActorTemplate::deferServerDestroys() const {
+    return this->deferServerDestroys_;
+}
+
+bool ActorTemplate::pooled() const {
+    return this->pooled_;
+}
+
+const std::vector<ActorTemplate::Prototype> &ActorTemplate::components() const {
     return this->components_;
 }
 
-unordered_string_map<ActorTemplate> LoadedActorTemplateInstances;
+void ActorTemplate::instantiateComponents(game::Actor &actor, ComponentContainer &components,
+                                          TemplatePool &pool) const {
+    std::optional<TemplatePool::RecycledComponents> recycled;
+    if (this->pooled_) {
+        recycled = pool.take(*this);
+        assert(!recycled.has_value() || recycled->size() == this->components_.size());
+    }
+
+    components.reserve(this->components_.size());
+    for (std::size_t i = 0; i < this->components_.size(); ++i) {
+        const auto &prototype = this->components_[i];
+        auto component =
+            recycled.has_value() ? std::move((*recycled)[i]) : prototype.component->clone();
+        component->setActor(&actor);
+        component->setKey(prototype.key);
+        component->setEnabled(true);
+        components.appendComponent(std::move(component));
+    }
+}
 
-const ActorTemplate &GetActorTemplateInstance(std::string_view name) {
-    auto it = LoadedActorTemplateInstances.find(name);
-    if (it != LoadedActorTemplateInstances.end()) {
+const ActorTemplate &GetActorTemplateInstance(util::Symbol name) {
+    // Template instances hold components bound to a Lua state, so they are
+    // cached per scripting environment.
+    auto &loadedActorTemplateInstances = CurrentEnvironment().actorTemplates();
+    auto it = loadedActorTemplateInstances.find(name);
+    if (it != loadedActorTemplateInstances.end()) {
         return it->second;
     }
 
-    auto actorTemplate = ActorTemplate{resources::GetActorTemplateDescription(name)};
-    auto inserted =
-        LoadedActorTemplateInstances.insert({std::string{name}, std::move(actorTemplate)});
+    // Template instances outlive scenes, so keep their components out of the
+    // arena and transform pool of the scene that happens to load the template
+    util::ArenaScope heap{nullptr};
+    TransformPoolScope detached{nullptr};
+    auto actorTemplate = ActorTemplate{resources::GetActorTemplateDescription(name.str())};
+    auto inserted = loadedActorTemplateInstances.insert({name, std::move(actorTemplate)});
     return inserted.first->second;
 }
 
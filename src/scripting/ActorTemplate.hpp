@@ -2,16 +2,37 @@
 
 #include "resources/Resources.hpp"
 #include "scripting/Component.hpp"
+#include "scripting/ComponentContainer.hpp"
+#include "util/Symbol.hpp"
 
-#include <map>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
-namespace sge::scripting {
+namespace sge {
 
+namespace game {
+class Actor;
+}
+
+namespace scripting {
+
+class TemplatePool;
+
+/**
+ * @brief An actor template compiled into a blueprint for instantiating actors:
+ * its components are instantiated and have their values applied once, up front,
+ * and are kept in the order that ComponentContainer stores them in. Creating an
+ * actor's components from the template only clones these prototypes.
+ */
 class ActorTemplate {
 public:
+    struct Prototype {
+        util::Symbol key;
+        std::unique_ptr<Component> component;
+    };
+
     ActorTemplate(const resources::ActorTemplateDescription &description);
 
     ActorTemplate(const ActorTemplate &) = delete;
@@ -20,14 +41,32 @@ public:
     ActorTemplate(ActorTemplate &&) = default;
     ActorTemplate &operator=(ActorTemplate &&) = default;
 
-    const std::string &name() const;
-    const std::map<std::string, std::unique_ptr<Component>> &components() const;
+    util::Symbol name() const;
+    bool deferServerDestroys() const;
+    bool pooled() const;
+    const std::vector<Prototype> &components() const;
+
+    /**
+     * @brief Clone the template's components for an actor, or reuse recycled
+     * ones if the template is pooled.
+     *
+     * @param actor Actor the components belong to.
+     * @param components Empty container to add the components to.
+     * @param pool Pool of the actor's scene.
+     */
+    void instantiateComponents(game::Actor &actor, ComponentContainer &components,
+                               TemplatePool &pool) const;
 
 private:
-    std::string name_;
-    std::map<std::string, std::unique_ptr<Component>> components_;
+    util::Symbol name_;
+    bool deferServerDestroys_;
+    bool pooled_;
+    // Sorted by key, in container order
+    std::vector<Prototype> components_;
 };
 
-const ActorTemplate &GetActorTemplateInstance(std::string_view name);
+const ActorTemplate &GetActorTemplateInstance(util::Symbol name);
+
+} // namespace scripting
 
-} // namespace sge::scripting
+} // namespace sge
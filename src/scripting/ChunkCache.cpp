@@ -0,0 +1,188 @@
+#include "scripting/ChunkCache.hpp"
+
+#include <lua/lua.hpp>
+
+#include "resources/Resources.hpp"
+#include "util/Trace.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace sge::scripting {
+
+namespace {
+
+// Start of every cache file, followed by the source hash and the bytecode
+constexpr std::string_view CacheFileMagic = "SGELUAC1";
+constexpr std::size_t CacheFileHeaderSize = CacheFileMagic.size() + sizeof(std::uint64_t);
+
+std::uint64_t hashSource(std::string_view source) {
+    // FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char c : source) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::optional<std::string> readFile(const std::filesystem::path &path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        return std::nullopt;
+    }
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+int writeChunk(lua_State* /*unused*/, const void* p, std::size_t size, void* ud) {
+    static_cast<std::string*>(ud)->append(static_cast<const char*>(p), size);
+    return 0;
+}
+
+// Rooms on other threads, and other processes, may write the same cache file
+// at the same time, so each write gets its own temporary file
+std::string temporarySuffix() {
+    static const auto processToken = std::random_device{}();
+    static std::atomic<std::uint64_t> nextWrite{0};
+    return ".tmp" + std::to_string(processToken) + "-" +
+           std::to_string(nextWrite.fetch_add(1, std::memory_order_relaxed));
+}
+
+} // namespace
+
+ChunkCache::ChunkCache(std::filesystem::path directory)
+    : directory_(std::move(directory)) {}
+
+int ChunkCache::load(lua_State* L, const std::filesystem::path &path) {
+    TRACE_ZONE("Lua.LoadChunk");
+    auto source = readFile(path);
+    if (!source.has_value()) {
+        // Let Lua report the error
+        return luaL_loadfile(L, path.string().c_str());
+    }
+
+    const auto key = path.string();
+    const auto chunkName = "@" + key;
+    const auto sourceHash = hashSource(*source);
+
+    auto chunk = this->find(key, sourceHash);
+    if (chunk == nullptr) {
+        chunk = this->readCacheFile(path, sourceHash);
+        if (chunk != nullptr) {
+            this->store(key, chunk);
+        }
+    }
+    if (chunk != nullptr) {
+        if (luaL_loadbufferx(L, chunk->bytecode.data(), chunk->bytecode.size(), chunkName.c_str(),
+                             "b") == LUA_OK) {
+            return LUA_OK;
+        }
+        // Bytecode from a different Lua build, so compile from source instead
+        lua_pop(L, 1);
+    }
+
+    if (auto status = luaL_loadbufferx(L, source->data(), source->size(), chunkName.c_str(), "t");
+        status != LUA_OK) {
+        return status;
+    }
+
+    // Keep debug information, so errors still carry file names and lines
+    auto compiled = std::make_shared<Chunk>(Chunk{.sourceHash = sourceHash, .bytecode = {}});
+    if (lua_dump(L, writeChunk, &compiled->bytecode, 0) == 0) {
+        this->writeCacheFile(path, *compiled);
+        this->store(key, std::move(compiled));
+    }
+    return LUA_OK;
+}
+
+std::shared_ptr<const ChunkCache::Chunk> ChunkCache::find(const std::string &path,
+                                                          std::uint64_t sourceHash) {
+    std::lock_guard lock{this->mu_};
+    auto it = this->chunks_.find(path);
+    if (it == this->chunks_.end() || it->second->sourceHash != sourceHash) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void ChunkCache::store(const std::string &path, std::shared_ptr<const Chunk> chunk) {
+    std::lock_guard lock{this->mu_};
+    this->chunks_.insert_or_assign(path, std::move(chunk));
+}
+
+std::filesystem::path ChunkCache::cachePath(const std::filesystem::path &path) const {
+    auto name = path.filename();
+    name += ".luac";
+    return this->directory_ / name;
+}
+
+std::shared_ptr<const ChunkCache::Chunk>
+ChunkCache::readCacheFile(const std::filesystem::path &path, std::uint64_t sourceHash) const {
+    auto contents = readFile(this->cachePath(path));
+    if (!contents.has_value() || contents->size() <= CacheFileHeaderSize ||
+        !contents->starts_with(CacheFileMagic)) {
+        return nullptr;
+    }
+
+    std::uint64_t fileHash = 0;
+    std::memcpy(&fileHash, contents->data() + CacheFileMagic.size(), sizeof(fileHash));
+    if (fileHash != sourceHash) {
+        return nullptr;
+    }
+
+    contents->erase(0, CacheFileHeaderSize);
+    return std::make_shared<Chunk>(Chunk{.sourceHash = sourceHash, .bytecode = *std::move(contents)});
+}
+
+void ChunkCache::writeCacheFile(const std::filesystem::path &path, const Chunk &chunk) const {
+    // The cache is only an optimization, so failing to write it is not an error
+    std::error_code ec;
+    std::filesystem::create_directories(this->directory_, ec);
+    if (ec) {
+        return;
+    }
+
+    // Write to a temporary file and rename it into place, so that another
+    // process loading the same file never reads a partial chunk
+    const auto target = this->cachePath(path);
+    auto temporary = target;
+    temporary += temporarySuffix();
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+        if (!file) {
+            return;
+        }
+        file.write(CacheFileMagic.data(), static_cast<std::streamsize>(CacheFileMagic.size()));
+        file.write(reinterpret_cast<const char*>(&chunk.sourceHash), sizeof(chunk.sourceHash));
+        file.write(chunk.bytecode.data(), static_cast<std::streamsize>(chunk.bytecode.size()));
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temporary, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, target, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+    }
+}
+
+ChunkCache &LuaChunks() {
+    static ChunkCache chunks{resources::LuaChunkCachePath};
+    return chunks;
+}
+
+} // namespace sge::scripting
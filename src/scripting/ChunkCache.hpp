@@ -0,0 +1,67 @@
+#pragma once
+
+#include <lua/lua.hpp>
+
+#include "util/HeterogeneousLookup.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace sge::scripting {
+
+/**
+ * @brief Caches Lua source files compiled to bytecode (lua_dump output), so
+ * each file is parsed and compiled once rather than once per Lua state that
+ * loads it.
+ *
+ * Compiled chunks are kept in memory for every state in the process and
+ * written to a cache directory for later runs. They are keyed by a hash of the
+ * source, so an edited file is simply compiled again. Safe to use from any
+ * thread.
+ */
+class ChunkCache {
+public:
+    explicit ChunkCache(std::filesystem::path directory);
+
+    ChunkCache(const ChunkCache &) = delete;
+    ChunkCache &operator=(const ChunkCache &) = delete;
+
+    /**
+     * @brief Load a Lua source file as a function onto the top of the stack,
+     * like luaL_loadfile.
+     *
+     * @return LUA_OK, or the error from loading the file with the error message
+     * left on the stack instead of the function.
+     */
+    int load(lua_State* L, const std::filesystem::path &path);
+
+private:
+    struct Chunk {
+        std::uint64_t sourceHash;
+        std::string bytecode;
+    };
+
+    std::shared_ptr<const Chunk> find(const std::string &path, std::uint64_t sourceHash);
+    void store(const std::string &path, std::shared_ptr<const Chunk> chunk);
+
+    std::filesystem::path cachePath(const std::filesystem::path &path) const;
+    std::shared_ptr<const Chunk> readCacheFile(const std::filesystem::path &path,
+                                               std::uint64_t sourceHash) const;
+    void writeCacheFile(const std::filesystem::path &path, const Chunk &chunk) const;
+
+    std::filesystem::path directory_;
+
+    std::mutex mu_;
+    unordered_string_map<std::shared_ptr<const Chunk>> chunks_;
+};
+
+/**
+ * @brief Get the process-wide cache for compiled component types, which keeps
+ * its files in resources::LuaChunkCachePath. Created on first use.
+ */
+ChunkCache &LuaChunks();
+
+} // namespace sge::scripting
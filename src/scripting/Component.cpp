@@ -9,21 +9,25 @@
 #include "physics/Collision.hpp"
 #include "resources/Deserialize.hpp"
 #include "resources/Resources.hpp"
+#include "scripting/ChunkCache.hpp"
+#include "scripting/Environment.hpp"
 #include "scripting/Scripting.hpp"
 #include "scripting/components/InterpTransform.hpp"
 #include "scripting/components/LuaComponent.hpp"
 #include "scripting/components/Transform.hpp"
+#include "scripting/components/Velocity.hpp"
 #include "util/HeterogeneousLookup.hpp"
 
 #include <cassert>
+#include <charconv>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <memory>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -32,32 +36,100 @@ namespace sge::scripting {
 
 namespace {
 
-size_t RuntimeComponentCounter = 0;
-
-ComponentType loadComponentType(const std::filesystem::path &path, const std::string &name) {
+ComponentType loadComponentType(const std::filesystem::path &path, util::Symbol name) {
     assert(std::filesystem::exists(path));
     auto* state = GetGlobalState();
 
-    // Execute lua file to set global variable defining component
-    if (luaL_dofile(state, path.string().c_str()) != LUA_OK) {
+    // Execute lua file to set global variable defining component. The file is
+    // compiled once per process and loaded as bytecode by every other state.
+    if (LuaChunks().load(state, path) != LUA_OK || lua_pcall(state, 0, 0, 0) != LUA_OK) {
         std::cout << "problem with lua file " << path.stem().string() << std::endl;
         std::exit(0);
     }
 
     // Get reference to created component
-    auto componentRef = luabridge::LuaRef::getGlobal(state, name.c_str());
+    auto componentRef = luabridge::LuaRef::getGlobal(state, std::string{name.str()}.c_str());
     if (!componentRef.isTable()) {
         std::cout << "lua file " << path.string() << " does not define component table with name "
-                  << name << std::endl;
+                  << name.str() << std::endl;
         std::exit(0);
     }
 
     return ComponentType{componentRef, name};
 }
 
-} // namespace
+// __index of the global table while component types are pending. Reading the
+// global of a component type that hasn't been loaded yet loads it, so scripts
+// can refer to each other's tables as if every type had been loaded up front.
+// Any other read goes to the __index of the metatable the hook replaced, which
+// is its upvalue.
+int indexPendingComponentType(lua_State* L) {
+    if (lua_type(L, 2) == LUA_TSTRING &&
+        CurrentEnvironment().pendingComponentTypes().contains(lua_tostring(L, 2))) {
+        const auto &ref = FindComponentType(util::Intern(lua_tostring(L, 2)))->ref;
+        // LuaRef pushes onto the main thread, and L may be a coroutine
+        ref.push();
+        if (ref.state() != L) {
+            lua_xmove(ref.state(), L, 1);
+        }
+        return 1;
+    }
+    if (lua_type(L, lua_upvalueindex(1)) == LUA_TTABLE) {
+        lua_getfield(L, lua_upvalueindex(1), "__index");
+        if (lua_isfunction(L, -1)) {
+            lua_pushvalue(L, 1);
+            lua_pushvalue(L, 2);
+            lua_call(L, 2, 1);
+            return 1;
+        }
+        if (!lua_isnil(L, -1)) {
+            lua_pushvalue(L, 2);
+            lua_gettable(L, -2);
+            return 1;
+        }
+    }
+    lua_pushnil(L);
+    return 1;
+}
+
+void installPendingComponentTypeHook(lua_State* L) {
+    // Scripts may have given the global table a metatable of their own, e.g.
+    // a guard against undefined globals. The hook keeps its other fields, and
+    // chains to its __index.
+    lua_pushglobaltable(L);
+    lua_createtable(L, 0, 1);
+    if (lua_getmetatable(L, -2) != 0) {
+        lua_pushnil(L);
+        while (lua_next(L, -2) != 0) {
+            lua_pushvalue(L, -2);
+            lua_insert(L, -2);
+            lua_rawset(L, -5);
+        }
+    } else {
+        lua_pushnil(L);
+    }
+    lua_pushcclosure(L, indexPendingComponentType, 1);
+    lua_setfield(L, -2, "__index");
+    lua_setmetatable(L, -2);
+    lua_pop(L, 1);
+}
+
+void removePendingComponentTypeHook(lua_State* L) {
+    lua_pushglobaltable(L);
+    if (lua_getmetatable(L, -1) != 0) {
+        lua_getfield(L, -1, "__index");
+        // Put back the metatable the hook replaced, unless a script has
+        // replaced the hook since
+        if (lua_tocfunction(L, -1) == indexPendingComponentType) {
+            lua_getupvalue(L, -1, 1);
+            lua_setmetatable(L, -4);
+        }
+        lua_pop(L, 2);
+    }
+    lua_pop(L, 1);
+}
 
-unordered_string_map<ComponentType> ComponentTypes;
+} // namespace
 
 void InitializeComponentTypes() {
     if (!std::filesystem::exists(resources::ComponentTypesPath)) {
@@ -65,23 +137,92 @@ void InitializeComponentTypes() {
         return;
     }
 
+    auto &pending = CurrentEnvironment().pendingComponentTypes();
     auto it = std::filesystem::directory_iterator{resources::ComponentTypesPath};
     for (const auto &entry : it) {
-        auto name = entry.path().stem().string();
-        // Load component from file
-        ComponentTypes.insert({name, loadComponentType(entry.path(), name)});
+        pending.insert_or_assign(entry.path().stem().string(), entry.path());
+    }
+    if (!pending.empty()) {
+        installPendingComponentTypeHook(GetGlobalState());
+    }
+}
+
+const ComponentType* FindComponentType(util::Symbol name) {
+    auto &environment = CurrentEnvironment();
+    auto &componentTypes = environment.componentTypes();
+    if (auto it = componentTypes.find(name); it != componentTypes.end()) {
+        return &it->second;
     }
+
+    auto &pending = environment.pendingComponentTypes();
+    auto pendingIt = pending.find(name.str());
+    if (pendingIt == pending.end()) {
+        return nullptr;
+    }
+
+    // No longer pending before the file runs, so a script reading its own
+    // global before defining it doesn't load itself again
+    auto path = std::move(pendingIt->second);
+    pending.erase(pendingIt);
+    if (pending.empty()) {
+        removePendingComponentTypeHook(environment.state());
+    }
+
+    auto inserted = componentTypes.insert({name, loadComponentType(path, name)});
+    assert(inserted.has_value());
+    return &(*inserted)->second;
 }
 
-std::string NextRuntimeComponentKey() {
-    std::stringstream ss;
-    ss << 'r' << RuntimeComponentCounter;
-    ++RuntimeComponentCounter;
-    return ss.str();
+ComponentKey::ComponentKey(util::Symbol name)
+    : name_(name) {}
+
+ComponentKey ComponentKey::Runtime(std::size_t id) {
+    assert(id != 0);
+    ComponentKey key;
+    key.runtimeID_ = id;
+    return key;
 }
 
-Component::Component(std::string type, Realm realm)
-    : type(std::move(type))
+std::optional<ComponentKey> ComponentKey::ParseRuntime(std::string_view str) {
+    if (str.size() < 2 || str.front() != 'r') {
+        return std::nullopt;
+    }
+    std::size_t id = 0;
+    const auto* end = str.data() + str.size();
+    auto [ptr, ec] = std::from_chars(str.data() + 1, end, id);
+    if (ec != std::errc{} || ptr != end || id == 0) {
+        return std::nullopt;
+    }
+    return Runtime(id);
+}
+
+bool ComponentKey::runtime() const {
+    return this->runtimeID_ != 0;
+}
+
+std::string ComponentKey::str() const {
+    if (this->runtime()) {
+        return 'r' + std::to_string(this->runtimeID_);
+    }
+    return std::string{this->name_.str()};
+}
+
+bool ComponentKey::operator<(const ComponentKey &other) const {
+    if (this->runtime() != other.runtime()) {
+        return other.runtime();
+    }
+    if (this->runtime()) {
+        return this->runtimeID_ < other.runtimeID_;
+    }
+    return this->name_.str() < other.name_.str();
+}
+
+ComponentKey NextRuntimeComponentKey() {
+    return ComponentKey::Runtime(CurrentEnvironment().nextRuntimeComponentID());
+}
+
+Component::Component(util::Symbol type, Realm realm)
+    : type(type)
     , realm(realm) {
     switch (CurrentRealm()) {
     case GeneralRealm::Server:
@@ -98,13 +239,22 @@ void Component::setActor(game::Actor* actor) {
     this->actor = actor;
 }
 
-void Component::setKey(const std::string &key) {
+void Component::setKey(ComponentKey key) {
     this->key = key;
 }
 
 void Component::setValues(
     const std::vector<std::pair<std::string, ComponentValueType>> & /*unused*/) {}
 
+bool Component::reset(const Component & /*unused*/) {
+    return false;
+}
+
+void Component::resetLifecycle() {
+    this->actor = nullptr;
+    this->initialized_ = false;
+}
+
 bool Component::initialized() const {
     return this->initialized_;
 }
@@ -118,6 +268,22 @@ bool Component::lifecycleShouldRun() const {
     return this->initialized() && this->realmMatches_ && this->getEnabled();
 }
 
+bool Component::realmMatches() const {
+    return this->realmMatches_;
+}
+
+LifecycleMask Component::lifecycleHandlers() const {
+    return 0;
+}
+
+bool Component::parallelUpdate() const {
+    return false;
+}
+
+const luabridge::LuaRef* Component::luaFunction(Lifecycle /*unused*/) const {
+    return nullptr;
+}
+
 bool Component::lifecycleCanRunUnderActor() const {
     if (GameOffline()) {
         return true;
@@ -166,23 +332,30 @@ Component* RefToComponent(const luabridge::LuaRef &ref) {
     return keyRef.cast<OpaqueComponentPointer>().ptr;
 }
 
-std::unique_ptr<Component> InstantiateComponent(std::string_view type, Realm realm) {
-    if (type == "Rigidbody") {
+std::unique_ptr<Component> InstantiateComponent(util::Symbol type, Realm realm) {
+    static const auto RigidbodyType = util::Intern("Rigidbody");
+    static const auto TransformType = util::Intern("Transform");
+    static const auto InterpTransformType = util::Intern("InterpTransform");
+    static const auto VelocityType = util::Intern("Velocity");
+
+    if (type == RigidbodyType) {
         return CurrentGame().physicsWorld().newRigidbody();
-    } else if (type == "Transform") {
+    } else if (type == TransformType) {
         return std::make_unique<Transform>(realm);
-    } else if (type == "InterpTransform") {
+    } else if (type == InterpTransformType) {
         return std::make_unique<InterpTransform>(realm);
+    } else if (type == VelocityType) {
+        return std::make_unique<Velocity>(realm);
     }
 
-    auto it = ComponentTypes.find(type);
-    if (it == ComponentTypes.end()) {
-        std::cout << "error: failed to locate component " << type;
+    const auto* componentType = FindComponentType(type);
+    if (componentType == nullptr) {
+        std::cout << "error: failed to locate component " << type.str();
         std::exit(0);
     }
 
     // Instantiate lua component
-    return std::make_unique<LuaComponent>(it->second, realm);
+    return std::make_unique<LuaComponent>(*componentType, realm);
 }
 
 } // namespace sge::scripting
@@ -6,8 +6,12 @@
 #include "Realm.hpp"
 #include "physics/Collision.hpp"
 #include "resources/Deserialize.hpp"
+#include "util/Symbol.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -29,16 +33,87 @@ namespace scripting {
 
 struct ComponentType {
     luabridge::LuaRef ref;
-    std::string name;
+    util::Symbol name;
 };
 
+/**
+ * @brief Find the component types in resources::ComponentTypesPath for the
+ * current environment. Each is loaded on first use, either through
+ * FindComponentType or by a script reading the global it defines.
+ */
 void InitializeComponentTypes();
 
-std::string NextRuntimeComponentKey();
+/**
+ * @brief Get a component type of the current environment, loading it if it
+ * hasn't been loaded yet.
+ *
+ * @return The component type, or nullptr if there is none with the name. Valid
+ * until the next component type is loaded.
+ */
+const ComponentType* FindComponentType(util::Symbol name);
+
+/**
+ * @brief The key of a component within its actor. Components from templates
+ * are keyed by an interned name, while components added at runtime are
+ * numbered, so that adding components doesn't grow the symbol table.
+ */
+class ComponentKey {
+public:
+    constexpr ComponentKey() = default;
+    ComponentKey(util::Symbol name);
+
+    static ComponentKey Runtime(std::size_t id);
+
+    /**
+     * @brief Parse the key of a component added at runtime, as returned by
+     * str, without interning anything.
+     */
+    static std::optional<ComponentKey> ParseRuntime(std::string_view str);
+
+    bool runtime() const;
+    /**
+     * @brief The key as scripts see it. Components added at runtime are
+     * "r<N>".
+     */
+    std::string str() const;
+
+    bool operator==(const ComponentKey &other) const = default;
+    /**
+     * @brief Orders named keys by their strings, followed by runtime keys in
+     * the order they were made.
+     */
+    bool operator<(const ComponentKey &other) const;
+
+private:
+    util::Symbol name_{};
+    // Nonzero for components added at runtime
+    std::size_t runtimeID_{0};
+};
+
+ComponentKey NextRuntimeComponentKey();
+
+/**
+ * @brief Lifecycle functions that are dispatched only to the components that
+ * implement them.
+ */
+enum class Lifecycle : std::uint8_t {
+    OnUpdate,
+    OnLateUpdate,
+    OnCollisionEnter,
+    OnCollisionExit,
+    OnTriggerEnter,
+    OnTriggerExit,
+};
+
+using LifecycleMask = std::uint8_t;
+
+constexpr LifecycleMask LifecycleBit(Lifecycle lifecycle) {
+    return static_cast<LifecycleMask>(1U << static_cast<unsigned int>(lifecycle));
+}
 
 class Component {
 public:
-    Component(std::string type, Realm realm);
+    Component(util::Symbol type, Realm realm);
     virtual ~Component() = default;
 
     Component &operator=(const Component &other) = delete;
@@ -49,14 +124,48 @@ public:
     virtual const luabridge::LuaRef &ref() const = 0;
 
     virtual void setActor(game::Actor* actor);
-    virtual void setKey(const std::string &key);
+    virtual void setKey(ComponentKey key);
     virtual void setValues(const std::vector<std::pair<std::string, ComponentValueType>> &values);
 
+    /**
+     * @brief Return the component to the state it was in when cloned from a
+     * prototype, detached from any actor, so that a new actor of the same
+     * template can reuse it. Returns false if the component can't be reused.
+     *
+     * @param prototype Template component of the same type.
+     */
+    virtual bool reset(const Component &prototype);
+
     bool initialized() const;
     virtual void initialize();
 
     bool lifecycleShouldRun() const;
     bool lifecycleCanRunUnderActor() const;
+    bool realmMatches() const;
+
+    /**
+     * @brief Lifecycle functions implemented by the component. Only
+     * meaningful once the component is initialized.
+     */
+    virtual LifecycleMask lifecycleHandlers() const;
+
+    /**
+     * @brief Whether onUpdate may run on a job system worker, concurrently
+     * with the onUpdate of other such components and before any serial
+     * OnUpdate. It must then only write to its own state, or to a component
+     * of its actor that no other parallel component writes to: no Lua, no
+     * scene or actor changes, and no CurrentGame or other thread-local state.
+     * Decided once the component has started. Lua components never do.
+     */
+    virtual bool parallelUpdate() const;
+
+    /**
+     * @brief The Lua function implementing an update lifecycle function, if
+     * the component is scripted, so that the scene can call it directly with a
+     * ProtectedCall. Otherwise nullptr, and the scene calls the virtual
+     * function as usual.
+     */
+    virtual const luabridge::LuaRef* luaFunction(Lifecycle lifecycle) const;
 
     virtual bool getEnabled() const = 0;
     virtual void setEnabled(bool enabled) = 0;
@@ -74,12 +183,18 @@ public:
     virtual void replicatePush(net::ReplicatePush &);
     virtual void replicatePull(net::ReplicatePull &);
 
-    std::string type;
+    util::Symbol type;
     Realm realm;
     game::Actor* actor = nullptr;
-    std::string key{};
+    ComponentKey key{};
 
 protected:
+    /**
+     * @brief Detach the component from its actor and mark it uninitialized,
+     * so that it starts again with its next actor.
+     */
+    void resetLifecycle();
+
     bool initialized_ = false;
     bool realmMatches_ = false;
 };
@@ -92,7 +207,7 @@ constexpr const char* OpaqueComponentPointerKey = "__opaque_component";
 
 Component* RefToComponent(const luabridge::LuaRef &ref);
 
-std::unique_ptr<Component> InstantiateComponent(std::string_view type, Realm realm);
+std::unique_ptr<Component> InstantiateComponent(util::Symbol type, Realm realm);
 
 } // namespace scripting
 
@@ -122,3 +237,40 @@ struct luabridge::Stack<sge::scripting::Component*> {
         }
     }
 };
+
+template <>
+struct luabridge::Stack<sge::util::Symbol> {
+    static void push(lua_State* L, sge::util::Symbol symbol) {
+        luabridge::Stack<std::string_view>::push(L, symbol.str());
+    }
+
+    static sge::util::Symbol get(lua_State* L, int index) {
+        // Strings from scripts aren't interned. One that never was names
+        // nothing, so it reads as the empty symbol, which no key or type is.
+        auto symbol = sge::util::FindSymbol(luabridge::Stack<std::string_view>::get(L, index));
+        return symbol.value_or(sge::util::Symbol{});
+    }
+
+    static bool isInstance(lua_State* L, int index) {
+        return luabridge::Stack<std::string_view>::isInstance(L, index);
+    }
+};
+
+template <>
+struct luabridge::Stack<sge::scripting::ComponentKey> {
+    static void push(lua_State* L, const sge::scripting::ComponentKey &key) {
+        luabridge::Stack<std::string>::push(L, key.str());
+    }
+
+    static sge::scripting::ComponentKey get(lua_State* L, int index) {
+        auto str = luabridge::Stack<std::string_view>::get(L, index);
+        if (auto runtime = sge::scripting::ComponentKey::ParseRuntime(str)) {
+            return *runtime;
+        }
+        return sge::scripting::ComponentKey{luabridge::Stack<sge::util::Symbol>::get(L, index)};
+    }
+
+    static bool isInstance(lua_State* L, int index) {
+        return luabridge::Stack<std::string_view>::isInstance(L, index);
+    }
+};
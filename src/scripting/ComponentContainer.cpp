@@ -1,70 +1,98 @@
 #include "scripting/ComponentContainer.hpp"
 
 #include "scripting/Component.hpp"
+#include "util/Symbol.hpp"
 
 #include <algorithm>
 #include <cassert>
-#include <functional>
-#include <map>
 #include <memory>
-#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 namespace sge::scripting {
 
-ComponentContainer::ComponentContainer(
-    std::map<std::string, std::unique_ptr<Component>, std::less<>> &&components)
-    : components_(std::move(components)) {
-    for (auto &node : this->components_) {
-        this->componentsByType_[node.second->type].emplace(node.second->key, node.second.get());
+ComponentContainer::~ComponentContainer() {
+    // Destroy components in key order
+    for (auto &entry : this->components_) {
+        entry.component.reset();
     }
+    this->pendingAdditions_.clear();
 }
 
-ComponentContainer::~ComponentContainer() {
-    while (!this->components_.empty()) {
-        this->components_.erase(this->components_.begin());
-    }
+Component* ComponentContainer::addComponent(std::unique_ptr<Component> &&component) {
+    assert(this->getComponentByKey(component->key) == nullptr);
+    auto it = std::upper_bound(this->components_.begin(), this->components_.end(),
+                               component->key, [](const ComponentKey &key, const Entry &entry) {
+                                   return key < entry.key;
+                               });
+    it = this->components_.insert(it, Entry{
+                                          .key = component->key,
+                                          .type = component->type,
+                                          .component = std::move(component),
+                                      });
+    return it->component.get();
 }
 
-Component* ComponentContainer::addComponent(std::string_view key,
-                                            std::unique_ptr<Component> &&component) {
-    assert(!this->components_.contains(key));
-    const auto &[node, _] = this->components_.emplace(key, std::move(component));
-    this->componentsByType_[node->second->type].emplace(key, node->second.get());
-    return node->second.get();
+Component* ComponentContainer::appendComponent(std::unique_ptr<Component> &&component) {
+    assert(this->components_.empty() ||
+           this->components_.back().key < component->key);
+    auto &entry = this->components_.emplace_back(Entry{
+        .key = component->key,
+        .type = component->type,
+        .component = std::move(component),
+    });
+    return entry.component.get();
 }
 
-void ComponentContainer::removeComponent(std::string_view key) {
-    auto it = this->components_.find(key);
-    if (it == this->components_.end()) {
-        return;
+Component* ComponentContainer::addComponentLater(std::unique_ptr<Component> &&component) {
+    assert(this->getComponentByKey(component->key) == nullptr);
+    return this->pendingAdditions_.emplace_back(std::move(component)).get();
+}
+
+void ComponentContainer::addDeferred() {
+    // Move the list out first, so that addComponent doesn't find the
+    // components it is adding among the pending ones
+    auto pending = std::move(this->pendingAdditions_);
+    this->pendingAdditions_.clear();
+    for (auto &component : pending) {
+        this->addComponent(std::move(component));
     }
+}
 
-    it->second->setEnabled(false);
+bool ComponentContainer::hasPendingAdditions() const {
+    return !this->pendingAdditions_.empty();
+}
 
-    // Extract component from map
-    auto node = this->components_.extract(it);
+void ComponentContainer::reserve(std::size_t capacity) {
+    this->components_.reserve(capacity);
+}
 
-    // Remove component pointer from types mapping
-    auto &typeMap = this->componentsByType_[node.mapped()->type];
-    auto eraseIt = std::find_if(typeMap.begin(), typeMap.end(), [&](const auto &typeNode) {
-        return typeNode.second == node.mapped().get();
-    });
-    typeMap.erase(eraseIt);
+std::vector<std::unique_ptr<Component>> ComponentContainer::releaseAll() {
+    std::vector<std::unique_ptr<Component>> released;
+    released.reserve(this->components_.size());
+    for (auto &entry : this->components_) {
+        released.push_back(std::move(entry.component));
+    }
+    this->components_.clear();
+    return released;
 }
 
 void ComponentContainer::removeComponent(Component* component) {
-    // Find key of component to remove
-    auto it =
-        std::find_if(this->components_.begin(), this->components_.end(), [&](const auto &node) {
-            return node.second.get() == component;
-        });
-    if (it == this->components_.end()) {
+    auto* entry = this->find(component);
+    if (entry == nullptr) {
+        auto it = std::find_if(
+            this->pendingAdditions_.begin(),
+            this->pendingAdditions_.end(),
+            [component](const auto &pending) { return pending.get() == component; });
+        if (it != this->pendingAdditions_.end()) {
+            (*it)->setEnabled(false);
+            this->pendingAdditions_.erase(it);
+        }
         return;
     }
-    this->removeComponent(it->first);
+    entry->component->setEnabled(false);
+    this->components_.erase(this->components_.begin() + (entry - this->components_.data()));
 }
 
 void ComponentContainer::removeComponentLater(Component* component) {
@@ -78,44 +106,106 @@ void ComponentContainer::removeDeferred() {
     this->pendingRemoval_.clear();
 }
 
+std::size_t ComponentContainer::size() const {
+    return this->components_.size();
+}
+
+const std::vector<Component*> &ComponentContainer::pendingRemoval() const {
+    return this->pendingRemoval_;
+}
+
+Component* ComponentContainer::getComponentByKey(const ComponentKey &key) {
+    for (auto &entry : this->components_) {
+        if (entry.key == key) {
+            return entry.component.get();
+        }
+    }
+    for (auto &component : this->pendingAdditions_) {
+        if (component->key == key) {
+            return component.get();
+        }
+    }
+    return nullptr;
+}
+
 Component* ComponentContainer::getComponentByKey(std::string_view key) {
-    auto it = this->components_.find(key);
-    if (it == this->components_.end()) {
-        return nullptr;
+    // A string that was never interned can't name a component from a
+    // template, but may be the key of one added at runtime
+    if (auto symbol = util::FindSymbol(key)) {
+        if (auto* component = this->getComponentByKey(ComponentKey{*symbol})) {
+            return component;
+        }
     }
-    return it->second.get();
+    auto runtimeKey = ComponentKey::ParseRuntime(key);
+    return runtimeKey.has_value() ? this->getComponentByKey(*runtimeKey) : nullptr;
 }
 
-Component* ComponentContainer::getComponent(std::string_view type) {
-    auto it = this->componentsByType_.find(type);
-    if (it == this->componentsByType_.end() || it->second.empty()) {
-        return nullptr;
+Component* ComponentContainer::getComponent(util::Symbol type) {
+    for (auto &entry : this->components_) {
+        if (entry.type == type) {
+            return entry.component.get();
+        }
     }
-    return it->second.begin()->second;
+    for (auto &component : this->pendingAdditions_) {
+        if (component->type == type) {
+            return component.get();
+        }
+    }
+    return nullptr;
+}
+
+Component* ComponentContainer::getComponent(std::string_view type) {
+    auto symbol = util::FindSymbol(type);
+    return symbol.has_value() ? this->getComponent(*symbol) : nullptr;
 }
 
 Component* ComponentContainer::getComponent(const luabridge::LuaRef &componentRef) {
-    auto it =
-        std::find_if(this->components_.begin(), this->components_.end(), [&](const auto &node) {
-            return node.second->ref() == componentRef;
-        });
-    if (it == this->components_.end()) {
+    if (!componentRef.isTable() && !componentRef.isUserdata()) {
         return nullptr;
     }
-    return it->second.get();
+    auto pointerRef = componentRef[OpaqueComponentPointerKey];
+    if (!pointerRef.isInstance<OpaqueComponentPointer>()) {
+        return nullptr;
+    }
+    auto* component = pointerRef.cast<OpaqueComponentPointer>().ptr;
+    if (this->find(component) != nullptr || this->isPendingAddition(component)) {
+        return component;
+    }
+    return nullptr;
 }
 
 std::vector<Component*> ComponentContainer::getComponents(std::string_view type) {
     std::vector<Component*> res;
-    auto it = this->componentsByType_.find(type);
-    if (it == this->componentsByType_.end()) {
+    auto symbol = util::FindSymbol(type);
+    if (!symbol.has_value()) {
         return res;
     }
-    res.reserve(it->second.size());
-    for (const auto &node : it->second) {
-        res.push_back(node.second);
+    for (auto &entry : this->components_) {
+        if (entry.type == *symbol) {
+            res.push_back(entry.component.get());
+        }
+    }
+    for (auto &component : this->pendingAdditions_) {
+        if (component->type == *symbol) {
+            res.push_back(component.get());
+        }
     }
     return res;
 }
 
+ComponentContainer::Entry* ComponentContainer::find(const Component* component) {
+    for (auto &entry : this->components_) {
+        if (entry.component.get() == component) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool ComponentContainer::isPendingAddition(const Component* component) const {
+    return std::any_of(this->pendingAdditions_.begin(),
+                       this->pendingAdditions_.end(),
+                       [component](const auto &pending) { return pending.get() == component; });
+}
+
 } // namespace sge::scripting
@@ -1,23 +1,36 @@
 #pragma once
 
+#include <boost/container/small_vector.hpp>
 #include <lua/lua.hpp>
 #include <LuaBridge/LuaBridge.h>
 
 #include "scripting/Component.hpp"
+#include "util/Symbol.hpp"
 
-#include <functional>
-#include <map>
+#include <cstddef>
 #include <memory>
-#include <string>
 #include <string_view>
 #include <vector>
 
 namespace sge::scripting {
 
+/**
+ * @brief The components of an actor, ordered by key. Lifecycle functions run
+ * in this order.
+ */
 class ComponentContainer {
 public:
+    struct Entry {
+        ComponentKey key;
+        util::Symbol type;
+        std::unique_ptr<Component> component;
+    };
+
+    // Most actors have a handful of components, which are then stored inline
+    // in the actor
+    static constexpr std::size_t InlineComponents = 8;
+
     ComponentContainer() = default;
-    ComponentContainer(std::map<std::string, std::unique_ptr<Component>, std::less<>> &&components);
     ~ComponentContainer();
 
     ComponentContainer(const ComponentContainer &) = delete;
@@ -25,17 +38,46 @@ public:
     ComponentContainer(ComponentContainer &&) = default;
     ComponentContainer &operator=(ComponentContainer &&) = default;
 
-    Component* addComponent(std::string_view key, std::unique_ptr<Component> &&component);
-    void removeComponent(std::string_view key);
+    /**
+     * @brief Add a component under its key, which must not be taken yet.
+     */
+    Component* addComponent(std::unique_ptr<Component> &&component);
+    /**
+     * @brief Add a component whose key sorts after every key in the container,
+     * skipping the search for its position.
+     */
+    Component* appendComponent(std::unique_ptr<Component> &&component);
+    /**
+     * @brief Add a component while the container may be being iterated, e.g.
+     * from a lifecycle function. Lookups see it right away, but it only joins
+     * iteration once addDeferred is called.
+     */
+    Component* addComponentLater(std::unique_ptr<Component> &&component);
+    void addDeferred();
+    bool hasPendingAdditions() const;
+    void reserve(std::size_t capacity);
+    /**
+     * @brief Remove every component without destroying it, in key order.
+     */
+    std::vector<std::unique_ptr<Component>> releaseAll();
     void removeComponent(Component* component);
     void removeComponentLater(Component* component);
     void removeDeferred();
+    const std::vector<Component*> &pendingRemoval() const;
 
+    Component* getComponentByKey(const ComponentKey &key);
     Component* getComponentByKey(std::string_view key);
+    Component* getComponent(util::Symbol type);
     Component* getComponent(std::string_view type);
+    /**
+     * @brief Get the component a Lua component reference points to, if it
+     * belongs to this container.
+     */
     Component* getComponent(const luabridge::LuaRef &componentRef);
     std::vector<Component*> getComponents(std::string_view type);
 
+    std::size_t size() const;
+
     auto begin() {
         return this->components_.begin();
     }
@@ -45,9 +87,11 @@ public:
     }
 
 private:
-    std::map<std::string, std::unique_ptr<Component>, std::less<>> components_;
-    std::map<std::string, std::map<std::string, Component*, std::less<>>, std::less<>>
-        componentsByType_;
+    Entry* find(const Component* component);
+    bool isPendingAddition(const Component* component) const;
+
+    boost::container::small_vector<Entry, InlineComponents> components_;
+    std::vector<std::unique_ptr<Component>> pendingAdditions_;
     std::vector<Component*> pendingRemoval_;
 };
 
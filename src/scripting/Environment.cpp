@@ -0,0 +1,92 @@
+#include "scripting/Environment.hpp"
+
+#include <dnsge/HashMap.hpp>
+#include <lua/lua.hpp>
+
+#include "scripting/ActorTemplate.hpp"
+#include "scripting/Component.hpp"
+#include "scripting/Libs.hpp"
+#include "util/Symbol.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <filesystem>
+#include <unordered_map>
+
+namespace sge::scripting {
+
+namespace {
+
+thread_local Environment* CurrentThreadEnvironment = nullptr;
+
+} // namespace
+
+Environment::Environment()
+    : state_(luaL_newstate())
+    , profiler_(state_) {
+    luaL_openlibs(this->state_);
+
+    // Loading libraries and component types goes through GetGlobalState(), so
+    // this environment must be current while it is being set up.
+    EnvironmentScope scope{*this};
+    InitializeScriptingLibs();
+    InitializeScriptingClasses();
+    InitializeComponentTypes();
+}
+
+Environment::~Environment() {
+    // Everything holding a LuaRef must be released before the state is closed
+    this->actorTemplates_.clear();
+    this->componentTypes_.clear();
+    lua_close(this->state_);
+}
+
+lua_State* Environment::state() const {
+    return this->state_;
+}
+
+dnsge::HashMap<util::Symbol, ComponentType> &Environment::componentTypes() {
+    return this->componentTypes_;
+}
+
+unordered_string_map<std::filesystem::path> &Environment::pendingComponentTypes() {
+    return this->pendingComponentTypes_;
+}
+
+std::unordered_map<util::Symbol, ActorTemplate> &Environment::actorTemplates() {
+    return this->actorTemplates_;
+}
+
+std::size_t Environment::nextRuntimeComponentID() {
+    return this->runtimeComponentCounter_++;
+}
+
+LuaProfiler &Environment::profiler() {
+    return this->profiler_;
+}
+
+std::size_t Environment::luaMemoryUsage() const {
+    auto kb = static_cast<std::size_t>(lua_gc(this->state_, LUA_GCCOUNT));
+    auto remainder = static_cast<std::size_t>(lua_gc(this->state_, LUA_GCCOUNTB));
+    return kb * 1024 + remainder;
+}
+
+Environment &CurrentEnvironment() {
+    assert(CurrentThreadEnvironment != nullptr);
+    return *CurrentThreadEnvironment;
+}
+
+Environment* SetCurrentEnvironment(Environment* environment) {
+    auto* previous = CurrentThreadEnvironment;
+    CurrentThreadEnvironment = environment;
+    return previous;
+}
+
+EnvironmentScope::EnvironmentScope(Environment &environment)
+    : previous_(SetCurrentEnvironment(&environment)) {}
+
+EnvironmentScope::~EnvironmentScope() {
+    SetCurrentEnvironment(this->previous_);
+}
+
+} // namespace sge::scripting
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <dnsge/HashMap.hpp>
+#include <lua/lua.hpp>
+
+#include "scripting/ActorTemplate.hpp"
+#include "scripting/Component.hpp"
+#include "scripting/Profiler.hpp"
+#include "util/HeterogeneousLookup.hpp"
+#include "util/Symbol.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <unordered_map>
+
+namespace sge::scripting {
+
+/**
+ * @brief An isolated scripting environment. Owns a Lua state along with all
+ * data that is bound to it: loaded component types and instantiated actor
+ * templates. Exactly one environment is current on each thread, and
+ * GetGlobalState() resolves to the current environment's Lua state.
+ *
+ * Component types are loaded on first use rather than when the environment is
+ * created, so creating one doesn't get slower as the script library grows.
+ */
+class Environment {
+public:
+    /**
+     * @brief Create a new Lua state, load all engine libraries into it, and
+     * find the component types available to it.
+     */
+    Environment();
+    ~Environment();
+
+    Environment(const Environment &) = delete;
+    Environment &operator=(const Environment &) = delete;
+
+    lua_State* state() const;
+
+    dnsge::HashMap<util::Symbol, ComponentType> &componentTypes();
+    // Source files of component types that haven't been loaded yet
+    unordered_string_map<std::filesystem::path> &pendingComponentTypes();
+    std::unordered_map<util::Symbol, ActorTemplate> &actorTemplates();
+
+    std::size_t nextRuntimeComponentID();
+
+    LuaProfiler &profiler();
+
+    /**
+     * @brief Number of bytes currently allocated by the Lua state.
+     */
+    std::size_t luaMemoryUsage() const;
+
+private:
+    lua_State* state_;
+    LuaProfiler profiler_;
+    dnsge::HashMap<util::Symbol, ComponentType> componentTypes_;
+    unordered_string_map<std::filesystem::path> pendingComponentTypes_;
+    std::unordered_map<util::Symbol, ActorTemplate> actorTemplates_;
+    std::size_t runtimeComponentCounter_{1};
+};
+
+/**
+ * @brief Get the environment that is current on the calling thread.
+ */
+Environment &CurrentEnvironment();
+
+/**
+ * @brief Make an environment current on the calling thread.
+ *
+ * @param environment Environment to make current. May be nullptr.
+ * @return The previously current environment.
+ */
+Environment* SetCurrentEnvironment(Environment* environment);
+
+/**
+ * @brief Makes an environment current on the calling thread for the lifetime
+ * of the scope, restoring the previous environment afterwards.
+ */
+class EnvironmentScope {
+public:
+    explicit EnvironmentScope(Environment &environment);
+    ~EnvironmentScope();
+
+    EnvironmentScope(const EnvironmentScope &) = delete;
+    EnvironmentScope &operator=(const EnvironmentScope &) = delete;
+
+private:
+    Environment* previous_;
+};
+
+} // namespace sge::scripting
@@ -1,30 +1,133 @@
 #include "scripting/EventSub.hpp"
 
+#include "Common.hpp"
+#include "scripting/Invoke.hpp"
+#include "scripting/LuaCall.hpp"
+#include "scripting/LuaValue.hpp"
+#include "util/Symbol.hpp"
+
 #include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <string>
+#include <cstdint>
+#include <optional>
 #include <string_view>
-#include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 namespace sge::scripting {
 
+namespace {
+
+std::atomic<std::uint64_t> NextEventSubInstanceID{1};
+
+} // namespace
+
+EventSub::EventSub()
+    : instanceID_(NextEventSubInstanceID.fetch_add(1, std::memory_order_relaxed)) {}
+
+std::uint64_t EventSub::instanceID() const {
+    return this->instanceID_;
+}
+
+channel_id EventSub::channel(util::Symbol event) {
+    auto it = this->channelsByEvent_.find(event);
+    if (it != this->channelsByEvent_.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<channel_id>(this->channels_.size());
+    this->channels_.push_back(Channel{.event = event, .handlers = {}});
+    this->channelsByEvent_.insert({event, id});
+    return id;
+}
+
+std::optional<channel_id> EventSub::findChannel(std::string_view event) const {
+    // Nothing can be subscribed to an event name that was never interned
+    auto symbol = util::FindSymbol(event);
+    if (!symbol.has_value()) {
+        return std::nullopt;
+    }
+    auto it = this->channelsByEvent_.find(*symbol);
+    if (it == this->channelsByEvent_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool EventSub::hasHandlers(channel_id channel) const {
+    return !this->channels_[channel].handlers.empty();
+}
+
+void EventSub::publishReplicated(channel_id channel, const luabridge::LuaRef &payload) {
+    const auto &handlers = this->channels_[channel].handlers;
+    std::optional<ProtectedCall> call;
+    std::optional<LuaValue> value;
+    for (const auto &handler : handlers) {
+        if (const auto* function = std::get_if<luabridge::LuaRef>(&handler.function)) {
+            if (!call.has_value()) {
+                call.emplace(payload.state());
+            }
+            call->callFunction(*function, payload, EventInvocationName);
+            continue;
+        }
+        if (!value.has_value()) {
+            value.emplace(payload.cast<LuaValue>());
+        }
+        ActorInvoke(EventInvocationName, [&]() {
+            std::get<CallableHandlerFunc>(handler.function)(*value);
+        });
+    }
+}
+
+void EventSub::publishBatch(channel_id channel, const luabridge::LuaRef &payloads) {
+    const auto &handlers = this->channels_[channel].handlers;
+    if (handlers.empty() || !payloads.isTable()) {
+        return;
+    }
+
+    // Payloads are pushed straight from the array, without a LuaRef each
+    auto* L = payloads.state();
+    ProtectedCall call{L};
+    payloads.push();
+    auto payloadsIndex = lua_gettop(L);
+    auto count = static_cast<lua_Integer>(lua_rawlen(L, payloadsIndex));
+    for (lua_Integer i = 1; i <= count; ++i) {
+        for (const auto &handler : handlers) {
+            if (const auto* function = std::get_if<luabridge::LuaRef>(&handler.function)) {
+                function->push();
+                lua_rawgeti(L, payloadsIndex, i);
+                call.call(1, EventInvocationName);
+            }
+        }
+    }
+    lua_pop(L, 1);
+}
+
 subscription_handle EventSub::subscribe(std::string_view event, luabridge::LuaRef handler) {
+    return this->subscribe(this->channel(util::Intern(event)), std::move(handler));
+}
+
+subscription_handle EventSub::subscribe(std::string_view event, CallableHandlerFunc handler) {
+    return this->subscribe(this->channel(util::Intern(event)), std::move(handler));
+}
+
+subscription_handle EventSub::subscribe(channel_id channel, luabridge::LuaRef handler) {
     auto handle = this->nextSubscriptionHandle_++;
     this->pendingSubscribes_.push_back(EventSubscriptionRequest{
         .handle = handle,
-        .event = std::string{event},
+        .channel = channel,
         .handler = {std::move(handler)},
     });
     return handle;
 }
 
-subscription_handle EventSub::subscribe(std::string_view event, CallableHandlerFunc handler) {
+subscription_handle EventSub::subscribe(channel_id channel, CallableHandlerFunc handler) {
     auto handle = this->nextSubscriptionHandle_++;
     this->pendingSubscribes_.push_back(EventSubscriptionRequest{
         .handle = handle,
-        .event = std::string{event},
+        .channel = channel,
         .handler = {std::move(handler)},
     });
     return handle;
@@ -50,40 +153,63 @@ void EventSub::executePendingSubscriptions() {
 }
 
 void EventSub::doSubscribe(EventSubscriptionRequest &&req) {
-    assert(!this->eventHandlers_.contains(req.handle));
+    assert(!this->subscriptionChannels_.contains(req.handle));
 
-    // Add handler to mapping of handlers
-    auto emplacement = this->eventHandlers_.emplace(req.handle,
-                                                    MappedHandler{
-                                                        .event = req.event,
-                                                        .handler = std::move(req.handler),
-                                                    });
-    assert(emplacement.second);
+    // Remember the channel of the handle
+    auto inserted = this->subscriptionChannels_.insert({req.handle, req.channel});
+    assert(inserted.has_value());
 
-    // Add handler to event list
-    auto* handlerPtr = &emplacement.first->second;
-    this->eventHandlersByEvent_[req.event].push_back(handlerPtr);
+    // Add handler to the channel
+    this->channels_[req.channel].handlers.push_back(Handler{
+        .handle = req.handle,
+        .function = std::move(req.handler),
+    });
 }
 
 void EventSub::doUnsubscribe(subscription_handle handle) {
-    auto handlerIt = this->eventHandlers_.find(handle);
-    if (handlerIt == this->eventHandlers_.end()) {
+    auto subscriptionIt = this->subscriptionChannels_.find(handle);
+    if (subscriptionIt == this->subscriptionChannels_.end()) {
         return;
     }
 
-    // Extract the handle mapping
-    auto node = this->eventHandlers_.extract(handlerIt);
-    auto* handlerPtr = &node.mapped();
+    // Remove the handle mapping
+    auto &channel = this->channels_[subscriptionIt->second];
+    this->subscriptionChannels_.erase(subscriptionIt);
 
-    auto eventIt = this->eventHandlersByEvent_.find(handlerPtr->event);
-    if (eventIt == this->eventHandlersByEvent_.end()) {
-        return;
-    }
+    // Erase the handler from the channel
+    std::erase_if(channel.handlers, [handle](const Handler &h) {
+        return h.handle == handle;
+    });
+}
+
+EventChannel::EventChannel(util::Symbol event)
+    : event_(event) {}
+
+std::string_view EventChannel::getName() const {
+    return this->event_.str();
+}
+
+void EventChannel::publish(const luabridge::LuaRef &payload) {
+    auto &eventSub = CurrentGame().eventSub();
+    eventSub.publish(this->resolve(eventSub), payload);
+}
 
-    // Erase the handler-to-event-name mapping
-    auto &vec = eventIt->second;
-    auto it = std::remove(vec.begin(), vec.end(), handlerPtr);
-    vec.erase(it, vec.end());
+void EventChannel::publishBatch(const luabridge::LuaRef &payloads) {
+    auto &eventSub = CurrentGame().eventSub();
+    eventSub.publishBatch(this->resolve(eventSub), payloads);
+}
+
+subscription_handle EventChannel::subscribe(const luabridge::LuaRef &handler) {
+    auto &eventSub = CurrentGame().eventSub();
+    return eventSub.subscribe(this->resolve(eventSub), handler);
+}
+
+channel_id EventChannel::resolve(EventSub &eventSub) {
+    if (this->owner_ != eventSub.instanceID()) [[unlikely]] {
+        this->id_ = eventSub.channel(this->event_);
+        this->owner_ = eventSub.instanceID();
+    }
+    return this->id_;
 }
 
 } // namespace sge::scripting
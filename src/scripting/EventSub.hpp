@@ -1,18 +1,22 @@
 #pragma once
 
+#include <dnsge/HashMap.hpp>
 #include <lua/lua.hpp>
 #include <LuaBridge/LuaBridge.h>
 
 #include "scripting/Invoke.hpp"
+#include "scripting/LuaCall.hpp"
 #include "scripting/LuaValue.hpp"
-#include "util/HeterogeneousLookup.hpp"
-#include "util/Visit.hpp"
+#include "util/Symbol.hpp"
 
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <type_traits>
-#include <unordered_map>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -20,67 +24,134 @@ namespace sge::scripting {
 
 using subscription_handle = unsigned int;
 
-using CallableHandlerFunc = std::function<void(const LuaValue &)>;
-
-struct MappedHandler {
-    std::string event;
-    std::variant<luabridge::LuaRef, CallableHandlerFunc> handler;
-};
+// Index of an event's channel in an EventSub
+using channel_id = std::uint32_t;
 
-namespace detail {
-
-template <typename Param>
-void InvokeEventHandlers(const std::vector<MappedHandler*> &handlers, Param &&invocationParam) {
-    for (const auto &m : handlers) {
-        ActorInvoke("<event invocation>", [&]() {
-            std::visit(
-                util::Visitor{
-                    [&](const luabridge::LuaRef &ref) {
-                        ref(std::forward<Param>(invocationParam));
-                    },
-                    [&](const CallableHandlerFunc &func) {
-                        // Only invoke CallableHandlerFunc if valid invocation param
-                        if constexpr (std::is_same_v<std::remove_reference_t<Param>, LuaValue>) {
-                            func(std::forward<Param>(invocationParam));
-                        }
-                    }},
-                m->handler);
-        });
-    }
-}
+using CallableHandlerFunc = std::function<void(const LuaValue &)>;
 
-} // namespace detail
+/**
+ * @brief Actor name used when reporting errors raised by event handlers.
+ */
+constexpr std::string_view EventInvocationName = "<event invocation>";
 
 class EventSub {
 public:
-    EventSub() = default;
+    EventSub();
+
+    EventSub(const EventSub &) = delete;
+    EventSub &operator=(const EventSub &) = delete;
+
+    /**
+     * @brief Identifies this EventSub among every EventSub the process has
+     * created, so that a channel resolved against one is never used with
+     * another.
+     */
+    std::uint64_t instanceID() const;
+
+    /**
+     * @brief Get the channel of an event, creating it if needed. Channels are
+     * never removed, so the ID stays valid for the lifetime of the EventSub.
+     */
+    channel_id channel(util::Symbol event);
+
+    /**
+     * @brief Find the channel of an event without creating it.
+     */
+    std::optional<channel_id> findChannel(std::string_view event) const;
+
+    bool hasHandlers(channel_id channel) const;
 
     template <typename Param>
     void publish(std::string_view event, Param &&param) {
-        auto eventIt = this->eventHandlersByEvent_.find(event);
-        if (eventIt == this->eventHandlersByEvent_.end()) {
+        auto channel = this->findChannel(event);
+        if (!channel.has_value()) {
             return;
         }
-        detail::InvokeEventHandlers(eventIt->second, std::forward<Param>(param));
+        this->publish(*channel, std::forward<Param>(param));
     }
 
+    template <typename Param>
+    void publish(util::Symbol event, Param &&param) {
+        auto channelIt = this->channelsByEvent_.find(event);
+        if (channelIt == this->channelsByEvent_.end()) {
+            return;
+        }
+        this->publish(channelIt->second, std::forward<Param>(param));
+    }
+
+    /**
+     * @brief Call the handlers of a channel with a payload, in subscription
+     * order. C++ handlers are only called if the payload is a LuaValue.
+     */
+    template <typename Param>
+    void publish(channel_id channel, const Param &param) {
+        const auto &handlers = this->channels_[channel].handlers;
+        // Lua handlers share one message handler, pushed by the first of them
+        std::optional<ProtectedCall> call;
+        for (const auto &handler : handlers) {
+            if (const auto* function = std::get_if<luabridge::LuaRef>(&handler.function)) {
+                if (!call.has_value()) {
+                    call.emplace(function->state());
+                }
+                call->callFunction(*function, param, EventInvocationName);
+            } else if constexpr (std::is_same_v<Param, LuaValue>) {
+                ActorInvoke(EventInvocationName, [&]() {
+                    std::get<CallableHandlerFunc>(handler.function)(param);
+                });
+            }
+        }
+    }
+
+    /**
+     * @brief Publish a payload received from a remote peer. Lua handlers get the
+     * payload itself, and C++ handlers a LuaValue converted from it once the
+     * first of them is reached.
+     */
+    void publishReplicated(channel_id channel, const luabridge::LuaRef &payload);
+
+    /**
+     * @brief Publish every element of a Lua array to a channel, in order, as if
+     * each were published on its own. Like any Lua payload, the elements only
+     * reach Lua handlers.
+     */
+    void publishBatch(channel_id channel, const luabridge::LuaRef &payloads);
+
     subscription_handle subscribe(std::string_view event, luabridge::LuaRef handler);
     subscription_handle subscribe(std::string_view event, CallableHandlerFunc handler);
+    subscription_handle subscribe(channel_id channel, luabridge::LuaRef handler);
+    subscription_handle subscribe(channel_id channel, CallableHandlerFunc handler);
     void unsubscribe(subscription_handle handle);
     void executePendingSubscriptions();
 
 private:
+    struct Handler {
+        subscription_handle handle;
+        std::variant<luabridge::LuaRef, CallableHandlerFunc> function;
+    };
+
+    struct Channel {
+        util::Symbol event;
+        // In subscription order
+        std::vector<Handler> handlers;
+    };
+
     struct EventSubscriptionRequest {
         subscription_handle handle;
-        std::string event;
+        channel_id channel;
         std::variant<luabridge::LuaRef, CallableHandlerFunc> handler;
     };
 
     void doSubscribe(EventSubscriptionRequest &&req);
     void doUnsubscribe(subscription_handle handle);
 
-    std::unordered_map<subscription_handle, MappedHandler> eventHandlers_;
-    unordered_string_map<std::vector<MappedHandler*>> eventHandlersByEvent_;
+    std::uint64_t instanceID_;
+
+    // Indexed by channel_id. A deque, so that resolving a new channel from a
+    // handler doesn't move the channel being published.
+    std::deque<Channel> channels_;
+    dnsge::HashMap<util::Symbol, channel_id> channelsByEvent_;
+    // The channel of each subscription
+    dnsge::HashMap<subscription_handle, channel_id> subscriptionChannels_;
 
     std::vector<EventSubscriptionRequest> pendingSubscribes_;
     std::vector<subscription_handle> pendingUnsubscribes_;
@@ -88,4 +159,28 @@ private:
     subscription_handle nextSubscriptionHandle_{0};
 };
 
+/**
+ * @brief An event channel of the current game, as returned to scripts by
+ * Event.Channel. The channel is resolved once per game rather than on every
+ * publish.
+ */
+class EventChannel {
+public:
+    explicit EventChannel(util::Symbol event);
+
+    std::string_view getName() const;
+
+    void publish(const luabridge::LuaRef &payload);
+    void publishBatch(const luabridge::LuaRef &payloads);
+    subscription_handle subscribe(const luabridge::LuaRef &handler);
+
+private:
+    channel_id resolve(EventSub &eventSub);
+
+    util::Symbol event_;
+    // EventSub the channel was last resolved against
+    std::uint64_t owner_{0};
+    channel_id id_{0};
+};
+
 } // namespace sge::scripting
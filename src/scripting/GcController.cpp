@@ -0,0 +1,98 @@
+#include "scripting/GcController.hpp"
+
+#include <lua/lua.hpp>
+
+#include "util/Trace.hpp"
+
+#include <chrono>
+#include <cstddef>
+
+namespace sge::scripting {
+
+namespace {
+
+// Allocation debt paid off by each incremental step, in KiB. Small enough that
+// a step rarely overshoots a deadline by much.
+constexpr int IncrementalStepKb = 64;
+
+// Growth of the heap, in percent of its size after a collection, before the
+// next cycle starts. The same as Lua's own defaults.
+constexpr std::size_t IncrementalPause = 200;
+constexpr std::size_t GenerationalMinorMultiplier = 20;
+
+} // namespace
+
+GcController::GcController(lua_State* L, LuaGcMode mode, std::size_t emergencyBytes)
+    : L_(L)
+    , mode_(mode)
+    , emergencyBytes_(emergencyBytes)
+    , nextCollectionBytes_(0) {
+    if (mode == LuaGcMode::Generational) {
+        lua_gc(L, LUA_GCGEN, 0, 0);
+    } else {
+        lua_gc(L, LUA_GCINC, 0, 0, 0);
+    }
+    lua_gc(L, LUA_GCSTOP);
+}
+
+std::chrono::nanoseconds GcController::collect(clock::time_point until) {
+    auto start = clock::now();
+    auto heap = this->heapBytes();
+
+    if (this->emergencyBytes_ != 0 && heap >= this->emergencyBytes_) {
+        TRACE_ZONE("Lua.FullGC");
+        lua_gc(this->L_, LUA_GCCOLLECT);
+        ++this->stats_.emergencies;
+        this->inCycle_ = false;
+        this->nextCollectionBytes_ = this->heapBytes() * IncrementalPause / 100;
+        return clock::now() - start;
+    }
+
+    if (!this->inCycle_ && heap < this->nextCollectionBytes_) {
+        // Not enough new garbage to be worth a collection yet
+        return std::chrono::nanoseconds{0};
+    }
+
+    TRACE_ZONE("Lua.GC");
+    if (this->mode_ == LuaGcMode::Generational) {
+        this->stepGenerational();
+    } else {
+        this->stepIncremental(until);
+    }
+    return clock::now() - start;
+}
+
+std::size_t GcController::heapBytes() const {
+    auto kb = static_cast<std::size_t>(lua_gc(this->L_, LUA_GCCOUNT));
+    auto remainder = static_cast<std::size_t>(lua_gc(this->L_, LUA_GCCOUNTB));
+    return kb * 1024 + remainder;
+}
+
+const GcStats &GcController::stats() const {
+    return this->stats_;
+}
+
+void GcController::stepIncremental(clock::time_point until) {
+    this->inCycle_ = true;
+    // At least one step, even past the deadline, so a server that never idles
+    // still makes progress
+    do {
+        ++this->stats_.steps;
+        if (lua_gc(this->L_, LUA_GCSTEP, IncrementalStepKb) != 0) {
+            ++this->stats_.cycles;
+            this->inCycle_ = false;
+            this->nextCollectionBytes_ = this->heapBytes() * IncrementalPause / 100;
+            return;
+        }
+    } while (clock::now() < until);
+}
+
+void GcController::stepGenerational() {
+    // A step is a whole minor collection, so run one per call
+    ++this->stats_.steps;
+    lua_gc(this->L_, LUA_GCSTEP, 0);
+    this->nextCollectionBytes_ =
+        this->heapBytes() * (100 + GenerationalMinorMultiplier) / 100;
+}
+
+} // namespace sge::scripting
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <lua/lua.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace sge::scripting {
+
+/**
+ * @brief Which of Lua's collectors a GcController drives.
+ */
+enum class LuaGcMode {
+    // Mark and sweep the whole heap in small steps
+    Incremental,
+    // Collect young objects in frequent minor collections
+    Generational,
+};
+
+constexpr LuaGcMode LuaGcModeOfString(std::string_view s) {
+    using namespace std::string_view_literals;
+    if (s == "generational"sv) {
+        return LuaGcMode::Generational;
+    } else {
+        return LuaGcMode::Incremental;
+    }
+}
+
+/**
+ * @brief Counters kept by a GcController.
+ */
+struct GcStats {
+    // Collector steps run, and how many of them finished an incremental cycle
+    std::uint64_t steps{0};
+    std::uint64_t cycles{0};
+    // Full collections forced by the emergency threshold
+    std::uint64_t emergencies{0};
+};
+
+/**
+ * @brief Runs the garbage collector of a Lua state only when asked to, so that
+ * collection happens between ticks rather than wherever an allocation in a
+ * script or a physics callback happens to trigger it.
+ *
+ * The automatic collector is stopped. collect() does bounded amounts of work,
+ * but always at least one step once the heap has grown enough, so the heap
+ * stays bounded even when there is never any idle time.
+ */
+class GcController {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @param L State to collect.
+     * @param mode Collector to use.
+     * @param emergencyBytes Heap size at which collect() runs a full collection
+     * regardless of its deadline. Zero disables the threshold.
+     */
+    GcController(lua_State* L, LuaGcMode mode, std::size_t emergencyBytes);
+
+    GcController(const GcController &) = delete;
+    GcController &operator=(const GcController &) = delete;
+
+    /**
+     * @brief Collect garbage until a deadline, stopping early once there is
+     * nothing worth collecting.
+     *
+     * @return Time spent collecting.
+     */
+    std::chrono::nanoseconds collect(clock::time_point until);
+
+    /**
+     * @brief Number of bytes currently allocated by the Lua state.
+     */
+    std::size_t heapBytes() const;
+
+    const GcStats &stats() const;
+
+private:
+    void stepIncremental(clock::time_point until);
+    void stepGenerational();
+
+    lua_State* L_;
+    LuaGcMode mode_;
+    std::size_t emergencyBytes_;
+
+    // Heap size at which the next cycle (or minor collection) starts
+    std::size_t nextCollectionBytes_;
+    bool inCycle_{false};
+    GcStats stats_;
+};
+
+} // namespace sge::scripting
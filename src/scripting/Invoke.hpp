@@ -3,6 +3,8 @@
 #include <lua/lua.hpp>
 #include <LuaBridge/LuaBridge.h>
 
+#include "scripting/LuaCall.hpp"
+
 #include <algorithm>
 #include <iostream>
 #include <string>
@@ -13,6 +15,7 @@ namespace sge::scripting {
 template <typename F>
 bool ActorInvoke(std::string_view actorName, F f) {
     try {
+        LuaZoneGuard zones;
         f();
         return true;
     } catch (const luabridge::LuaException &e) {
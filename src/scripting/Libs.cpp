@@ -14,12 +14,16 @@
 #include "physics/Raycast.hpp"
 #include "physics/Rigidbody.hpp"
 #include "scripting/Component.hpp"
+#include "scripting/Environment.hpp"
 #include "scripting/EventSub.hpp"
+#include "scripting/LuaCall.hpp"
+#include "scripting/Profiler.hpp"
 #include "scripting/Scripting.hpp"
-#include "scripting/Tracing.hpp"
 #include "scripting/components/CppComponent.hpp"
 #include "scripting/components/InterpTransform.hpp"
 #include "scripting/components/Transform.hpp"
+#include "scripting/components/Velocity.hpp"
+#include "util/Trace.hpp"
 
 #include <memory>
 #include <optional>
@@ -35,257 +39,341 @@ namespace libs {
 std::unique_ptr<LuaInterface> Interface = nullptr;
 
 void DebugLog(const std::string &message) {
-    TRACE_EVENT("Debug.Log");
+    TRACE_ZONE("Debug.Log");
     Interface->debugLog(message);
 }
 
 void DebugLogError(const std::string &message) {
-    TRACE_EVENT("Debug.LogError");
+    TRACE_ZONE("Debug.LogError");
     Interface->debugLogError(message);
 }
 
+void DebugBeginZone(const std::string &name) {
+    if (!util::TracingEnabled()) {
+        return;
+    }
+    BeginLuaZone(util::InternTraceString(name));
+}
+
+void DebugEndZone() {
+    EndLuaZone();
+}
+
+void DebugStartTrace() {
+    util::StartTracing();
+}
+
+void DebugStopTrace() {
+    util::StopTracing();
+}
+
+bool DebugDumpTrace(const std::string &path) {
+    return util::WriteChromeTrace(path);
+}
+
+void DebugStartProfile() {
+    CurrentEnvironment().profiler().start();
+}
+
+void DebugStopProfile() {
+    CurrentEnvironment().profiler().stop();
+}
+
+bool DebugDumpProfile(const std::string &path) {
+    return CurrentEnvironment().profiler().profile().writeFolded(path);
+}
+
+bool DebugDumpProfileSummary(const std::string &path) {
+    return CurrentEnvironment().profiler().profile().writeSummary(path);
+}
+
 void ApplicationQuit() {
     Interface->applicationQuit();
 }
 
 void ApplicationSleep(int ms) {
-    TRACE_EVENT("Application.Sleep");
+    TRACE_ZONE("Application.Sleep");
     Interface->applicationSleep(ms);
 }
 
 int ApplicationGetFrame() {
-    TRACE_EVENT("Application.GetFrame");
+    TRACE_ZONE("Application.GetFrame");
     return Interface->applicationGetFrame();
 }
 
 void ApplicationOpenURL(std::string_view url) {
-    TRACE_EVENT("Application.OpenURL");
+    TRACE_ZONE("Application.OpenURL");
     Interface->applicationOpenURL(url);
 }
 
 bool InputGetKey(std::string_view keycode) {
-    TRACE_EVENT("Input.GetKey");
+    TRACE_ZONE("Input.GetKey");
     return Interface->inputGetKey(keycode);
 }
 
 bool InputGetKeyDown(std::string_view keycode) {
-    TRACE_EVENT("Input.GetKeyDown");
+    TRACE_ZONE("Input.GetKeyDown");
     return Interface->inputGetKeyDown(keycode);
 }
 
 bool InputGetKeyUp(std::string_view keycode) {
-    TRACE_EVENT("Input.GetKeyUp");
+    TRACE_ZONE("Input.GetKeyUp");
     return Interface->inputGetKeyUp(keycode);
 }
 
 glm::vec2 InputGetMousePosition() {
-    TRACE_EVENT("Input.GetMousePosition");
+    TRACE_ZONE("Input.GetMousePosition");
     return Interface->inputGetMousePosition();
 }
 
 glm::vec2 InputGetMousePositionScene() {
-    TRACE_EVENT("Input.GetMousePositionScene");
+    TRACE_ZONE("Input.GetMousePositionScene");
     return Interface->inputGetMousePositionScene();
 }
 
 bool InputGetMouseButton(int button) {
-    TRACE_EVENT("Input.GetMouseButton");
+    TRACE_ZONE("Input.GetMouseButton");
     return Interface->inputGetMouseButton(button);
 }
 
 bool InputGetMouseButtonDown(int button) {
-    TRACE_EVENT("Input.GetMouseButtonDown");
+    TRACE_ZONE("Input.GetMouseButtonDown");
     return Interface->inputGetMouseButtonDown(button);
 }
 
 bool InputGetMouseButtonUp(int button) {
-    TRACE_EVENT("Input.GetMouseButtonUp");
+    TRACE_ZONE("Input.GetMouseButtonUp");
     return Interface->inputGetMouseButtonUp(button);
 }
 
 float InputGetMouseScrollDelta() {
-    TRACE_EVENT("Input.GetMouseScrollDelta");
+    TRACE_ZONE("Input.GetMouseScrollDelta");
     return Interface->inputGetMouseScrollDelta();
 }
 
 game::Actor* ActorFind(std::string_view name) {
-    TRACE_EVENT("Actor.Find");
+    TRACE_ZONE("Actor.Find");
     return Interface->actorFind(name);
 }
 
-std::vector<game::Actor*> ActorFindAll(std::string_view name) {
-    TRACE_EVENT("Actor.FindAll");
+const std::vector<game::Actor*> &ActorFindAll(std::string_view name) {
+    TRACE_ZONE("Actor.FindAll");
     return Interface->actorFindAll(name);
 }
 
 game::Actor* ActorInstantiate(std::string_view templateName) {
-    TRACE_EVENT("Actor.Instantiate");
+    TRACE_ZONE("Actor.Instantiate");
     return Interface->actorInstantiate(templateName, std::nullopt);
 }
 
 game::Actor* ActorInstantiateOwned(std::string_view templateName, client_id_t ownerClient) {
-    TRACE_EVENT("Actor.InstantiateOwned");
+    TRACE_ZONE("Actor.InstantiateOwned");
     return Interface->actorInstantiate(templateName, ownerClient);
 }
 
 void ActorDestroy(game::Actor* actor) {
-    TRACE_EVENT("Actor.Destroy");
+    TRACE_ZONE("Actor.Destroy");
     Interface->actorDestroy(actor);
 }
 
+/**
+ * @brief Calls an Actor method through the handle Lua holds the actor by. The
+ * trailing lua_State* is filled in by LuaBridge rather than passed by scripts.
+ */
+template <auto Method>
+struct ActorMethod;
+
+template <typename R, typename... Args, R (game::Actor::*Method)(Args...)>
+struct ActorMethod<Method> {
+    static R call(const game::ActorHandle* handle, Args... args, lua_State* L) {
+        return (game::ResolveActorHandle(L, *handle)->*Method)(std::forward<Args>(args)...);
+    }
+};
+
+template <typename R, typename... Args, R (game::Actor::*Method)(Args...) const>
+struct ActorMethod<Method> {
+    static R call(const game::ActorHandle* handle, Args... args, lua_State* L) {
+        return (game::ResolveActorHandle(L, *handle)->*Method)(std::forward<Args>(args)...);
+    }
+};
+
+bool ActorEquals(const game::ActorHandle* handle, const luabridge::LuaRef &other) {
+    return other.isInstance<game::ActorHandle>() && *handle == other.cast<game::ActorHandle>();
+}
+
 void TextDraw(std::string_view text, float x, float y, std::string_view fontName, float fontSize,
               float r, float g, float b, float a) {
-    TRACE_EVENT("Text.Draw");
+    TRACE_ZONE("Text.Draw");
     Interface->textDraw(text, x, y, fontName, fontSize, r, g, b, a);
 }
 
 void AudioPlay(int channel, std::string_view clipName, bool loop) {
-    TRACE_EVENT("Audio.Play");
+    TRACE_ZONE("Audio.Play");
     Interface->audioPlay(channel, clipName, loop);
 }
 
 void AudioHalt(int channel) {
-    TRACE_EVENT("Audio.Halt");
+    TRACE_ZONE("Audio.Halt");
     Interface->audioHalt(channel);
 }
 
 void AudioSetVolume(int channel, float volume) {
-    TRACE_EVENT("Audio.SetVolume");
+    TRACE_ZONE("Audio.SetVolume");
     Interface->audioSetVolume(channel, volume);
 }
 
 void ImageDrawUI(std::string_view imageName, float x, float y) {
-    TRACE_EVENT("Image.DrawUI");
+    TRACE_ZONE("Image.DrawUI");
     Interface->imageDrawUi(imageName, x, y);
 }
 
 void ImageDrawUIEx(std::string_view imageName, float x, float y, float r, float g, float b, float a,
                    int sortOrder) {
-    TRACE_EVENT("Image.DrawUIEx");
+    TRACE_ZONE("Image.DrawUIEx");
     Interface->imageDrawUiEx(imageName, x, y, r, g, b, a, sortOrder);
 }
 
 void ImageDraw(std::string_view imageName, float x, float y) {
-    TRACE_EVENT("Image.Draw");
+    TRACE_ZONE("Image.Draw");
     Interface->imageDraw(imageName, x, y);
 }
 
 void ImageDrawEx(std::string_view imageName, float x, float y, float rotation, float scaleX,
                  float scaleY, float pivotX, float pivotY, float r, float g, float b, float a,
                  int sortOrder) {
-    TRACE_EVENT("Image.DrawEx");
+    TRACE_ZONE("Image.DrawEx");
     Interface->imageDrawEx(
         imageName, x, y, rotation, scaleX, scaleY, pivotX, pivotY, r, g, b, a, sortOrder);
 }
 
 void ImageDrawPixel(float x, float y, float r, float g, float b, float a) {
-    TRACE_EVENT("Image.DrawPixel");
+    TRACE_ZONE("Image.DrawPixel");
     Interface->imageDrawPixel(x, y, r, g, b, a);
 }
 
 void CameraSetPosition(float x, float y) {
-    TRACE_EVENT("Camera.SetPosition");
+    TRACE_ZONE("Camera.SetPosition");
     Interface->cameraSetPosition(x, y);
 }
 
 float CameraGetPositionX() {
-    TRACE_EVENT("Camera.GetPositionX");
+    TRACE_ZONE("Camera.GetPositionX");
     return Interface->cameraGetPositionX();
 }
 
 float CameraGetPositionY() {
-    TRACE_EVENT("Camera.GetPositionY");
+    TRACE_ZONE("Camera.GetPositionY");
     return Interface->cameraGetPositionY();
 }
 
 void CameraSetZoom(float zoom) {
-    TRACE_EVENT("Camera.SetZoom");
+    TRACE_ZONE("Camera.SetZoom");
     Interface->cameraSetZoom(zoom);
 }
 
 float CameraGetZoom() {
-    TRACE_EVENT("Camera.GetZoom");
+    TRACE_ZONE("Camera.GetZoom");
     return Interface->cameraGetZoom();
 }
 
 void SceneLoad(std::string_view name) {
-    TRACE_EVENT("Scene.Load");
+    TRACE_ZONE("Scene.Load");
     Interface->sceneLoad(name);
 }
 
 std::string SceneGetCurrent() {
-    TRACE_EVENT("Scene.GetCurrent");
+    TRACE_ZONE("Scene.GetCurrent");
     return Interface->sceneGetCurrent();
 }
 
 void SceneDontDestroy(game::Actor* actor) {
-    TRACE_EVENT("Scene.DontDestroy");
+    TRACE_ZONE("Scene.DontDestroy");
     Interface->sceneDontDestroy(actor);
 }
 
 auto PhysicsRaycast(const b2Vec2 &pos, const b2Vec2 &direction, float distance) {
-    TRACE_EVENT("Physics.Raycast");
+    TRACE_ZONE("Physics.Raycast");
     return Interface->physicsRaycast(pos, direction, distance);
 }
 
 auto PhysicsRaycastAll(const b2Vec2 &pos, const b2Vec2 &direction, float distance) {
-    TRACE_EVENT("Physics.RaycastAll");
+    TRACE_ZONE("Physics.RaycastAll");
     return Interface->physicsRaycastAll(pos, direction, distance);
 }
 
+float PhysicsGetInterpolationAlpha() {
+    TRACE_ZONE("Physics.GetInterpolationAlpha");
+    return Interface->physicsGetInterpolationAlpha();
+}
+
+float PhysicsGetTimeStep() {
+    TRACE_ZONE("Physics.GetTimeStep");
+    return Interface->physicsGetTimeStep();
+}
+
 void EventPublish(const std::string &eventType, const luabridge::LuaRef &eventObject) {
-    TRACE_EVENT("Event.Publish");
+    TRACE_ZONE("Event.Publish");
     Interface->eventPublish(eventType, eventObject);
 }
 
 void EventPublishRemote(const std::string &eventType, const luabridge::LuaRef &eventObject,
                         bool publishLocally) {
-    TRACE_EVENT("Event.PublishRemote");
+    TRACE_ZONE("Event.PublishRemote");
     Interface->eventPublishRemote(eventType, eventObject, publishLocally);
 }
 
 subscription_handle EventSubscribe(const std::string &event, const luabridge::LuaRef &function) {
-    TRACE_EVENT("Event.Subscribe");
+    TRACE_ZONE("Event.Subscribe");
     return Interface->eventSubscribe(event, function);
 }
 
 void EventUnsubscribe(subscription_handle handle) {
-    TRACE_EVENT("Event.Subscribe");
+    TRACE_ZONE("Event.Subscribe");
     Interface->eventUnsubscribe(handle);
 }
 
+EventChannel EventChannelOf(std::string_view event) {
+    TRACE_ZONE("Event.Channel");
+    return EventChannel{util::Intern(event)};
+}
+
 void MultiplayerConnect(std::string_view host, std::string_view port) {
-    TRACE_EVENT("Multiplayer.Connect");
-    Interface->multiplayerConnect(host, port);
+    TRACE_ZONE("Multiplayer.Connect");
+    Interface->multiplayerConnect(host, port, "");
+}
+
+void MultiplayerConnectRoom(std::string_view host, std::string_view port, std::string_view room) {
+    TRACE_ZONE("Multiplayer.ConnectRoom");
+    Interface->multiplayerConnect(host, port, room);
 }
 
 void MultiplayerDisconnect() {
-    TRACE_EVENT("Multiplayer.Disconnect");
+    TRACE_ZONE("Multiplayer.Disconnect");
     Interface->multiplayerDisconnect();
 }
 
 client_id_t MultiplayerClientID() {
-    TRACE_EVENT("Multiplayer.ClientID");
+    TRACE_ZONE("Multiplayer.ClientID");
     return Interface->multiplayerClientID();
 }
 
 std::vector<client_id_t> MultiplayerJoinedClients() {
-    TRACE_EVENT("Multiplayer.JoinedClients");
+    TRACE_ZONE("Multiplayer.JoinedClients");
     return Interface->multiplayerJoinedClients();
 }
 
 subscription_handle MultiplayerOnClientJoin(const luabridge::LuaRef &function) {
-    TRACE_EVENT("MultiplayerOnClientJoin");
+    TRACE_ZONE("MultiplayerOnClientJoin");
     return Interface->eventSubscribe(events::MultiplayerOnClientJoin, function);
 }
 
 subscription_handle MultiplayerOnClientLeave(const luabridge::LuaRef &function) {
-    TRACE_EVENT("MultiplayerOnClientLeave");
+    TRACE_ZONE("MultiplayerOnClientLeave");
     return Interface->eventSubscribe(events::MultiplayerOnClientLeave, function);
 }
 
 void ReplicatorServiceReplicate(Component* component) {
-    TRACE_EVENT("ReplicatorService.Replicate");
+    TRACE_ZONE("ReplicatorService.Replicate");
     Interface->replicatorServiceReplicate(component);
 }
 
@@ -299,6 +387,16 @@ void InitializeScriptingLibs() {
             // No clue why compiler can't deduce template parameters
             .addFunction<void, const std::string&>("Log", &libs::DebugLog)
             .addFunction<void, const std::string&>("LogError", &libs::DebugLogError)
+            .addFunction<void, const std::string&>("BeginZone", &libs::DebugBeginZone)
+            .addFunction("EndZone", &libs::DebugEndZone)
+            .addFunction("StartTrace", &libs::DebugStartTrace)
+            .addFunction("StopTrace", &libs::DebugStopTrace)
+            .addFunction<bool, const std::string&>("DumpTrace", &libs::DebugDumpTrace)
+            .addFunction("StartProfile", &libs::DebugStartProfile)
+            .addFunction("StopProfile", &libs::DebugStopProfile)
+            .addFunction<bool, const std::string&>("DumpProfile", &libs::DebugDumpProfile)
+            .addFunction<bool, const std::string&>("DumpProfileSummary",
+                                                   &libs::DebugDumpProfileSummary)
         .endNamespace()
         .beginNamespace("Application")
             .addFunction("Quit", &libs::ApplicationQuit)
@@ -354,15 +452,19 @@ void InitializeScriptingLibs() {
         .beginNamespace("Physics")
             .addFunction("Raycast", &libs::PhysicsRaycast)
             .addFunction("RaycastAll", &libs::PhysicsRaycastAll)
+            .addFunction("GetInterpolationAlpha", &libs::PhysicsGetInterpolationAlpha)
+            .addFunction("GetTimeStep", &libs::PhysicsGetTimeStep)
         .endNamespace()
         .beginNamespace("Event")
             .addFunction("Publish", &libs::EventPublish)
             .addFunction("PublishRemote", &libs::EventPublishRemote)
             .addFunction("Subscribe", &libs::EventSubscribe)
             .addFunction("Unsubscribe", &libs::EventUnsubscribe)
+            .addFunction("Channel", &libs::EventChannelOf)
         .endNamespace()
         .beginNamespace("Multiplayer")
             .addFunction("Connect", &libs::MultiplayerConnect)
+            .addFunction("ConnectRoom", &libs::MultiplayerConnectRoom)
             .addFunction("Disconnect", &libs::MultiplayerDisconnect)
             .addFunction("ClientID", &libs::MultiplayerClientID)
             .addFunction("JoinedClients", &libs::MultiplayerJoinedClients)
@@ -381,16 +483,23 @@ void InitializeScriptingClasses() {
     luabridge::getGlobalNamespace(state)
         .beginClass<OpaqueComponentPointer>("OpaqueComponentPointer")
         .endClass()
-        .beginClass<game::Actor>("game::Actor")
-            .addFunction("GetName", &game::Actor::getName)
-            .addFunction("GetID", &game::Actor::getID)
-            .addFunction("GetComponentByKey", &game::Actor::getComponentByKey)
-            .addFunction("GetComponent", &game::Actor::getComponent)
-            .addFunction("GetComponents", &game::Actor::getComponents)
-            .addFunction("AddComponent", &game::Actor::addComponent)
-            .addFunction("RemoveComponent", &game::Actor::removeComponent)
-            .addFunction("GetOwner", &game::Actor::getOwnerClient)
-            .addFunction("PendingServerDestroy", &game::Actor::pendingServerDestroy)
+        .beginClass<EventChannel>("EventChannel")
+            .addFunction("GetName", &EventChannel::getName)
+            .addFunction("Publish", &EventChannel::publish)
+            .addFunction("PublishBatch", &EventChannel::publishBatch)
+            .addFunction("Subscribe", &EventChannel::subscribe)
+        .endClass()
+        .beginClass<game::ActorHandle>("game::Actor")
+            .addFunction("GetName", &libs::ActorMethod<&game::Actor::getName>::call)
+            .addFunction("GetID", &libs::ActorMethod<&game::Actor::getID>::call)
+            .addFunction("GetComponentByKey", &libs::ActorMethod<&game::Actor::getComponentByKey>::call)
+            .addFunction("GetComponent", &libs::ActorMethod<&game::Actor::getComponent>::call)
+            .addFunction("GetComponents", &libs::ActorMethod<&game::Actor::getComponents>::call)
+            .addFunction("AddComponent", &libs::ActorMethod<&game::Actor::addComponent>::call)
+            .addFunction("RemoveComponent", &libs::ActorMethod<&game::Actor::removeComponent>::call)
+            .addFunction("GetOwner", &libs::ActorMethod<&game::Actor::getOwnerClient>::call)
+            .addFunction("PendingServerDestroy", &libs::ActorMethod<&game::Actor::pendingServerDestroy>::call)
+            .addFunction("__eq", &libs::ActorEquals)
         .endClass()
         .beginClass<glm::vec2>("vec2")
             .addProperty("x", &glm::vec2::x)
@@ -418,15 +527,22 @@ void InitializeScriptingClasses() {
         .endClass()
         .deriveClass<Transform, CppComponent>("Transform")
             .addProperty(OpaqueComponentPointerKey, &Transform::__opaquePointer)
-            .addProperty("x", &Transform::x)
-            .addProperty("y", &Transform::y)
-            .addProperty("rotation", &Transform::rotation)
+            .addProperty("x", &Transform::getX, &Transform::setX)
+            .addProperty("y", &Transform::getY, &Transform::setY)
+            .addProperty("rotation", &Transform::getRotation, &Transform::setRotation)
         .endClass()
         .deriveClass<InterpTransform, CppComponent>("InterpTransform")
             .addProperty(OpaqueComponentPointerKey, &InterpTransform::__opaquePointer)
-            .addProperty("x", &InterpTransform::x)
-            .addProperty("y", &InterpTransform::y)
-            .addProperty("rotation", &InterpTransform::rotation)
+            .addProperty("x", &InterpTransform::getX, &InterpTransform::setX)
+            .addProperty("y", &InterpTransform::getY, &InterpTransform::setY)
+            .addProperty("rotation", &InterpTransform::getRotation, &InterpTransform::setRotation)
+        .endClass()
+        .deriveClass<Velocity, CppComponent>("Velocity")
+            .addProperty(OpaqueComponentPointerKey, &Velocity::__opaquePointer)
+            .addProperty("vel_x", &Velocity::vel_x)
+            .addProperty("vel_y", &Velocity::vel_y)
+            .addProperty("angular_velocity", &Velocity::angular_velocity)
+            .addProperty("transform_component", &Velocity::getTransformComponent)
         .endClass()
         .deriveClass<physics::Rigidbody, CppComponent>("Rigidbody")
             .addProperty(OpaqueComponentPointerKey, &physics::Rigidbody::__opaquePointer)
@@ -449,6 +565,8 @@ void InitializeScriptingClasses() {
             .addFunction("SetGravityScale", &physics::Rigidbody::SetGravityScale)
             .addFunction("SetUpDirection", &physics::Rigidbody::SetUpDirection)
             .addFunction("SetRightDirection", &physics::Rigidbody::SetRightDirection)
+            .addFunction("GetRenderPosition", &physics::Rigidbody::GetRenderPosition)
+            .addFunction("GetRenderRotation", &physics::Rigidbody::GetRenderRotation)
         .endClass()
         .beginClass<physics::Collision>("Collision")
             .addProperty("other", &physics::Collision::other, false)
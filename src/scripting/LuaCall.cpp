@@ -0,0 +1,97 @@
+#include "scripting/LuaCall.hpp"
+
+#include <lua/lua.hpp>
+#include <LuaBridge/LuaBridge.h>
+
+#include "util/Trace.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace sge::scripting {
+
+namespace {
+
+int messageHandler(lua_State* L) {
+    const char* message = lua_tostring(L, 1);
+    if (message == nullptr) {
+        // Not a string, so describe the error value instead
+        message = luaL_tolstring(L, 1, nullptr);
+    }
+    luaL_traceback(L, L, message, 1);
+    return 1;
+}
+
+} // namespace
+
+namespace detail {
+
+void CloseLuaZones(unsigned int depth) {
+    while (OpenLuaZones > depth) {
+        EndLuaZone();
+    }
+}
+
+} // namespace detail
+
+void BeginLuaZone(const char* name) {
+    util::BeginTraceZone(name);
+    ++detail::OpenLuaZones;
+}
+
+void EndLuaZone() {
+    if (detail::OpenLuaZones == 0) {
+        return;
+    }
+    --detail::OpenLuaZones;
+    util::EndTraceZone();
+}
+
+ProtectedCall::ProtectedCall(lua_State* L)
+    : L_(L) {
+    // A light C function, so pushing it neither allocates nor looks anything up
+    lua_pushcfunction(L, messageHandler);
+    this->handlerIndex_ = lua_gettop(L);
+}
+
+ProtectedCall::~ProtectedCall() {
+    lua_remove(this->L_, this->handlerIndex_);
+}
+
+bool ProtectedCall::callMethod(const luabridge::LuaRef &fn, const luabridge::LuaRef &self,
+                               std::string_view actorName) {
+    fn.push();
+    self.push();
+    return this->call(1, actorName);
+}
+
+bool ProtectedCall::callMethod(const luabridge::LuaRef &fn, const luabridge::LuaRef &self,
+                               float arg, std::string_view actorName) {
+    fn.push();
+    self.push();
+    lua_pushnumber(this->L_, arg);
+    return this->call(2, actorName);
+}
+
+bool ProtectedCall::call(int nargs, std::string_view actorName) {
+    int status = LUA_OK;
+    {
+        LuaZoneGuard zones;
+        status = lua_pcall(this->L_, nargs, 0, this->handlerIndex_);
+    }
+    if (status == LUA_OK) {
+        return true;
+    }
+
+    // Same format as ActorInvoke
+    const char* message = lua_tostring(this->L_, -1);
+    auto errorMessage = std::string{message != nullptr ? message : "unknown error"};
+    lua_pop(this->L_, 1);
+    std::replace(errorMessage.begin(), errorMessage.end(), '\\', '/');
+    std::cout << "\033[31m" << actorName << " : " << errorMessage << "\033[0m" << std::endl;
+    return false;
+}
+
+} // namespace sge::scripting
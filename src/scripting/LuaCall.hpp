@@ -0,0 +1,108 @@
+#pragma once
+
+#include <lua/lua.hpp>
+#include <LuaBridge/LuaBridge.h>
+
+#include <string_view>
+
+namespace sge::scripting {
+
+namespace detail {
+
+// Zones opened from Lua on this thread that haven't been closed yet
+inline thread_local unsigned int OpenLuaZones = 0;
+
+void CloseLuaZones(unsigned int depth);
+
+} // namespace detail
+
+/**
+ * @brief Open a trace zone for Lua's Debug.BeginZone.
+ */
+void BeginLuaZone(const char* name);
+
+/**
+ * @brief Close the innermost zone opened from Lua, if any, so that a stray
+ * Debug.EndZone can't close a zone opened by the engine.
+ */
+void EndLuaZone();
+
+/**
+ * @brief Closes the zones Lua opens while the guard lives and leaves open,
+ * e.g. by raising an error between Debug.BeginZone and Debug.EndZone, so that
+ * they don't swallow the engine's zones that follow.
+ */
+class LuaZoneGuard {
+public:
+    LuaZoneGuard()
+        : depth_(detail::OpenLuaZones) {}
+
+    ~LuaZoneGuard() {
+        if (detail::OpenLuaZones > this->depth_) [[unlikely]] {
+            detail::CloseLuaZones(this->depth_);
+        }
+    }
+
+    LuaZoneGuard(const LuaZoneGuard &) = delete;
+    LuaZoneGuard &operator=(const LuaZoneGuard &) = delete;
+
+private:
+    unsigned int depth_;
+};
+
+/**
+ * @brief Calls Lua functions with lua_pcall directly, rather than through
+ * LuaRef::operator(). Arguments are pushed without going through LuaBridge's
+ * Stack, no result is kept, and errors are reported on the spot instead of
+ * being thrown as luabridge::LuaException, so a successful call never touches
+ * C++ exception machinery.
+ *
+ * The message handler, which adds a traceback to the error message, stays on
+ * the stack for the lifetime of the object, so one ProtectedCall can make any
+ * number of calls, e.g. every OnUpdate of a frame.
+ */
+class ProtectedCall {
+public:
+    explicit ProtectedCall(lua_State* L);
+    ~ProtectedCall();
+
+    ProtectedCall(const ProtectedCall &) = delete;
+    ProtectedCall &operator=(const ProtectedCall &) = delete;
+
+    /**
+     * @brief Call fn(self).
+     *
+     * @param actorName Actor named in the error report, as with ActorInvoke.
+     * @return Whether the call completed without raising an error.
+     */
+    bool callMethod(const luabridge::LuaRef &fn, const luabridge::LuaRef &self,
+                    std::string_view actorName);
+
+    /**
+     * @brief Call fn(self, arg), e.g. a lifecycle function taking dt.
+     */
+    bool callMethod(const luabridge::LuaRef &fn, const luabridge::LuaRef &self, float arg,
+                    std::string_view actorName);
+
+    /**
+     * @brief Call fn(arg) with any argument LuaBridge can push, e.g. an event
+     * payload.
+     */
+    template <typename Arg>
+    bool callFunction(const luabridge::LuaRef &fn, const Arg &arg, std::string_view actorName) {
+        fn.push();
+        luabridge::Stack<Arg>::push(this->L_, arg);
+        return this->call(1, actorName);
+    }
+
+    /**
+     * @brief Call the function pushed onto the stack below its nargs arguments.
+     */
+    bool call(int nargs, std::string_view actorName);
+
+private:
+    lua_State* L_;
+    int handlerIndex_;
+};
+
+} // namespace sge::scripting
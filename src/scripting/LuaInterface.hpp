@@ -41,7 +41,7 @@ public:
     virtual float inputGetMouseScrollDelta() = 0;
 
     virtual game::Actor* actorFind(std::string_view name) = 0;
-    virtual std::vector<game::Actor*> actorFindAll(std::string_view name) = 0;
+    virtual const std::vector<game::Actor*> &actorFindAll(std::string_view name) = 0;
     virtual game::Actor* actorInstantiate(std::string_view templateName,
                                           std::optional<client_id_t> ownerClient) = 0;
     virtual void actorDestroy(game::Actor* actor) = 0;
@@ -78,6 +78,8 @@ public:
     virtual std::vector<physics::HitResult> physicsRaycastAll(const b2Vec2 &pos,
                                                               const b2Vec2 &direction,
                                                               float distance) = 0;
+    virtual float physicsGetInterpolationAlpha() = 0;
+    virtual float physicsGetTimeStep() = 0;
 
     virtual void eventPublish(std::string_view eventType, const luabridge::LuaRef &value) = 0;
     virtual void eventPublishRemote(std::string_view eventType, const luabridge::LuaRef &value,
@@ -86,7 +88,8 @@ public:
                                                              const luabridge::LuaRef &function) = 0;
     virtual void eventUnsubscribe(subscription_handle handle) = 0;
 
-    virtual void multiplayerConnect(std::string_view host, std::string_view port) = 0;
+    virtual void multiplayerConnect(std::string_view host, std::string_view port,
+                                    std::string_view room) = 0;
     virtual void multiplayerDisconnect() = 0;
     virtual client_id_t multiplayerClientID() = 0;
     virtual std::vector<client_id_t> multiplayerJoinedClients() = 0;
@@ -0,0 +1,371 @@
+#include "scripting/Profiler.hpp"
+
+#include <lua/lua.hpp>
+
+#include "game/Actor.hpp"
+#include "scripting/Component.hpp"
+#include "scripting/Environment.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sge::scripting {
+
+namespace {
+
+// Deepest Lua stack recorded by a sample. Deeper frames are left out.
+constexpr int MaxSampledDepth = 32;
+
+constexpr std::string_view NoActorTemplate = "[no template]";
+
+void appendFrame(std::string &stack, std::string_view frame) {
+    if (!stack.empty()) {
+        stack += ';';
+    }
+    // Semicolons separate frames in the folded format
+    for (char c : frame) {
+        stack += c == ';' ? ':' : c;
+    }
+}
+
+std::string describeFunction(const lua_Debug &ar) {
+    std::string description;
+    if (*ar.what == 'C') {
+        description = "[C] ";
+        description += ar.name != nullptr ? ar.name : "function";
+        return description;
+    }
+    if (*ar.what == 'm') {
+        description = "main";
+    } else {
+        // Functions called by the engine, like lifecycle functions, have no name
+        description = ar.name != nullptr ? ar.name : "function";
+    }
+    description += " (";
+    description += ar.short_src;
+    description += ':';
+    description += std::to_string(ar.linedefined);
+    description += ')';
+    return description;
+}
+
+template <typename V>
+V &entry(unordered_string_map<V> &map, std::string_view key) {
+    auto it = map.find(key);
+    if (it == map.end()) {
+        it = map.try_emplace(std::string{key}).first;
+    }
+    return it->second;
+}
+
+void record(ProfileTiming &timing, std::chrono::nanoseconds total, std::chrono::nanoseconds self) {
+    ++timing.calls;
+    timing.total += total;
+    timing.self += self;
+}
+
+template <typename V, typename Less>
+std::vector<std::pair<std::string_view, const V*>> sorted(const unordered_string_map<V> &map,
+                                                          Less less) {
+    std::vector<std::pair<std::string_view, const V*>> entries;
+    entries.reserve(map.size());
+    for (const auto &[key, value] : map) {
+        entries.emplace_back(key, &value);
+    }
+    std::sort(entries.begin(), entries.end(), [&](const auto &a, const auto &b) {
+        return less(*b.second, *a.second);
+    });
+    return entries;
+}
+
+void writeTimings(std::ostream &out, std::string_view title,
+                  const unordered_string_map<ProfileTiming> &timings) {
+    using Ms = std::chrono::duration<double, std::milli>;
+    out << std::left << std::setw(48) << title << std::right << std::setw(12) << "self ms"
+        << std::setw(12) << "total ms" << std::setw(12) << "calls" << '\n';
+    auto entries = sorted(timings, [](const ProfileTiming &a, const ProfileTiming &b) {
+        return a.self < b.self;
+    });
+    for (const auto &[name, timing] : entries) {
+        out << "  " << std::left << std::setw(46) << name << std::right << std::setw(12)
+            << Ms{timing->self}.count() << std::setw(12) << Ms{timing->total}.count()
+            << std::setw(12) << timing->calls << '\n';
+    }
+    out << '\n';
+}
+
+} // namespace
+
+bool ProfileData::empty() const {
+    return this->stacks.empty() && this->unattributedSamples == 0;
+}
+
+void ProfileData::clear() {
+    this->stacks.clear();
+    this->componentTypes.clear();
+    this->functions.clear();
+    this->actorTemplates.clear();
+    this->luaFunctions.clear();
+    this->unattributedSamples = 0;
+}
+
+void ProfileData::merge(ProfileData &&other) {
+    if (this->empty()) {
+        *this = std::move(other);
+        other.clear();
+        return;
+    }
+
+    for (auto &[key, stack] : other.stacks) {
+        auto &merged = this->stacks[key];
+        merged.self += stack.self;
+        merged.samples += stack.samples;
+        for (const auto &[luaStack, samples] : stack.luaStacks) {
+            merged.luaStacks[luaStack] += samples;
+        }
+    }
+    for (auto [timings, otherTimings] :
+         {std::pair{&this->componentTypes, &other.componentTypes},
+          std::pair{&this->functions, &other.functions},
+          std::pair{&this->actorTemplates, &other.actorTemplates}}) {
+        for (const auto &[key, timing] : *otherTimings) {
+            auto &merged = (*timings)[key];
+            merged.calls += timing.calls;
+            merged.total += timing.total;
+            merged.self += timing.self;
+        }
+    }
+    for (const auto &[key, samples] : other.luaFunctions) {
+        auto &merged = this->luaFunctions[key];
+        merged.self += samples.self;
+        merged.total += samples.total;
+    }
+    this->unattributedSamples += other.unattributedSamples;
+    other.clear();
+}
+
+bool ProfileData::writeFolded(const std::filesystem::path &path) const {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    std::ofstream out{path};
+    if (!out) {
+        return false;
+    }
+    for (const auto &[key, stack] : this->stacks) {
+        auto selfUs = static_cast<std::uint64_t>(duration_cast<microseconds>(stack.self).count());
+        std::uint64_t assigned = 0;
+        if (stack.samples > 0) {
+            for (const auto &[luaStack, samples] : stack.luaStacks) {
+                auto us = selfUs * samples / stack.samples;
+                if (us > 0) {
+                    out << key << ';' << luaStack << ' ' << us << '\n';
+                    assigned += us;
+                }
+            }
+        }
+        // Time that no sample landed in stays with the invocation itself
+        if (selfUs > assigned) {
+            out << key << ' ' << selfUs - assigned << '\n';
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+bool ProfileData::writeSummary(const std::filesystem::path &path) const {
+    std::ofstream out{path};
+    if (!out) {
+        return false;
+    }
+    out << std::fixed << std::setprecision(3);
+    writeTimings(out, "component type", this->componentTypes);
+    writeTimings(out, "function", this->functions);
+    writeTimings(out, "actor template", this->actorTemplates);
+
+    out << std::left << std::setw(48) << "lua function" << std::right << std::setw(12)
+        << "self smp" << std::setw(12) << "total smp" << '\n';
+    auto entries = sorted(this->luaFunctions, [](const ProfileSamples &a, const ProfileSamples &b) {
+        return a.self < b.self;
+    });
+    for (const auto &[name, samples] : entries) {
+        out << "  " << std::left << std::setw(46) << name << std::right << std::setw(12)
+            << samples->self << std::setw(12) << samples->total << '\n';
+    }
+    out << "  " << std::left << std::setw(46) << "[outside lifecycle functions]" << std::right
+        << std::setw(12) << this->unattributedSamples << '\n';
+    return static_cast<bool>(out);
+}
+
+LuaProfiler::LuaProfiler(lua_State* L)
+    : L_(L) {}
+
+void LuaProfiler::start() {
+    this->profile_.clear();
+    this->running_ = true;
+    this->updateRecording();
+}
+
+void LuaProfiler::stop() {
+    if (!this->running_) {
+        return;
+    }
+    this->profile_.merge(std::move(this->tick_));
+    this->running_ = false;
+    this->updateRecording();
+}
+
+bool LuaProfiler::running() const {
+    return this->running_;
+}
+
+void LuaProfiler::setTickCapture(bool enabled) {
+    this->tickCapture_ = enabled;
+    this->updateRecording();
+}
+
+void LuaProfiler::endTick() {
+    if (this->running_) {
+        this->profile_.merge(std::move(this->tick_));
+    } else {
+        this->tick_.clear();
+    }
+}
+
+const ProfileData &LuaProfiler::tick() const {
+    return this->tick_;
+}
+
+const ProfileData &LuaProfiler::profile() {
+    if (this->running_) {
+        this->profile_.merge(std::move(this->tick_));
+    }
+    return this->profile_;
+}
+
+void LuaProfiler::hook(lua_State* L, lua_Debug* /*unused*/) {
+    CurrentEnvironment().profiler().sample(L);
+}
+
+void LuaProfiler::updateRecording() {
+    bool recording = this->running_ || this->tickCapture_;
+    if (recording == this->recording_) {
+        return;
+    }
+    this->recording_ = recording;
+    if (recording) {
+        lua_sethook(this->L_, &LuaProfiler::hook, LUA_MASKCOUNT, LuaProfilerInstructionsPerSample);
+    } else {
+        lua_sethook(this->L_, nullptr, 0, 0);
+        this->frames_.clear();
+        this->tick_.clear();
+        ++this->epoch_;
+    }
+}
+
+void LuaProfiler::enter(const Component &component, const char* function) {
+    auto actorTemplate = NoActorTemplate;
+    if (component.actor != nullptr && !component.actor->templateName().empty()) {
+        actorTemplate = component.actor->templateName().str();
+    }
+
+    Frame frame{
+        .stack = this->frames_.empty() ? std::string{} : this->frames_.back().stack,
+        .componentType = component.type.str(),
+        .function = std::string{component.type.str()} + '.' + function,
+        .actorTemplate = actorTemplate,
+        .start = {},
+    };
+    appendFrame(frame.stack, actorTemplate);
+    appendFrame(frame.stack, frame.function);
+    this->frames_.push_back(std::move(frame));
+    // Start last, so that building the frame isn't part of its time
+    this->frames_.back().start = std::chrono::steady_clock::now();
+}
+
+void LuaProfiler::exit() {
+    auto end = std::chrono::steady_clock::now();
+    auto frame = std::move(this->frames_.back());
+    this->frames_.pop_back();
+
+    auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(end - frame.start);
+    auto self = total - frame.children;
+    if (!this->frames_.empty()) {
+        this->frames_.back().children += total;
+    }
+
+    this->tick_.stacks[frame.stack].self += self;
+    record(entry(this->tick_.componentTypes, frame.componentType), total, self);
+    record(entry(this->tick_.functions, frame.function), total, self);
+    record(entry(this->tick_.actorTemplates, frame.actorTemplate), total, self);
+}
+
+void LuaProfiler::sample(lua_State* L) {
+    if (this->frames_.empty()) {
+        ++this->tick_.unattributedSamples;
+        return;
+    }
+
+    // Collected leaf first
+    std::vector<std::string> functions;
+    std::string line;
+    lua_Debug ar;
+    for (int level = 0; level < MaxSampledDepth && lua_getstack(L, level, &ar) != 0; ++level) {
+        lua_getinfo(L, "Sln", &ar);
+        if (level == 0 && ar.currentline >= 0) {
+            line = std::string{ar.short_src} + ':' + std::to_string(ar.currentline);
+        }
+        functions.push_back(describeFunction(ar));
+    }
+
+    std::string luaStack;
+    for (auto it = functions.rbegin(); it != functions.rend(); ++it) {
+        appendFrame(luaStack, *it);
+    }
+    if (!line.empty()) {
+        appendFrame(luaStack, line);
+    }
+
+    auto &stack = this->tick_.stacks[this->frames_.back().stack];
+    ++stack.samples;
+    ++stack.luaStacks[luaStack];
+
+    for (std::size_t i = 0; i < functions.size(); ++i) {
+        auto &samples = this->tick_.luaFunctions[functions[i]];
+        if (i == 0) {
+            ++samples.self;
+        }
+        // Count recursive functions once per sample
+        if (std::find(functions.begin(), functions.begin() + static_cast<std::ptrdiff_t>(i),
+                      functions[i]) == functions.begin() + static_cast<std::ptrdiff_t>(i)) {
+            ++samples.total;
+        }
+    }
+}
+
+ProfileZone::ProfileZone(const Component &component, const char* function) {
+    auto &profiler = CurrentEnvironment().profiler();
+    if (profiler.recording()) [[unlikely]] {
+        profiler.enter(component, function);
+        this->profiler_ = &profiler;
+        this->epoch_ = profiler.epoch_;
+    }
+}
+
+ProfileZone::~ProfileZone() {
+    if (this->profiler_ != nullptr) [[unlikely]] {
+        if (this->profiler_->epoch_ == this->epoch_ && !this->profiler_->frames_.empty()) {
+            this->profiler_->exit();
+        }
+    }
+}
+
+} // namespace sge::scripting
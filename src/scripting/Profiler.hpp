@@ -0,0 +1,180 @@
+#pragma once
+
+#include <lua/lua.hpp>
+
+#include "util/HeterogeneousLookup.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace sge::scripting {
+
+class Component;
+
+/**
+ * @brief Number of Lua VM instructions between samples of the Lua stack.
+ */
+constexpr int LuaProfilerInstructionsPerSample = 1000;
+
+struct ProfileTiming {
+    std::uint64_t calls{0};
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds self{0};
+};
+
+struct ProfileSamples {
+    // Samples taken while the function was running itself
+    std::uint64_t self{0};
+    // Samples taken while the function was anywhere on the stack
+    std::uint64_t total{0};
+};
+
+/**
+ * @brief Time spent under one stack of lifecycle invocations, e.g. an OnStart
+ * run by an AddComponent call from another component's OnUpdate.
+ */
+struct ProfileStack {
+    std::chrono::nanoseconds self{0};
+    std::uint64_t samples{0};
+    // Lua stacks sampled under the invocation, folded root first
+    unordered_string_map<std::uint64_t> luaStacks;
+};
+
+struct ProfileData {
+    // Keyed by folded invocation stack, e.g. "Player;Shoot.OnUpdate"
+    unordered_string_map<ProfileStack> stacks;
+    unordered_string_map<ProfileTiming> componentTypes;
+    // Keyed by component type and lifecycle function, e.g. "Shoot.OnUpdate"
+    unordered_string_map<ProfileTiming> functions;
+    unordered_string_map<ProfileTiming> actorTemplates;
+    unordered_string_map<ProfileSamples> luaFunctions;
+    // Samples of Lua that ran outside of any lifecycle function
+    std::uint64_t unattributedSamples{0};
+
+    bool empty() const;
+    void clear();
+    void merge(ProfileData &&other);
+
+    /**
+     * @brief Write the profile as folded stacks, one "frame;frame;frame count"
+     * line per stack with counts in microseconds, for flamegraph.pl, speedscope
+     * or inferno.
+     *
+     * The self time of each invocation is split between the Lua stacks sampled
+     * under it in proportion to their samples.
+     */
+    bool writeFolded(const std::filesystem::path &path) const;
+
+    /**
+     * @brief Write self and total time per component type, lifecycle function
+     * and actor template, and samples per Lua function, as a text table.
+     */
+    bool writeSummary(const std::filesystem::path &path) const;
+};
+
+/**
+ * @brief Attributes the time spent in Lua to the component types, lifecycle
+ * functions and actor templates that ran it.
+ *
+ * Every lifecycle function of a LuaComponent is timed with a ProfileZone, and a
+ * count hook samples the Lua stack every LuaProfilerInstructionsPerSample
+ * instructions to break that time down further. Nothing is recorded, and the
+ * hook isn't installed, unless a profile is running or ticks are captured.
+ *
+ * Each scripting environment has its own profiler, used only by the thread the
+ * environment is current on.
+ */
+class LuaProfiler {
+public:
+    explicit LuaProfiler(lua_State* L);
+
+    LuaProfiler(const LuaProfiler &) = delete;
+    LuaProfiler &operator=(const LuaProfiler &) = delete;
+
+    /**
+     * @brief Start a profile, discarding the previous one.
+     */
+    void start();
+    void stop();
+    bool running() const;
+
+    /**
+     * @brief Record every tick, even when no profile is running, so that a
+     * slow tick can be written with tick() before endTick() is called.
+     */
+    void setTickCapture(bool enabled);
+
+    /**
+     * @brief Finish the current tick, adding it to the running profile if
+     * there is one.
+     */
+    void endTick();
+
+    /**
+     * @brief Get what was recorded since the last endTick().
+     */
+    const ProfileData &tick() const;
+
+    /**
+     * @brief Get the running or last profile.
+     */
+    const ProfileData &profile();
+
+    bool recording() const {
+        return this->recording_;
+    }
+
+private:
+    friend class ProfileZone;
+
+    struct Frame {
+        std::string stack;
+        std::string_view componentType;
+        std::string function;
+        std::string_view actorTemplate;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::nanoseconds children{0};
+    };
+
+    static void hook(lua_State* L, lua_Debug* ar);
+
+    void updateRecording();
+    void enter(const Component &component, const char* function);
+    void exit();
+    void sample(lua_State* L);
+
+    lua_State* L_;
+    bool running_{false};
+    bool tickCapture_{false};
+    bool recording_{false};
+    // Changes whenever recording stops, so that zones opened before then don't
+    // close frames opened after
+    std::uint64_t epoch_{0};
+
+    std::vector<Frame> frames_;
+    ProfileData profile_;
+    ProfileData tick_;
+};
+
+/**
+ * @brief Times a lifecycle function of a component for the current
+ * environment's profiler. Costs a thread-local lookup and a branch when nothing
+ * is being recorded.
+ */
+class ProfileZone {
+public:
+    ProfileZone(const Component &component, const char* function);
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+    LuaProfiler* profiler_{nullptr};
+    std::uint64_t epoch_{0};
+};
+
+} // namespace sge::scripting
@@ -2,32 +2,25 @@
 
 #include <lua/lua.hpp>
 
-#include "scripting/Component.hpp"
-#include "scripting/Libs.hpp"
+#include "scripting/Environment.hpp"
+
+#include <memory>
 
 namespace sge::scripting {
 
 namespace {
 
-lua_State* initializeGlobalState() {
-    auto* state = luaL_newstate();
-    luaL_openlibs(state);
-    return state;
-}
-
-lua_State* GlobalLuaState;
+std::unique_ptr<Environment> DefaultEnvironment;
 
 } // namespace
 
 void Initialize() {
-    GlobalLuaState = initializeGlobalState();
-    InitializeComponentTypes();
-    InitializeScriptingLibs();
-    InitializeScriptingClasses();
+    DefaultEnvironment = std::make_unique<Environment>();
+    SetCurrentEnvironment(DefaultEnvironment.get());
 }
 
 lua_State* GetGlobalState() {
-    return GlobalLuaState;
+    return CurrentEnvironment().state();
 }
 
 } // namespace sge::scripting
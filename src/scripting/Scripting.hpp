@@ -5,7 +5,16 @@
 
 namespace sge::scripting {
 
+/**
+ * @brief Create the process-wide scripting environment and make it current on
+ * the calling thread. Used when a process runs a single game.
+ */
 void Initialize();
+
+/**
+ * @brief Get the Lua state of the scripting environment current on the calling
+ * thread.
+ */
 lua_State* GetGlobalState();
 
 } // namespace sge::scripting
@@ -0,0 +1,80 @@
+#include "scripting/TemplatePool.hpp"
+
+#include "scripting/ActorTemplate.hpp"
+#include "scripting/Component.hpp"
+#include "scripting/ComponentContainer.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace sge::scripting {
+
+namespace {
+
+/**
+ * @brief Check whether a container still holds exactly the template's
+ * components, in the same order.
+ */
+bool matchesTemplate(const ActorTemplate &actorTemplate, ComponentContainer &components) {
+    const auto &prototypes = actorTemplate.components();
+    if (components.size() != prototypes.size() || !components.pendingRemoval().empty() ||
+        components.hasPendingAdditions()) {
+        return false;
+    }
+    std::size_t i = 0;
+    for (const auto &entry : components) {
+        const auto &prototype = prototypes[i++];
+        if (entry.key != prototype.key || entry.type != prototype.component->type) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::optional<TemplatePool::RecycledComponents> TemplatePool::take(
+    const ActorTemplate &actorTemplate) {
+    auto it = this->pools_.find(&actorTemplate);
+    if (it == this->pools_.end() || it->second.empty()) {
+        ++this->stats_.misses;
+        return std::nullopt;
+    }
+    ++this->stats_.hits;
+    auto recycled = std::move(it->second.back());
+    it->second.pop_back();
+    return recycled;
+}
+
+void TemplatePool::recycle(const ActorTemplate &actorTemplate, ComponentContainer &components) {
+    auto &pool = this->pools_[&actorTemplate];
+    if (pool.size() >= MaxPerTemplate || !matchesTemplate(actorTemplate, components)) {
+        ++this->stats_.discarded;
+        return;
+    }
+
+    const auto &prototypes = actorTemplate.components();
+    std::size_t i = 0;
+    for (auto &entry : components) {
+        if (!entry.component->reset(*prototypes[i++].component)) {
+            ++this->stats_.discarded;
+            return;
+        }
+    }
+
+    pool.push_back(components.releaseAll());
+    ++this->stats_.recycled;
+}
+
+void TemplatePool::clear() {
+    this->pools_.clear();
+}
+
+const TemplatePoolStats &TemplatePool::stats() const {
+    return this->stats_;
+}
+
+} // namespace sge::scripting
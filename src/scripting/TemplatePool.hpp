@@ -0,0 +1,80 @@
+#pragma once
+
+#include <dnsge/HashMap.hpp>
+
+#include "scripting/ActorTemplate.hpp"
+#include "scripting/Component.hpp"
+#include "scripting/ComponentContainer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace sge::scripting {
+
+struct TemplatePoolStats {
+    // Instantiations of pooled templates that reused recycled components
+    std::uint64_t hits{0};
+    // Instantiations of pooled templates that had to clone the prototypes
+    std::uint64_t misses{0};
+    // Destroyed actors whose components were returned to the pool
+    std::uint64_t recycled{0};
+    // Destroyed actors whose components couldn't be reused, e.g. because
+    // components were added or removed at runtime or the pool was full
+    std::uint64_t discarded{0};
+};
+
+/**
+ * @brief Recycles the components of destroyed actors of pooled templates
+ * (`"pooled": true` in the .template) so that later instantiations of the same
+ * template reuse them, Lua tables included, instead of cloning the template.
+ *
+ * Recycled components are reset to the template's state: engine components
+ * copy the prototype's values again, and Lua components have every field set
+ * on the instance cleared. Lua components then run OnRecycle, if defined,
+ * right before OnStart of the actor that reuses them. Lua code must not hold
+ * on to components of destroyed actors, since they may belong to a new actor.
+ */
+class TemplatePool {
+public:
+    using RecycledComponents = std::vector<std::unique_ptr<Component>>;
+
+    // Recycled component sets kept per template. More are destroyed instead.
+    static constexpr std::size_t MaxPerTemplate = 256;
+
+    TemplatePool() = default;
+
+    TemplatePool(const TemplatePool &) = delete;
+    TemplatePool &operator=(const TemplatePool &) = delete;
+    TemplatePool(TemplatePool &&) = default;
+    TemplatePool &operator=(TemplatePool &&) = default;
+
+    /**
+     * @brief Take recycled components for a new actor of a template, in the
+     * order of the template's prototypes, if there are any.
+     */
+    std::optional<RecycledComponents> take(const ActorTemplate &actorTemplate);
+
+    /**
+     * @brief Reset and take the components of a destroyed actor of a pooled
+     * template. Components that can't be reused are left in the container.
+     *
+     * @param actorTemplate Template the actor was instantiated from.
+     * @param components Components of the actor.
+     */
+    void recycle(const ActorTemplate &actorTemplate, ComponentContainer &components);
+
+    void clear();
+
+    const TemplatePoolStats &stats() const;
+
+private:
+    // Keyed by template instance rather than name, since templates may share a
+    // display name. Instances live as long as the scripting environment.
+    dnsge::HashMap<const ActorTemplate*, std::vector<RecycledComponents>> pools_;
+    TemplatePoolStats stats_{};
+};
+
+} // namespace sge::scripting
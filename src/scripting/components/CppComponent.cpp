@@ -2,14 +2,12 @@
 
 #include "Realm.hpp"
 #include "scripting/Component.hpp"
-
-#include <string>
-#include <utility>
+#include "util/Symbol.hpp"
 
 namespace sge::scripting {
 
-CppComponent::CppComponent(std::string type, Realm realm)
-    : Component(std::move(type), realm) {}
+CppComponent::CppComponent(util::Symbol type, Realm realm)
+    : Component(type, realm) {}
 
 bool CppComponent::getEnabled() const {
     return this->enabled;
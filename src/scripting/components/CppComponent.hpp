@@ -5,6 +5,8 @@
 
 #include "Realm.hpp"
 #include "scripting/Component.hpp"
+#include "util/Arena.hpp"
+#include "util/Symbol.hpp"
 
 #include <string>
 
@@ -27,9 +29,14 @@ T MustGet(const V &variant) {
     return std::get<T>(variant);
 }
 
-class CppComponent : public Component {
+/**
+ * @brief A component implemented by the engine. Allocated from the arena of the
+ * scene that instantiates it. Components whose OnUpdate doesn't need Lua can
+ * override parallelUpdate to run it on the job system, like Velocity.
+ */
+class CppComponent : public Component, public util::ArenaAllocated {
 public:
-    CppComponent(std::string type, Realm realm);
+    CppComponent(util::Symbol type, Realm realm);
     ~CppComponent() override = default;
 
     bool getEnabled() const override;
@@ -1,12 +1,13 @@
 #include "scripting/components/InterpTransform.hpp"
 
-#include "Common.hpp"
 #include "Realm.hpp"
 #include "net/Replicator.hpp"
 #include "resources/Deserialize.hpp"
 #include "scripting/Component.hpp"
 #include "scripting/Scripting.hpp"
 #include "scripting/components/CppComponent.hpp"
+#include "scripting/components/TransformPool.hpp"
+#include "util/Symbol.hpp"
 
 #include <chrono>
 #include <memory>
@@ -16,10 +17,33 @@
 
 namespace sge::scripting {
 
+namespace {
+
+const auto InterpTransformType = util::Intern("InterpTransform");
+
+} // namespace
+
 InterpTransform::InterpTransform(Realm realm)
-    : CppComponent("InterpTransform", realm)
+    : CppComponent(InterpTransformType, realm)
     , __opaquePointer{this}
-    , ref_{GetGlobalState(), this} {}
+    , pool_(CurrentTransformPool())
+    , ref_{GetGlobalState(), this} {
+    if (this->pool_ != nullptr) {
+        this->columns_ = &this->pool_->interpTransforms;
+        this->slot_ = this->pool_->addInterpTransform(this);
+    } else {
+        this->detached_ = std::make_unique<TransformColumns>(
+            TransformColumns{.x = {0.0F}, .y = {0.0F}, .rotation = {0.0F}});
+        this->columns_ = this->detached_.get();
+        this->slot_ = 0;
+    }
+}
+
+InterpTransform::~InterpTransform() {
+    if (this->pool_ != nullptr) {
+        this->pool_->removeInterpTransform(this->slot_);
+    }
+}
 
 const luabridge::LuaRef &InterpTransform::ref() const {
     return this->ref_;
@@ -27,97 +51,90 @@ const luabridge::LuaRef &InterpTransform::ref() const {
 
 std::unique_ptr<Component> InterpTransform::clone() const {
     auto newTransform = std::make_unique<InterpTransform>(this->realm);
-    newTransform->x = this->x;
-    newTransform->y = this->y;
-    newTransform->rotation = this->rotation;
+    newTransform->copyValues(*this);
     return newTransform;
 }
 
-void InterpTransform::setValues(
-    const std::vector<std::pair<std::string, ComponentValueType>> &values) {
-    for (const auto &[name, val] : values) {
-        if (name == "x") {
-            this->x = MustGet<float>(val);
-        } else if (name == "y") {
-            this->y = MustGet<float>(val);
-        } else if (name == "rotation") {
-            this->rotation = MustGet<float>(val);
-        }
+bool InterpTransform::reset(const Component &prototype) {
+    this->copyValues(static_cast<const InterpTransform &>(prototype));
+    if (this->pool_ != nullptr) {
+        this->pool_->clearInterps(this->slot_);
     }
+    this->resetLifecycle();
+    return true;
 }
 
-void InterpTransform::onUpdate(float dt) {
-    if (CurrentRealm() != GeneralRealm::Client) {
-        return;
-    }
+void InterpTransform::copyValues(const InterpTransform &other) {
+    this->setX(other.getX());
+    this->setY(other.getY());
+    this->setRotation(other.getRotation());
+}
 
-    if (this->interps_.empty()) {
-        if (this->actor->pendingServerDestroy()) {
-            // We have no more interpolated movement so we can go ahead and actually
-            // destroy this actor for good.
-            this->actor->destroy();
-        }
-        return;
-    }
+float InterpTransform::getX() const {
+    return this->columns_->x[this->slot_];
+}
 
-    using namespace std::chrono;
+void InterpTransform::setX(float x) {
+    this->columns_->x[this->slot_] = x;
+}
 
-    auto now = steady_clock::now();
-    auto delta = duration_cast<microseconds>(now - this->interps_.front().time);
-    float frac = static_cast<float>(delta.count()) / CurrentGame().tickDuration().count();
+float InterpTransform::getY() const {
+    return this->columns_->y[this->slot_];
+}
 
-    while (frac >= 1.0F && this->interps_.size() >= 2) {
-        this->interpStart_ = this->interps_.front();
-        this->interps_.pop_front();
-        delta = duration_cast<microseconds>(now - this->interps_.front().time);
-        frac = static_cast<float>(delta.count()) / CurrentGame().tickDuration().count();
-    }
+void InterpTransform::setY(float y) {
+    this->columns_->y[this->slot_] = y;
+}
 
-    const auto &next = this->interps_.front();
-    if (frac >= 1.0F) {
-        this->x = next.x;
-        this->y = next.y;
-        this->rotation = next.rotation;
-        this->interps_.pop_front();
-    } else {
-        this->x = (next.x - this->interpStart_.x) * frac + this->interpStart_.x;
-        this->y = (next.y - this->interpStart_.y) * frac + this->interpStart_.y;
-        this->rotation = this->interpStart_.rotation; // Don't interp rotation
+float InterpTransform::getRotation() const {
+    return this->columns_->rotation[this->slot_];
+}
+
+void InterpTransform::setRotation(float rotation) {
+    this->columns_->rotation[this->slot_] = rotation;
+}
+
+void InterpTransform::setValues(
+    const std::vector<std::pair<std::string, ComponentValueType>> &values) {
+    for (const auto &[name, val] : values) {
+        if (name == "x") {
+            this->setX(MustGet<float>(val));
+        } else if (name == "y") {
+            this->setY(MustGet<float>(val));
+        } else if (name == "rotation") {
+            this->setRotation(MustGet<float>(val));
+        }
     }
 }
 
 void InterpTransform::replicatePush(net::ReplicatePush &r) {
-    r.writeNumber(this->x);
-    r.writeNumber(this->y);
-    r.writeNumber(this->rotation);
+    r.writeNumber(this->getX());
+    r.writeNumber(this->getY());
+    r.writeNumber(this->getRotation());
 }
 
 void InterpTransform::replicatePull(net::ReplicatePull &r) {
     if (!r.doInterp()) {
         // Standard non-interpolation behavior. Read the desired transform
         // and immediately update the component.
-        this->x = r.readNumber();
-        this->y = r.readNumber();
-        this->rotation = r.readNumber();
+        this->setX(r.readNumber());
+        this->setY(r.readNumber());
+        this->setRotation(r.readNumber());
         return;
     }
 
-    auto now = std::chrono::steady_clock::now();
-
-    if (this->interps_.empty()) {
-        this->interpStart_ = InterpState{
-            this->x,
-            this->y,
-            this->rotation,
-            now,
-        };
-    }
-
     float ix = r.readNumber();
     float iy = r.readNumber();
     float ir = r.readNumber();
 
-    this->interps_.emplace_back(ix, iy, ir, now);
+    if (this->pool_ == nullptr) {
+        // Not part of a scene, so nothing would ever move it
+        this->setX(ix);
+        this->setY(iy);
+        this->setRotation(ir);
+        return;
+    }
+    this->pool_->pushInterp(this->slot_, ix, iy, ir, std::chrono::steady_clock::now());
 }
 
 } // namespace sge::scripting
@@ -5,9 +5,8 @@
 #include "resources/Deserialize.hpp"
 #include "scripting/Component.hpp"
 #include "scripting/components/CppComponent.hpp"
+#include "scripting/components/TransformPool.hpp"
 
-#include <chrono>
-#include <deque>
 #include <memory>
 #include <string>
 #include <utility>
@@ -18,43 +17,39 @@ namespace sge::scripting {
 class InterpTransform : public CppComponent {
 public:
     InterpTransform(Realm realm);
-    ~InterpTransform() override = default;
+    ~InterpTransform() override;
 
     const luabridge::LuaRef &ref() const override;
 
     std::unique_ptr<Component> clone() const override;
     void setValues(const std::vector<std::pair<std::string, ComponentValueType>> &values) override;
+    bool reset(const Component &prototype) override;
 
-    void onUpdate(float dt) override;
     void replicatePush(net::ReplicatePush &r) override;
     void replicatePull(net::ReplicatePull &r) override;
 
-    OpaqueComponentPointer __opaquePointer;
+    float getX() const;
+    void setX(float x);
+    float getY() const;
+    void setY(float y);
+    float getRotation() const;
+    void setRotation(float rotation);
 
-    float x{0.0F};
-    float y{0.0F};
-    float rotation{0.0F};
+    OpaqueComponentPointer __opaquePointer;
 
 private:
-    struct InterpState {
-        float x;
-        float y;
-        float rotation;
-        std::chrono::steady_clock::time_point time;
+    friend class TransformPool;
 
-        InterpState() = default;
+    void copyValues(const InterpTransform &other);
 
-        InterpState(float x, float y, float rotation, std::chrono::steady_clock::time_point time)
-            : x(x)
-            , y(y)
-            , rotation(rotation)
-            , time(time) {}
-    };
+    // The scene's pool, or nullptr if the values are stored in detached_
+    TransformPool* pool_;
+    std::unique_ptr<TransformColumns> detached_;
+    // Where the values are stored: the pool's columns or detached_
+    TransformColumns* columns_;
+    transform_slot_t slot_;
 
     luabridge::LuaRef ref_;
-
-    std::deque<InterpState> interps_;
-    InterpState interpStart_;
 };
 
 } // namespace sge::scripting
@@ -1,12 +1,16 @@
 #include "scripting/components/LuaComponent.hpp"
 
 #include "Realm.hpp"
+#include "game/Actor.hpp"
 #include "net/Replicator.hpp"
 #include "physics/Collision.hpp"
 #include "resources/Deserialize.hpp"
 #include "scripting/Component.hpp"
+#include "scripting/LuaCall.hpp"
+#include "scripting/Profiler.hpp"
 
 #include <cassert>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -17,6 +21,8 @@ namespace sge::scripting {
 
 namespace {
 
+constexpr const char* EnabledKey = "enabled";
+
 void establishInheritance(luabridge::LuaRef &child, const luabridge::LuaRef &parent) {
     assert(child.state() == parent.state());
 
@@ -35,20 +41,40 @@ void establishInheritance(luabridge::LuaRef &child, const luabridge::LuaRef &par
 
 LuaComponent::LuaComponent(const ComponentType &baseType, Realm realm)
     : Component(baseType.name, realm)
-    , ref_(luabridge::newTable(baseType.ref.state())) {
+    , ref_(luabridge::newTable(baseType.ref.state()))
+    , shadow_(luabridge::newTable(baseType.ref.state())) {
     // Establish inheritance of component
-    establishInheritance(this->ref_, baseType.ref);
+    establishInheritance(this->shadow_, baseType.ref);
+    this->installMetatable();
     // Store opaque pointer to this component
     this->ref_[OpaqueComponentPointerKey] = OpaqueComponentPointer{this};
+    this->refreshEnabled();
 }
 
 LuaComponent::LuaComponent(const LuaComponent &parent, Realm realm)
     : Component(parent.type, realm)
-    , ref_(luabridge::newTable(parent.ref_.state())) {
+    , ref_(luabridge::newTable(parent.ref_.state()))
+    , shadow_(luabridge::newTable(parent.ref_.state())) {
     // Establish inheritance of component
-    establishInheritance(this->ref_, parent.ref_);
+    establishInheritance(this->shadow_, parent.ref_);
+    this->installMetatable();
     // Store opaque pointer to this component
     this->ref_[OpaqueComponentPointerKey] = OpaqueComponentPointer{this};
+    this->refreshEnabled();
+}
+
+LuaComponent::~LuaComponent() {
+    // Scripts may keep the instance after the component is gone, so detach
+    // __newindex, which points at this component. Writes then land on the
+    // instance like on any other table.
+    auto* l = this->ref_.state();
+    this->ref_.push();
+    if (lua_getmetatable(l, -1) != 0) {
+        lua_pushnil(l);
+        lua_setfield(l, -2, "__newindex");
+        lua_pop(l, 1);
+    }
+    lua_pop(l, 1);
 }
 
 std::unique_ptr<Component> LuaComponent::clone() const {
@@ -67,24 +93,30 @@ void LuaComponent::initialize() {
     }
     if (auto ref = this->ref_["OnUpdate"]; ref.isFunction()) {
         this->onUpdate_.emplace(std::move(ref));
+        this->lifecycleHandlers_ |= LifecycleBit(Lifecycle::OnUpdate);
     }
     if (auto ref = this->ref_["OnLateUpdate"]; ref.isFunction()) {
         this->onLateUpdate_.emplace(std::move(ref));
+        this->lifecycleHandlers_ |= LifecycleBit(Lifecycle::OnLateUpdate);
     }
     if (auto ref = this->ref_["OnDestroy"]; ref.isFunction()) {
         this->onDestroy_.emplace(std::move(ref));
     }
     if (auto ref = this->ref_["OnCollisionEnter"]; ref.isFunction()) {
         this->onCollisionEnter_.emplace(std::move(ref));
+        this->lifecycleHandlers_ |= LifecycleBit(Lifecycle::OnCollisionEnter);
     }
     if (auto ref = this->ref_["OnCollisionExit"]; ref.isFunction()) {
         this->onCollisionExit_.emplace(std::move(ref));
+        this->lifecycleHandlers_ |= LifecycleBit(Lifecycle::OnCollisionExit);
     }
     if (auto ref = this->ref_["OnTriggerEnter"]; ref.isFunction()) {
         this->onTriggerEnter_.emplace(std::move(ref));
+        this->lifecycleHandlers_ |= LifecycleBit(Lifecycle::OnTriggerEnter);
     }
     if (auto ref = this->ref_["OnTriggerExit"]; ref.isFunction()) {
         this->onTriggerExit_.emplace(std::move(ref));
+        this->lifecycleHandlers_ |= LifecycleBit(Lifecycle::OnTriggerExit);
     }
     if (auto ref = this->ref_["ReplicatePush"]; ref.isFunction()) {
         this->replicatePush_.emplace(std::move(ref));
@@ -94,12 +126,31 @@ void LuaComponent::initialize() {
     }
 }
 
+LifecycleMask LuaComponent::lifecycleHandlers() const {
+    return this->lifecycleHandlers_;
+}
+
+const luabridge::LuaRef* LuaComponent::luaFunction(Lifecycle lifecycle) const {
+    const std::optional<luabridge::LuaRef>* function = nullptr;
+    switch (lifecycle) {
+    case Lifecycle::OnUpdate:
+        function = &this->onUpdate_;
+        break;
+    case Lifecycle::OnLateUpdate:
+        function = &this->onLateUpdate_;
+        break;
+    default:
+        return nullptr;
+    }
+    return function->has_value() ? &**function : nullptr;
+}
+
 void LuaComponent::setActor(game::Actor* actor) {
     Component::setActor(actor);
     this->ref_["actor"] = actor;
 }
 
-void LuaComponent::setKey(const std::string &key) {
+void LuaComponent::setKey(ComponentKey key) {
     Component::setKey(key);
     this->ref_["key"] = key;
 }
@@ -121,77 +172,175 @@ void LuaComponent::setValues(
     }
 }
 
+bool LuaComponent::reset(const Component & /*unused*/) {
+    // Clear every field set on the instance, so that the template's values show
+    // through its metatable again. Fields may be cleared while traversing.
+    auto* l = this->ref_.state();
+    this->ref_.push();
+    lua_pushnil(l);
+    while (lua_next(l, -2) != 0) {
+        lua_pop(l, 1); // Pop value, keep key for the next iteration
+        if (lua_type(l, -1) == LUA_TSTRING &&
+            std::strcmp(lua_tostring(l, -1), OpaqueComponentPointerKey) == 0) {
+            continue;
+        }
+        lua_pushvalue(l, -1);
+        lua_pushnil(l);
+        lua_rawset(l, -4);
+    }
+    lua_pop(l, 1);
+    this->shadow_[EnabledKey].rawset(luabridge::Nil{});
+    this->refreshEnabled();
+
+    this->lifecycleHandlers_ = 0;
+    for (auto* handler : {&this->onStart_, &this->onUpdate_, &this->onLateUpdate_,
+                          &this->onDestroy_, &this->onCollisionEnter_, &this->onCollisionExit_,
+                          &this->onTriggerEnter_, &this->onTriggerExit_, &this->replicatePush_,
+                          &this->replicatePull_}) {
+        handler->reset();
+    }
+    this->recycled_ = true;
+    this->resetLifecycle();
+    return true;
+}
+
 bool LuaComponent::getEnabled() const {
-    assert(this->ref_.isTable());
+    return this->enabled_;
+}
+
+void LuaComponent::setEnabled(bool enabled) {
+    this->enabled_ = enabled;
+    this->shadow_[EnabledKey].rawset(enabled);
+}
 
+void LuaComponent::installMetatable() {
+    // Reads of the instance fall through to the shadow table, and from there to
+    // the parent. Writes of keys the instance doesn't have go to __newindex,
+    // which is how every write of "enabled" reaches this component.
     auto* l = this->ref_.state();
-    this->ref_.push();                      // Push table onto stack
-    lua_getfield(l, -1, "enabled");         // Access "enabled" key in table
-    bool value = lua_toboolean(l, -1) != 0; // Convert value to boolean
-    lua_pop(l, 2);                          // Clean up lua stack
+    this->ref_.push();
+    lua_createtable(l, 0, 2);
+    this->shadow_.push();
+    lua_setfield(l, -2, "__index");
+    lua_pushlightuserdata(l, this);
+    this->shadow_.push();
+    lua_pushcclosure(l, &LuaComponent::newIndex, 2);
+    lua_setfield(l, -2, "__newindex");
+    lua_setmetatable(l, -2);
+    lua_pop(l, 1);
+}
 
-    return value;
+void LuaComponent::refreshEnabled() {
+    // The value inherited from the template or component type, if any
+    auto* l = this->ref_.state();
+    this->ref_.push();
+    lua_getfield(l, -1, EnabledKey);
+    this->enabled_ = lua_toboolean(l, -1) != 0;
+    lua_pop(l, 2);
 }
 
-void LuaComponent::setEnabled(bool enabled) {
-    this->ref_["enabled"] = enabled;
+int LuaComponent::newIndex(lua_State* L) {
+    // Called with the instance, key and value, with the component and its
+    // shadow table as upvalues. L may be a coroutine, so everything is done on
+    // L rather than through the component's LuaRefs, which use the main thread.
+    if (lua_type(L, 2) == LUA_TSTRING && std::strcmp(lua_tostring(L, 2), EnabledKey) == 0) {
+        auto* component = static_cast<LuaComponent*>(lua_touserdata(L, lua_upvalueindex(1)));
+        bool enabled = lua_toboolean(L, 3) != 0;
+        bool cleared = lua_isnil(L, 3);
+        // Keep the value as written, so that scripts read back exactly that
+        lua_pushvalue(L, lua_upvalueindex(2));
+        lua_insert(L, 2);
+        lua_rawset(L, 2);
+        if (cleared) {
+            // Reads now fall through to the parent's value, same as
+            // refreshEnabled
+            lua_getfield(L, 1, EnabledKey);
+            enabled = lua_toboolean(L, -1) != 0;
+        }
+        component->enabled_ = enabled;
+        return 0;
+    }
+    lua_rawset(L, 1);
+    return 0;
 }
 
 void LuaComponent::onStart() {
+    ProtectedCall call{this->ref_.state()};
+    if (std::exchange(this->recycled_, false)) {
+        if (auto onRecycle = this->ref_["OnRecycle"]; onRecycle.isFunction()) {
+            ProfileZone zone{*this, "OnRecycle"};
+            if (!call.callMethod(onRecycle, this->ref_, this->actor->name.str())) {
+                return;
+            }
+        }
+    }
     if (this->onStart_.has_value()) {
-        (*this->onStart_)(this->ref_);
+        ProfileZone zone{*this, "OnStart"};
+        call.callMethod(*this->onStart_, this->ref_, this->actor->name.str());
     }
 }
 
 void LuaComponent::onUpdate(float dt) {
     if (this->onUpdate_.has_value()) {
-        (*this->onUpdate_)(this->ref_, dt);
+        ProfileZone zone{*this, "OnUpdate"};
+        ProtectedCall call{this->ref_.state()};
+        call.callMethod(*this->onUpdate_, this->ref_, dt, this->actor->name.str());
     }
 }
 
 void LuaComponent::onLateUpdate(float dt) {
     if (this->onLateUpdate_.has_value()) {
-        (*this->onLateUpdate_)(this->ref_, dt);
+        ProfileZone zone{*this, "OnLateUpdate"};
+        ProtectedCall call{this->ref_.state()};
+        call.callMethod(*this->onLateUpdate_, this->ref_, dt, this->actor->name.str());
     }
 }
 
 void LuaComponent::onDestroy() {
     if (this->onDestroy_.has_value()) {
-        (*this->onDestroy_)(this->ref_);
+        ProfileZone zone{*this, "OnDestroy"};
+        ProtectedCall call{this->ref_.state()};
+        call.callMethod(*this->onDestroy_, this->ref_, this->actor->name.str());
     }
 }
 
 void LuaComponent::onCollisionEnter(const physics::Collision &collision) {
     if (this->onCollisionEnter_.has_value()) {
+        ProfileZone zone{*this, "OnCollisionEnter"};
         (*this->onCollisionEnter_)(this->ref_, collision);
     }
 }
 
 void LuaComponent::onCollisionExit(const physics::Collision &collision) {
     if (this->onCollisionExit_.has_value()) {
+        ProfileZone zone{*this, "OnCollisionExit"};
         (*this->onCollisionExit_)(this->ref_, collision);
     }
 }
 void LuaComponent::onTriggerEnter(const physics::Collision &collision) {
     if (this->onTriggerEnter_.has_value()) {
+        ProfileZone zone{*this, "OnTriggerEnter"};
         (*this->onTriggerEnter_)(this->ref_, collision);
     }
 }
 
 void LuaComponent::onTriggerExit(const physics::Collision &collision) {
     if (this->onTriggerExit_.has_value()) {
+        ProfileZone zone{*this, "OnTriggerExit"};
         (*this->onTriggerExit_)(this->ref_, collision);
     }
 }
 
 void LuaComponent::replicatePush(net::ReplicatePush &push) {
     if (this->replicatePush_.has_value()) {
+        ProfileZone zone{*this, "ReplicatePush"};
         (*this->replicatePush_)(this->ref_, push);
     }
 }
 
 void LuaComponent::replicatePull(net::ReplicatePull &pull) {
     if (this->replicatePull_.has_value()) {
+        ProfileZone zone{*this, "ReplicatePull"};
         (*this->replicatePull_)(this->ref_, pull);
     }
 }
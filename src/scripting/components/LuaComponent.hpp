@@ -19,19 +19,25 @@ public:
     LuaComponent(const ComponentType &baseType, Realm realm);
     LuaComponent(const LuaComponent &parent, Realm realm);
 
+    ~LuaComponent() override;
+
+    // The Lua instance holds a pointer to the component, so it can't move
     LuaComponent &operator=(const LuaComponent &other) = delete;
-    LuaComponent(LuaComponent &&inherited) noexcept = default;
-    LuaComponent &operator=(LuaComponent &&inherited) noexcept = default;
+    LuaComponent(LuaComponent &&inherited) = delete;
+    LuaComponent &operator=(LuaComponent &&inherited) = delete;
 
     std::unique_ptr<Component> clone() const override;
 
     const luabridge::LuaRef &ref() const override;
 
     void initialize() override;
+    LifecycleMask lifecycleHandlers() const override;
+    const luabridge::LuaRef* luaFunction(Lifecycle lifecycle) const override;
 
     void setActor(game::Actor* actor) override;
-    void setKey(const std::string &key) override;
+    void setKey(ComponentKey key) override;
     void setValues(const std::vector<std::pair<std::string, ComponentValueType>> &values) override;
+    bool reset(const Component &prototype) override;
 
     bool getEnabled() const override;
     void setEnabled(bool enabled) override;
@@ -50,7 +56,19 @@ public:
     void replicatePull(net::ReplicatePull &pull) override;
 
 private:
+    void installMetatable();
+    void refreshEnabled();
+    static int newIndex(lua_State* L);
+
     luabridge::LuaRef ref_;
+    // Sits between the instance and its parent, holding "enabled" so that it
+    // never becomes a field of the instance and every write to it is seen
+    luabridge::LuaRef shadow_;
+    // Mirrors the truthiness of "enabled", so lifecycle checks never touch Lua
+    bool enabled_{false};
+    LifecycleMask lifecycleHandlers_{0};
+    // Set when recycled for another actor, until OnRecycle has run
+    bool recycled_{false};
     std::optional<luabridge::LuaRef> onStart_ = std::nullopt;
     std::optional<luabridge::LuaRef> onUpdate_ = std::nullopt;
     std::optional<luabridge::LuaRef> onLateUpdate_ = std::nullopt;
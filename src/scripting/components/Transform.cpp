@@ -6,6 +6,8 @@
 #include "scripting/Component.hpp"
 #include "scripting/Scripting.hpp"
 #include "scripting/components/CppComponent.hpp"
+#include "scripting/components/TransformPool.hpp"
+#include "util/Symbol.hpp"
 
 #include <memory>
 #include <string>
@@ -14,10 +16,33 @@
 
 namespace sge::scripting {
 
+namespace {
+
+const auto TransformType = util::Intern("Transform");
+
+} // namespace
+
 Transform::Transform(Realm realm)
-    : CppComponent("Transform", realm)
+    : CppComponent(TransformType, realm)
     , __opaquePointer{this}
-    , ref_{GetGlobalState(), this} {}
+    , pool_(CurrentTransformPool())
+    , ref_{GetGlobalState(), this} {
+    if (this->pool_ != nullptr) {
+        this->columns_ = &this->pool_->transforms;
+        this->slot_ = this->pool_->addTransform(this);
+    } else {
+        this->detached_ = std::make_unique<TransformColumns>(
+            TransformColumns{.x = {0.0F}, .y = {0.0F}, .rotation = {0.0F}});
+        this->columns_ = this->detached_.get();
+        this->slot_ = 0;
+    }
+}
+
+Transform::~Transform() {
+    if (this->pool_ != nullptr) {
+        this->pool_->removeTransform(this->slot_);
+    }
+}
 
 const luabridge::LuaRef &Transform::ref() const {
     return this->ref_;
@@ -25,34 +50,68 @@ const luabridge::LuaRef &Transform::ref() const {
 
 std::unique_ptr<Component> Transform::clone() const {
     auto newTransform = std::make_unique<Transform>(this->realm);
-    newTransform->x = this->x;
-    newTransform->y = this->y;
-    newTransform->rotation = this->rotation;
+    newTransform->copyValues(*this);
     return newTransform;
 }
 
+bool Transform::reset(const Component &prototype) {
+    this->copyValues(static_cast<const Transform &>(prototype));
+    this->resetLifecycle();
+    return true;
+}
+
+void Transform::copyValues(const Transform &other) {
+    this->setX(other.getX());
+    this->setY(other.getY());
+    this->setRotation(other.getRotation());
+}
+
+float Transform::getX() const {
+    return this->columns_->x[this->slot_];
+}
+
+void Transform::setX(float x) {
+    this->columns_->x[this->slot_] = x;
+}
+
+float Transform::getY() const {
+    return this->columns_->y[this->slot_];
+}
+
+void Transform::setY(float y) {
+    this->columns_->y[this->slot_] = y;
+}
+
+float Transform::getRotation() const {
+    return this->columns_->rotation[this->slot_];
+}
+
+void Transform::setRotation(float rotation) {
+    this->columns_->rotation[this->slot_] = rotation;
+}
+
 void Transform::setValues(const std::vector<std::pair<std::string, ComponentValueType>> &values) {
     for (const auto &[name, val] : values) {
         if (name == "x") {
-            this->x = MustGet<float>(val);
+            this->setX(MustGet<float>(val));
         } else if (name == "y") {
-            this->y = MustGet<float>(val);
+            this->setY(MustGet<float>(val));
         } else if (name == "rotation") {
-            this->rotation = MustGet<float>(val);
+            this->setRotation(MustGet<float>(val));
         }
     }
 }
 
 void Transform::replicatePush(net::ReplicatePush &r) {
-    r.writeNumber(this->x);
-    r.writeNumber(this->y);
-    r.writeNumber(this->rotation);
+    r.writeNumber(this->getX());
+    r.writeNumber(this->getY());
+    r.writeNumber(this->getRotation());
 }
 
 void Transform::replicatePull(net::ReplicatePull &r) {
-    this->x = r.readNumber();
-    this->y = r.readNumber();
-    this->rotation = r.readNumber();
+    this->setX(r.readNumber());
+    this->setY(r.readNumber());
+    this->setRotation(r.readNumber());
 }
 
 } // namespace sge::scripting
@@ -5,6 +5,7 @@
 #include "resources/Deserialize.hpp"
 #include "scripting/Component.hpp"
 #include "scripting/components/CppComponent.hpp"
+#include "scripting/components/TransformPool.hpp"
 
 #include <memory>
 #include <string>
@@ -16,23 +17,38 @@ namespace sge::scripting {
 class Transform : public CppComponent {
 public:
     Transform(Realm realm);
-    ~Transform() override = default;
+    ~Transform() override;
 
     const luabridge::LuaRef &ref() const override;
 
     std::unique_ptr<Component> clone() const override;
     void setValues(const std::vector<std::pair<std::string, ComponentValueType>> &values) override;
+    bool reset(const Component &prototype) override;
 
     void replicatePush(net::ReplicatePush &r) override;
     void replicatePull(net::ReplicatePull &r) override;
 
-    OpaqueComponentPointer __opaquePointer;
+    float getX() const;
+    void setX(float x);
+    float getY() const;
+    void setY(float y);
+    float getRotation() const;
+    void setRotation(float rotation);
 
-    float x{0.0F};
-    float y{0.0F};
-    float rotation{0.0F};
+    OpaqueComponentPointer __opaquePointer;
 
 private:
+    friend class TransformPool;
+
+    void copyValues(const Transform &other);
+
+    // The scene's pool, or nullptr if the values are stored in detached_
+    TransformPool* pool_;
+    std::unique_ptr<TransformColumns> detached_;
+    // Where the values are stored: the pool's columns or detached_
+    TransformColumns* columns_;
+    transform_slot_t slot_;
+
     luabridge::LuaRef ref_;
 };
 
@@ -0,0 +1,199 @@
+#include "scripting/components/TransformPool.hpp"
+
+#include "game/Actor.hpp"
+#include "scripting/components/InterpTransform.hpp"
+#include "scripting/components/Transform.hpp"
+#include "util/JobSystem.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace sge::scripting {
+
+namespace {
+
+thread_local TransformPool* ThreadTransformPool = nullptr;
+
+// Transforms interpolated per job. The loop is cheap, so only large scenes
+// are split across workers.
+constexpr std::size_t InterpolateGrain = 4096;
+
+/**
+ * @brief Remove an element from each of a set of parallel arrays by moving the
+ * last element into its place.
+ */
+template <typename... Arrays>
+void swapRemove(std::size_t index, Arrays &...arrays) {
+    ((arrays[index] = std::move(arrays.back()), arrays.pop_back()), ...);
+}
+
+template <typename... Arrays>
+void appendZero(Arrays &...arrays) {
+    (arrays.emplace_back(), ...);
+}
+
+} // namespace
+
+const TransformPool::InterpState &TransformPool::InterpTrack::front() const {
+    assert(this->count > 0);
+    return this->pending[this->head];
+}
+
+void TransformPool::InterpTrack::pop() {
+    assert(this->count > 0);
+    this->head = static_cast<std::uint8_t>((this->head + 1) % MaxPendingInterps);
+    --this->count;
+}
+
+void TransformPool::InterpTrack::push(const InterpState &state) {
+    if (this->count == MaxPendingInterps) {
+        // Too far behind, so skip ahead
+        this->pop();
+    }
+    this->pending[(this->head + this->count) % MaxPendingInterps] = state;
+    ++this->count;
+}
+
+transform_slot_t TransformPool::addTransform(Transform* owner) {
+    auto &columns = this->transforms;
+    appendZero(columns.x, columns.y, columns.rotation);
+    this->transformOwners_.push_back(owner);
+    return static_cast<transform_slot_t>(this->transformOwners_.size() - 1);
+}
+
+void TransformPool::removeTransform(transform_slot_t slot) {
+    auto &columns = this->transforms;
+    swapRemove(slot, columns.x, columns.y, columns.rotation, this->transformOwners_);
+    if (slot < this->transformOwners_.size()) {
+        this->transformOwners_[slot]->slot_ = slot;
+    }
+}
+
+transform_slot_t TransformPool::addInterpTransform(InterpTransform* owner) {
+    auto &columns = this->interpTransforms;
+    appendZero(columns.x, columns.y, columns.rotation, this->interpTracks_);
+    this->interpOwners_.push_back(owner);
+    return static_cast<transform_slot_t>(this->interpOwners_.size() - 1);
+}
+
+void TransformPool::removeInterpTransform(transform_slot_t slot) {
+    auto &columns = this->interpTransforms;
+    swapRemove(slot, columns.x, columns.y, columns.rotation, this->interpTracks_,
+               this->interpOwners_);
+    if (slot < this->interpOwners_.size()) {
+        this->interpOwners_[slot]->slot_ = slot;
+    }
+}
+
+void TransformPool::pushInterp(transform_slot_t slot, float x, float y, float rotation,
+                               std::chrono::steady_clock::time_point time) {
+    auto &track = this->interpTracks_[slot];
+    if (track.count == 0) {
+        // Start moving from wherever the transform is now
+        const auto &columns = this->interpTransforms;
+        track.start = InterpState{columns.x[slot], columns.y[slot], columns.rotation[slot], time};
+    }
+    track.push(InterpState{x, y, rotation, time});
+}
+
+void TransformPool::clearInterps(transform_slot_t slot) {
+    this->interpTracks_[slot] = InterpTrack{};
+}
+
+void TransformPool::interpolate(std::chrono::steady_clock::time_point now,
+                                std::chrono::microseconds tickDuration) {
+    using namespace std::chrono;
+
+    auto &columns = this->interpTransforms;
+    const auto count = this->interpOwners_.size();
+    this->fromX_.resize(count);
+    this->fromY_.resize(count);
+    this->toX_.resize(count);
+    this->toY_.resize(count);
+    this->frac_.resize(count);
+
+    auto fracOf = [now, tickDuration](const InterpState &state) {
+        auto delta = duration_cast<microseconds>(now - state.time);
+        return static_cast<float>(delta.count()) / static_cast<float>(tickDuration.count());
+    };
+
+    // Advance each track and pick the endpoints to interpolate between. A
+    // transform that shouldn't move interpolates from itself to itself.
+    for (std::size_t i = 0; i < count; ++i) {
+        auto* owner = this->interpOwners_[i];
+        auto &track = this->interpTracks_[i];
+        this->fromX_[i] = this->toX_[i] = columns.x[i];
+        this->fromY_[i] = this->toY_[i] = columns.y[i];
+        this->frac_[i] = 0.0F;
+
+        if (!owner->lifecycleShouldRun() || !owner->actor->runLifecycleFunctions() ||
+            !owner->lifecycleCanRunUnderActor()) {
+            continue;
+        }
+
+        if (track.count == 0) {
+            if (owner->actor->pendingServerDestroy()) {
+                // We have no more interpolated movement so we can go ahead and
+                // actually destroy this actor for good.
+                owner->actor->destroy();
+            }
+            continue;
+        }
+
+        float frac = fracOf(track.front());
+        while (frac >= 1.0F && track.count >= 2) {
+            track.start = track.front();
+            track.pop();
+            frac = fracOf(track.front());
+        }
+
+        const auto &next = track.front();
+        if (frac >= 1.0F) {
+            // Arrived at the last state
+            this->fromX_[i] = this->toX_[i] = next.x;
+            this->fromY_[i] = this->toY_[i] = next.y;
+            columns.rotation[i] = next.rotation;
+            track.pop();
+        } else {
+            this->fromX_[i] = track.start.x;
+            this->fromY_[i] = track.start.y;
+            this->toX_[i] = next.x;
+            this->toY_[i] = next.y;
+            this->frac_[i] = frac;
+            columns.rotation[i] = track.start.rotation; // Don't interp rotation
+        }
+    }
+
+    // Interpolate every transform at once
+    auto* x = columns.x.data();
+    auto* y = columns.y.data();
+    const auto* fromX = this->fromX_.data();
+    const auto* fromY = this->fromY_.data();
+    const auto* toX = this->toX_.data();
+    const auto* toY = this->toY_.data();
+    const auto* frac = this->frac_.data();
+    util::Jobs().parallelFor(count, InterpolateGrain, [=](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            x[i] = (toX[i] - fromX[i]) * frac[i] + fromX[i];
+            y[i] = (toY[i] - fromY[i]) * frac[i] + fromY[i];
+        }
+    });
+}
+
+TransformPool* CurrentTransformPool() {
+    return ThreadTransformPool;
+}
+
+TransformPoolScope::TransformPoolScope(TransformPool* pool)
+    : previous_(ThreadTransformPool) {
+    ThreadTransformPool = pool;
+}
+
+TransformPoolScope::~TransformPoolScope() {
+    ThreadTransformPool = this->previous_;
+}
+
+} // namespace sge::scripting
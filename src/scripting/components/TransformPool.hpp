@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sge::scripting {
+
+class Transform;
+class InterpTransform;
+
+using transform_slot_t = std::uint32_t;
+
+/**
+ * @brief Positions and rotations of a set of transforms, one array per field.
+ * Slots are kept dense, so a pass over every transform reads contiguous memory.
+ */
+struct TransformColumns {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> rotation;
+};
+
+/**
+ * @brief Struct-of-arrays storage for the Transform and InterpTransform
+ * components of a scene. Components keep only their slot and read and write
+ * their values here.
+ *
+ * Removing a component moves the last slot into its place, updating the slot
+ * of the component that owns it.
+ */
+class TransformPool {
+public:
+    // Replicated states an InterpTransform can lag behind by. When more
+    // arrive, the oldest is dropped.
+    static constexpr std::size_t MaxPendingInterps = 16;
+
+    TransformPool() = default;
+
+    TransformPool(const TransformPool &) = delete;
+    TransformPool &operator=(const TransformPool &) = delete;
+
+    transform_slot_t addTransform(Transform* owner);
+    void removeTransform(transform_slot_t slot);
+
+    transform_slot_t addInterpTransform(InterpTransform* owner);
+    void removeInterpTransform(transform_slot_t slot);
+
+    /**
+     * @brief Queue a replicated state for an InterpTransform to move towards.
+     */
+    void pushInterp(transform_slot_t slot, float x, float y, float rotation,
+                    std::chrono::steady_clock::time_point time);
+    void clearInterps(transform_slot_t slot);
+
+    /**
+     * @brief Move every running InterpTransform towards its replicated states,
+     * in one pass. Each state is reached one tick after it was received.
+     *
+     * @param now Time of the current frame.
+     * @param tickDuration Time between replicated states.
+     */
+    void interpolate(std::chrono::steady_clock::time_point now,
+                     std::chrono::microseconds tickDuration);
+
+    TransformColumns transforms;
+    TransformColumns interpTransforms;
+
+private:
+    struct InterpState {
+        float x;
+        float y;
+        float rotation;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    /**
+     * @brief Replicated states of an InterpTransform, and where it started
+     * moving towards the first one from.
+     */
+    struct InterpTrack {
+        InterpState start{};
+        std::array<InterpState, MaxPendingInterps> pending{};
+        std::uint8_t head{0};
+        std::uint8_t count{0};
+
+        const InterpState &front() const;
+        void pop();
+        void push(const InterpState &state);
+    };
+
+    std::vector<Transform*> transformOwners_;
+    std::vector<InterpTransform*> interpOwners_;
+    std::vector<InterpTrack> interpTracks_;
+
+    // Per-frame endpoints of each InterpTransform, so that the interpolation
+    // itself is a branch-free loop over plain arrays
+    std::vector<float> fromX_;
+    std::vector<float> fromY_;
+    std::vector<float> toX_;
+    std::vector<float> toY_;
+    std::vector<float> frac_;
+};
+
+/**
+ * @brief Get the pool that Transform and InterpTransform components are
+ * currently created in on the calling thread, or nullptr.
+ */
+TransformPool* CurrentTransformPool();
+
+/**
+ * @brief Makes Transform and InterpTransform components created on the calling
+ * thread use a pool for the lifetime of the scope, restoring the previous pool
+ * afterwards. Components created without a pool, i.e. template prototypes,
+ * store their values inline and are never interpolated.
+ */
+class TransformPoolScope {
+public:
+    explicit TransformPoolScope(TransformPool* pool);
+    ~TransformPoolScope();
+
+    TransformPoolScope(const TransformPoolScope &) = delete;
+    TransformPoolScope &operator=(const TransformPoolScope &) = delete;
+
+private:
+    TransformPool* previous_;
+};
+
+} // namespace sge::scripting
@@ -0,0 +1,119 @@
+#include "scripting/components/Velocity.hpp"
+
+#include "Realm.hpp"
+#include "game/Actor.hpp"
+#include "resources/Deserialize.hpp"
+#include "scripting/Component.hpp"
+#include "scripting/Scripting.hpp"
+#include "scripting/components/CppComponent.hpp"
+#include "scripting/components/Transform.hpp"
+#include "util/Symbol.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sge::scripting {
+
+namespace {
+
+const auto VelocityType = util::Intern("Velocity");
+const auto DefaultTransformComponent = util::Intern("transform");
+
+} // namespace
+
+Velocity::Velocity(Realm realm)
+    : CppComponent(VelocityType, realm)
+    , vel_x(0.0F)
+    , vel_y(0.0F)
+    , angular_velocity(0.0F)
+    , __opaquePointer{this}
+    , transformComponent_(DefaultTransformComponent)
+    , parallel_(false)
+    , ref_{GetGlobalState(), this} {}
+
+const luabridge::LuaRef &Velocity::ref() const {
+    return this->ref_;
+}
+
+std::unique_ptr<Component> Velocity::clone() const {
+    auto newVelocity = std::make_unique<Velocity>(this->realm);
+    newVelocity->copyValues(*this);
+    return newVelocity;
+}
+
+bool Velocity::reset(const Component &prototype) {
+    this->copyValues(static_cast<const Velocity &>(prototype));
+    this->parallel_ = false;
+    this->resetLifecycle();
+    return true;
+}
+
+void Velocity::copyValues(const Velocity &other) {
+    this->vel_x = other.vel_x;
+    this->vel_y = other.vel_y;
+    this->angular_velocity = other.angular_velocity;
+    this->transformComponent_ = other.transformComponent_;
+}
+
+void Velocity::setValues(const std::vector<std::pair<std::string, ComponentValueType>> &values) {
+    for (const auto &[name, val] : values) {
+        if (name == "vel_x") {
+            this->vel_x = MustGet<float>(val);
+        } else if (name == "vel_y") {
+            this->vel_y = MustGet<float>(val);
+        } else if (name == "angular_velocity") {
+            this->angular_velocity = MustGet<float>(val);
+        } else if (name == "transform_component") {
+            this->transformComponent_ = util::Intern(MustGet<std::string>(val));
+        }
+    }
+}
+
+LifecycleMask Velocity::lifecycleHandlers() const {
+    return LifecycleBit(Lifecycle::OnUpdate);
+}
+
+bool Velocity::parallelUpdate() const {
+    return this->parallel_;
+}
+
+util::Symbol Velocity::getTransformComponent() const {
+    return this->transformComponent_;
+}
+
+void Velocity::onStart() {
+    // Claim the transform for the parallel phase unless another Velocity
+    // already has. Decided here since the scene registers the OnUpdate handler
+    // right after OnStart.
+    this->parallel_ = true;
+    for (auto* component : this->actor->getComponents(VelocityType.str())) {
+        const auto* other = static_cast<const Velocity*>(component);
+        if (other != this && other->parallel_ &&
+            other->transformComponent_ == this->transformComponent_) {
+            this->parallel_ = false;
+            break;
+        }
+    }
+}
+
+Transform* Velocity::findTransform() const {
+    // Looked up on every update rather than kept, so that a transform removed
+    // from the actor is never written to. Only reads the actor's components,
+    // which don't change during the parallel phase.
+    return dynamic_cast<Transform*>(
+        this->actor->components.getComponentByKey(this->transformComponent_));
+}
+
+void Velocity::onUpdate(float dt) {
+    auto* transform = this->findTransform();
+    if (transform == nullptr) {
+        return;
+    }
+    transform->setX(transform->getX() + this->vel_x * dt);
+    transform->setY(transform->getY() + this->vel_y * dt);
+    transform->setRotation(transform->getRotation() + this->angular_velocity * dt);
+}
+
+} // namespace sge::scripting
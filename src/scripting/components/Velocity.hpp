@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Realm.hpp"
+#include "resources/Deserialize.hpp"
+#include "scripting/Component.hpp"
+#include "scripting/components/CppComponent.hpp"
+#include "util/Symbol.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sge::scripting {
+
+class Transform;
+
+/**
+ * @brief Moves a Transform of its actor at a constant velocity, like the
+ * ConstantVelocity Lua component, without calling into Lua.
+ *
+ * Its OnUpdate runs on the job system when it is the only parallel Velocity of
+ * the actor that moves the transform, since nothing else writes to the
+ * transform during the parallel phase. Any others moving the same transform
+ * run with the serial OnUpdate.
+ */
+class Velocity : public CppComponent {
+public:
+    Velocity(Realm realm);
+    ~Velocity() override = default;
+
+    const luabridge::LuaRef &ref() const override;
+
+    std::unique_ptr<Component> clone() const override;
+    void setValues(const std::vector<std::pair<std::string, ComponentValueType>> &values) override;
+    bool reset(const Component &prototype) override;
+
+    LifecycleMask lifecycleHandlers() const override;
+    bool parallelUpdate() const override;
+
+    void onStart() override;
+    void onUpdate(float dt) override;
+
+    util::Symbol getTransformComponent() const;
+
+    float vel_x;
+    float vel_y;
+    float angular_velocity;
+
+    OpaqueComponentPointer __opaquePointer;
+
+private:
+    void copyValues(const Velocity &other);
+    Transform* findTransform() const;
+
+    // Key of the Transform to move. Fixed once started, since it decides
+    // whether the component runs in parallel.
+    util::Symbol transformComponent_;
+    bool parallel_;
+
+    luabridge::LuaRef ref_;
+};
+
+} // namespace sge::scripting
@@ -0,0 +1,730 @@
+#include "server/Room.hpp"
+
+#include "Common.hpp"
+#include "Constants.hpp"
+#include "Types.hpp"
+#include "game/Actor.hpp"
+#include "game/Game.hpp"
+#include "game/Scene.hpp"
+#include "net/Host.hpp"
+#include "net/Messages.hpp"
+#include "net/Replicator.hpp"
+#include "resources/Configs.hpp"
+#include "scripting/Environment.hpp"
+#include "scripting/Profiler.hpp"
+#include "util/Trace.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace sge {
+
+namespace server {
+
+namespace {
+
+thread_local Room* CurrentThreadRoom = nullptr;
+
+// Where profiles of slow ticks are written
+const auto SlowTickProfilesPath = std::filesystem::path{"profiles"};
+// Least time between two profiles of slow ticks of a room, so that a room that
+// is slow every tick doesn't write a profile every tick
+constexpr auto MinSlowTickProfileInterval = std::chrono::seconds{10};
+
+/**
+ * @brief Makes a room and its scripting environment current on the calling
+ * thread for the lifetime of the scope.
+ */
+class RoomScope {
+public:
+    RoomScope(Room* room, scripting::Environment &environment)
+        : previous_(CurrentThreadRoom)
+        , environmentScope_(environment) {
+        CurrentThreadRoom = room;
+    }
+
+    ~RoomScope() {
+        CurrentThreadRoom = this->previous_;
+    }
+
+    RoomScope(const RoomScope &) = delete;
+    RoomScope &operator=(const RoomScope &) = delete;
+
+private:
+    Room* previous_;
+    scripting::EnvironmentScope environmentScope_;
+};
+
+} // namespace
+
+Room::Room(std::string name, const resources::ServerConfig &serverConfig,
+           const resources::GameConfig &gameConfig, net::Host::pointer host)
+    : name_(std::move(name))
+    , serverConfig_(serverConfig)
+    , gameConfig_(gameConfig)
+    , host_(std::move(host))
+    , environment_(std::make_unique<scripting::Environment>())
+    , gc_(this->environment_->state(), serverConfig.lua_gc_mode,
+          std::size_t{serverConfig.lua_gc_emergency_mb} * 1024 * 1024) {
+    RoomScope scope{this, *this->environment_};
+    if (serverConfig.lua_profile_slow_tick_ms > 0) {
+        this->environment_->profiler().setTickCapture(true);
+    }
+    // Initialize game and load initial scene
+    this->initGame();
+}
+
+Room::~Room() {
+    // Tear down the game while the room is current so that any destruction
+    // logic runs against this room's state.
+    RoomScope scope{this, *this->environment_};
+    this->replicatorService_.clear();
+    this->game_.reset();
+}
+
+void Room::tick() {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::steady_clock;
+
+    RoomScope scope{this, *this->environment_};
+    TRACE_ZONE_DETAIL("Room.Tick", this->name_);
+
+    auto tickStart = steady_clock::now();
+    this->tickInScope();
+    auto tickTime = duration_cast<microseconds>(steady_clock::now() - tickStart);
+    this->updateStats(tickTime);
+    this->profileSlowTick(tickTime);
+}
+
+void Room::collectGarbage(std::chrono::steady_clock::time_point until) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    // Finalizers may call back into scripts
+    RoomScope scope{this, *this->environment_};
+    auto gcTime = duration_cast<microseconds>(this->gc_.collect(until));
+    auto us = static_cast<std::uint64_t>(gcTime.count());
+    this->stats_.totalGcTimeUs += us;
+    if (us > this->stats_.maxGcTimeUs) {
+        this->stats_.maxGcTimeUs = us;
+    }
+    this->stats_.gcEmergencies = this->gc_.stats().emergencies;
+    this->stats_.luaMemoryBytes = this->gc_.heapBytes();
+}
+
+void Room::profileSlowTick(std::chrono::microseconds tickTime) {
+    auto &profiler = this->environment_->profiler();
+    const std::chrono::milliseconds threshold{this->serverConfig_.lua_profile_slow_tick_ms};
+    auto now = std::chrono::steady_clock::now();
+    if (threshold.count() > 0 && tickTime >= threshold && !profiler.tick().empty() &&
+        (!this->lastSlowTickProfile_.has_value() ||
+         now - *this->lastSlowTickProfile_ >= MinSlowTickProfileInterval)) {
+        this->lastSlowTickProfile_ = now;
+
+        std::error_code ec;
+        std::filesystem::create_directories(SlowTickProfilesPath, ec);
+        auto path = SlowTickProfilesPath / (this->name_ + "-" + std::to_string(this->tickNum_));
+        auto folded = path;
+        folded += ".folded";
+        auto summary = path;
+        summary += ".txt";
+        if (profiler.tick().writeFolded(folded) && profiler.tick().writeSummary(summary)) {
+            std::cerr << "warning: room \"" << this->name_ << "\" took "
+                      << static_cast<double>(tickTime.count()) / 1000.0
+                      << " ms to tick, wrote Lua profile to " << folded.string() << std::endl;
+        }
+    }
+    profiler.endTick();
+}
+
+void Room::post(net::ClientEvent event) {
+    std::lock_guard guard(this->inboxMu_);
+    this->pendingEvents_.push_back(event);
+}
+
+void Room::post(std::unique_ptr<net::ClientMessage> msg) {
+    std::lock_guard guard(this->inboxMu_);
+    this->pendingMessages_.push_back(std::move(msg));
+}
+
+const std::string &Room::name() const {
+    return this->name_;
+}
+
+const RoomStats &Room::stats() const {
+    return this->stats_;
+}
+
+void Room::close() {
+    this->closed_ = true;
+}
+
+bool Room::closed() const {
+    return this->closed_;
+}
+
+game::Game &Room::game() {
+    assert(this->game_ != nullptr);
+    return *this->game_;
+}
+
+net::ReplicatorService &Room::replicatorService() {
+    return this->replicatorService_;
+}
+
+unsigned int Room::tickNum() const {
+    return this->tickNum_;
+}
+
+std::vector<client_id_t> Room::joinedClients() const {
+    // Find all joined clients
+    std::vector<client_id_t> joinedClients;
+    for (const auto &state : this->clientStates_) {
+        if (state.second == ClientState::Joined) {
+            joinedClients.push_back(state.first);
+        }
+    }
+    return joinedClients;
+}
+
+void Room::tickInScope() {
+    // 1. Process network events and messages routed to this room. This includes
+    // client join/leave events and all other general messages like MessageHello.
+    this->processNetwork();
+
+    // If there are no clients connected, conditionally proceed based on server
+    // configuration's empty_behavior value.
+    if (this->clientStates_.empty() &&
+        this->serverConfig_.empty_behavior != resources::ServerEmptyBehavior::Run) {
+        // Behavior is either pause or reset, either way don't update.
+        return;
+    }
+
+    // 2. Run the game update loop. Executes OnStart, OnUpdate, etc.
+    this->updateGame();
+
+    // 3. Gather any replication requests that were created during the previous
+    // update loop and broadcast them to all joined clients.
+    this->executeReplications();
+
+    // 4. Execute any deferred actions.
+    this->executeAfterUpdates();
+
+    // 5. Increment the tick counter. Note that if the game is paused due to no
+    // connected clients, the tick counter will not increase.
+    ++this->tickNum_;
+}
+
+void Room::initGame() {
+    // Create game instance
+    this->game_ = std::make_unique<game::Game>(this->gameConfig_);
+    this->game_->loadScene(this->serverConfig_.initial_scene);
+}
+
+void Room::updateGame() {
+    // Check for going to another scene
+    if (!this->nextScene_.empty()) {
+        this->swapScene(this->nextScene_);
+        this->nextScene_.clear();
+    }
+
+    // Check for sending out room state updates
+    if (this->roomStateChanged_) {
+        this->broadcastRoomState();
+        this->roomStateChanged_ = false;
+    }
+
+    // Run the game update logic
+    this->game_->update();
+}
+
+void Room::swapScene(const std::string &name) {
+    // Increment the generation counter ahead of the scene loading
+    ++this->generation_;
+
+    // Clear any pending replications
+    this->replicatorService_.clear();
+    // The new scene is sent without state, so nothing is a baseline anymore
+    for (auto &[clientID, baselines] : this->baselines_) {
+        baselines.clear();
+    }
+    this->pendingKeyframes_.clear();
+
+    // Switch the scene
+    this->game_->loadScene(name);
+
+    // Inform all clients in the room about the new scene
+    this->broadcastToJoined(net::MessageLoadScene{
+        .generation = this->generation_,
+        .sceneName = name,
+        .runtimeActors = {}, // No updates yet = no runtime actors
+        .sceneState = {},    // Fresh scene, no additional state to replicate
+    });
+}
+
+void Room::updateStats(std::chrono::microseconds tickTime) {
+    auto us = static_cast<std::uint64_t>(tickTime.count());
+    ++this->stats_.ticks;
+    this->stats_.totalTickTimeUs += us;
+    if (us > this->stats_.maxTickTimeUs) {
+        this->stats_.maxTickTimeUs = us;
+    }
+    this->stats_.luaMemoryBytes = this->environment_->luaMemoryUsage();
+    const auto &scene = this->game_->currentScene();
+    this->stats_.actors = scene.actors().size();
+    this->stats_.poolHits = scene.templatePool().stats().hits;
+    this->stats_.poolMisses = scene.templatePool().stats().misses;
+    this->stats_.clients = this->clientStates_.size();
+}
+
+void Room::setNextScene(std::string_view name) {
+    this->nextScene_ = name;
+}
+
+void Room::clientJoined(client_id_t clientID) {
+    // Update client state map
+    assert(this->clientStates_.contains(clientID));
+    this->clientStates_[clientID] = ClientState::Joined;
+
+    // Mark room as needing to send out a room state update this tick
+    this->roomStateChanged_ = true;
+
+    this->doAfterUpdate([this, clientID] {
+        // Process any subscriptions to client join events
+        this->game_->eventSub().publish(events::MultiplayerOnClientJoin, clientID);
+    });
+}
+
+void Room::clientLeft(client_id_t clientID) {
+    // Erase client from state map
+    this->clientStates_.erase(clientID);
+    this->baselines_.erase(clientID);
+    this->pendingKeyframes_.erase(clientID);
+
+    // Destroy any actors owned by the client that left
+    for (auto &actor : this->game_->currentScene().actors()) {
+        if (actor->ownerClient == clientID) {
+            actor->destroy();
+        }
+    }
+
+    if (this->clientStates_.empty() &&
+        this->serverConfig_.empty_behavior == resources::ServerEmptyBehavior::Reset) {
+        // There are no connected clients, we are supposed to reset the game now.
+        this->initGame();
+        // Because there are no connected clients, we also don't need to send out
+        // room state updates (there are no clients connected to receive them!).
+        // We also just initialized a new game so it doesn't make sense to publish
+        // any events::MultiplayerOnClientLeave events, so just return.
+        return;
+    }
+
+    // Mark room as needing to send out a room state update this tick
+    this->roomStateChanged_ = true;
+
+    this->doAfterUpdate([this, clientID] {
+        // Process any subscriptions to client leave events
+        this->game_->eventSub().publish(events::MultiplayerOnClientLeave, clientID);
+    });
+}
+
+void Room::processNetwork() {
+    TRACE_ZONE("Room.ProcessNetwork");
+    std::vector<net::ClientEvent> events;
+    std::vector<std::unique_ptr<net::ClientMessage>> messages;
+    {
+        std::lock_guard guard(this->inboxMu_);
+        events.swap(this->pendingEvents_);
+        messages.swap(this->pendingMessages_);
+    }
+
+    // 1. Process "ClientEvent" events. These are socket/connection level events
+    // like connect/disconnect.
+    for (const auto &event : events) {
+        switch (event.event) {
+        case net::ClientEventType::Connected:
+            this->clientStates_.emplace(event.clientID, ClientState::Initializing);
+            break;
+        case net::ClientEventType::Disconnected:
+            this->clientLeft(event.clientID);
+            break;
+        }
+    }
+
+    // 2. Process messages from clients. Execute all required handling logic and
+    // send all required messages/broadcasts as a result of executing the handlers.
+    for (auto &msg : messages) {
+        this->processMessage(std::move(msg));
+    }
+}
+
+void Room::executeReplications() {
+    TRACE_ZONE("Room.ExecuteReplications");
+    this->executeTickReplication();
+    this->executeRemoteEvents();
+}
+
+void Room::executeTickReplication() {
+    if (!this->replicatorService_.hasPendingReplications()) {
+        // No replication data to send
+        return;
+    }
+
+    // Server-side actor instantiations or state replications have occurred.
+    // Serialize them and broadcast them to all joined clients.
+    auto instantiations = this->replicatorService_.serializeInstantiations();
+    auto replicationRequests = this->replicatorService_.serializeComponents();
+    auto destructions = this->replicatorService_.serializeDestructions();
+    assert(!instantiations.empty() || !replicationRequests.empty() || !destructions.empty());
+
+    this->broadcastTickReplication(net::MessageTickReplication{
+        .generation = this->generation_,
+        .instantiations =
+            std::make_shared<std::vector<net::InstantiatedActor>>(std::move(instantiations)),
+        .replications = std::move(replicationRequests),
+        .destructions = std::make_shared<std::vector<actor_id_t>>(std::move(destructions)),
+    });
+}
+
+void Room::executeRemoteEvents() {
+    if (!this->replicatorService_.hasPendingEventPublishes()) {
+        // No remote events to send
+        return;
+    }
+
+    auto publishes = this->replicatorService_.serializeEventPublishes();
+    assert(!publishes.empty());
+
+    this->broadcastToJoined(net::MessageRemoteEvents{
+        .generation = this->generation_,
+        .publishes = std::move(publishes),
+    });
+}
+
+//-----------------------------------------------------------------------------
+// Client message processing
+
+void Room::processMessage(std::unique_ptr<net::ClientMessage> msg) {
+    if (!this->clientStates_.contains(msg->clientID)) {
+        std::cerr << "warning: dropping message from client " << msg->clientID
+                  << " because it appears to no longer be connected" << std::endl;
+        return;
+    };
+    std::visit(
+        [this, cid = msg->clientID](auto &m) {
+            this->processMessage(cid, m);
+        },
+        *msg->msg);
+}
+
+void Room::processMessage(client_id_t clientID, const net::MessageError &m) {
+    std::cerr << "[ MSG_ERROR ] Client " << clientID << ": " << m.error << std::endl;
+    this->host_->disconnectClient(clientID);
+}
+
+void Room::processMessage(client_id_t clientID, const net::MessageHello &m) {
+    // Mark client ID as joined to game
+    this->clientJoined(clientID);
+
+    // Replicate any actors created at runtime
+    auto runtimeActors = net::ReplicatorService::replicateRuntimeActors(*this->game_);
+    // Replicate entire game state in form of ReplicationRequests
+    auto sceneState = this->replicatorService_.replicateGame(*this->game_);
+    // Later replications to the client are deltas against the scene state
+    auto &baselines = this->baselines_[clientID];
+    baselines.clear();
+    baselines.record(sceneState);
+
+    // Send MessageWelcome with assigned client ID and tick rate
+    this->host_->postMessage(clientID,
+                             net::MessageWelcome{
+                                 .clientID = clientID,
+                                 .serverTickRate = this->serverConfig_.tick_rate,
+                             });
+
+    // Send current scene state
+    this->host_->postMessage(clientID,
+                             net::MessageLoadScene{
+                                 .generation = this->generation_,
+                                 .sceneName = this->game_->currentScene().name(),
+                                 .runtimeActors = std::move(runtimeActors),
+                                 .sceneState = std::move(sceneState),
+                             });
+}
+
+void Room::processMessage(client_id_t clientID, const net::MessageLoadSceneRequest &m) {
+    // A client wants to swap to another scene. Check to make sure the
+    // generation number matches before confirming the switch.
+    if (m.generation != this->generation_) {
+        // Silently drop the request
+        return;
+    }
+    // Set the next scene to load at the beginning of the game update
+    // phase. This means that if another client comes along and also
+    // requests to load a different scene, the later client will win.
+    this->setNextScene(m.sceneName);
+}
+
+void Room::processMessage(client_id_t clientID, net::MessageTickReplication &m) {
+    // A client has updated the game state and has requested to replicate
+    // the state to the server and other clients.
+    // 1. Instantiate any new actors.
+    // 2. Process any replication requests.
+    // 3. Acknowledge the tick replication to the sender client.
+    // 4. Broadcast the replication to all other clients.
+    auto &scene = this->game_->currentScene();
+
+    if (m.generation != this->generation_) {
+        // Mismatched generation. The server has loaded a new scene but
+        // the client has not yet processed the new load. Reject any actor
+        // instantiations and let the client know so they can appropriately
+        // keep the game in sync.
+        auto instantiations = net::SharedElements(m.instantiations);
+        if (!instantiations.empty()) {
+            std::vector<actor_id_t> rejectedInstantiations;
+            rejectedInstantiations.reserve(instantiations.size());
+            for (const auto &instantiation : instantiations) {
+                rejectedInstantiations.push_back(instantiation.id);
+            }
+            this->host_->postMessage(
+                clientID,
+                net::MessageTickReplicationReject{
+                    .serverGeneration = this->generation_,
+                    .rejectedInstantiations = std::move(rejectedInstantiations),
+                });
+        }
+        // Drop the replication message -- the state to replicate no
+        // longer exists as we are in a different scene.
+        return;
+    }
+
+    // Clients shouldn't send tick replications for no reason, but avoid
+    // doing work that we don't need to do
+    auto instantiations = net::SharedElements(m.instantiations);
+    auto destructions = net::SharedElements(m.destructions);
+    if (instantiations.empty() && m.replications.empty() && destructions.empty()) {
+        return;
+    }
+
+    // Process all actor instantiations
+    std::vector<net::RemoteIDMapping> remoteIDMappings;
+    std::vector<net::InstantiatedActor> rewrittenInstantiations;
+    remoteIDMappings.reserve(instantiations.size());
+    rewrittenInstantiations.reserve(instantiations.size());
+    for (auto &instantiation : instantiations) {
+        // Instantiate the runtime actor
+        auto* a = scene.instantiateRuntimeActor(instantiation.actorTemplate, instantiation.owner);
+        // Map client-side id to server-side id
+        remoteIDMappings.emplace_back(instantiation.id, a->id);
+        // Reconstruct the instantiation with server-side actor id so
+        // we can broadcast to other clients.
+        rewrittenInstantiations.emplace_back(instantiation.actorTemplate,
+                                             a->id,
+                                             a->ownerClient,
+                                             std::move(instantiation.componentState));
+    }
+
+    // Process all replication requests, updating the game state.
+    // Note that the client should only be replicating components from
+    // actors who are intrinsic to the scene or have been ack'd.
+    for (const auto &req : m.replications) {
+        this->processReplicationRequest(req);
+    }
+
+    // Process all actor destructions
+    for (auto id : destructions) {
+        // Find the actor we want to destroy
+        auto* a = scene.findActorByID(id);
+        if (a == nullptr) {
+            continue;
+        }
+        // Found it, so destroy it. Don't replicate it to clients later
+        // because we are going to do so below.
+        a->destroyLocally();
+    }
+
+    // Acknowledge tick replication if required
+    if (!remoteIDMappings.empty()) {
+        this->host_->postMessage(clientID,
+                                 net::MessageTickReplicationAck{
+                                     .remoteIDMappings = std::move(remoteIDMappings),
+                                 });
+    }
+
+    // Broadcast replication message to all other connected clients
+    this->broadcastTickReplication(
+        net::MessageTickReplication{
+            .generation = this->generation_,
+            .instantiations = std::make_shared<std::vector<net::InstantiatedActor>>(
+                std::move(rewrittenInstantiations)),
+            .replications = std::move(m.replications),
+            .destructions = std::move(m.destructions),
+        },
+        clientID);
+}
+
+void Room::processMessage(client_id_t clientID, net::MessageRemoteEvents &m) {
+    // The client has some remote events for us.
+    // 1. Verify the generation number
+    // 2. Forward the remote events to all other clients
+    // 3. Dispatch the published events to the room's EventSub instance
+
+    if (m.generation != this->generation_) {
+        // Silently drop the request
+        return;
+    }
+
+    // Clients shouldn't send empty publishes but check so we don't end up
+    // doing any unneeded work.
+    if (m.publishes.empty()) {
+        return;
+    }
+
+    // Forward this publish to other clients
+    this->broadcastToOthers(m, clientID);
+
+    this->doAfterUpdate([this, publishes = std::move(m.publishes)] {
+        // Dispatch to game EventSub
+        for (const auto &p : publishes) {
+            net::ReplicatorService::dispatchEventPublish(*this->game_, p);
+        }
+    });
+}
+
+//-----------------------------------------------------------------------------
+
+void Room::processReplicationRequest(const net::ComponentReplication &replication) {
+    // No interp on server
+    net::ReplicatorService::dispatchReplication(*this->game_, replication, false);
+}
+
+void Room::sendInvalidMessage(client_id_t clientID) {
+    this->host_->postMessage(clientID,
+                             net::MessageError{
+                                 .error = "invalid message received",
+                             });
+    this->host_->disconnectClient(clientID);
+}
+
+void Room::broadcastToJoined(const net::SMessage &msg) {
+    if (this->clientStates_.empty()) {
+        // No clients to broadcast to
+        return;
+    }
+    this->host_->broadcastMessage(msg, [&](client_id_t cid) {
+        return this->isJoined(cid);
+    });
+}
+
+void Room::broadcastToOthers(const net::SMessage &msg, client_id_t src) {
+    assert(this->isJoined(src));
+    if (this->clientStates_.size() <= 1) {
+        // No other clients to broadcast to
+        return;
+    }
+    this->host_->broadcastMessage(msg, [&](client_id_t cid) {
+        return cid != src && this->isJoined(cid);
+    });
+}
+
+void Room::broadcastTickReplication(const net::MessageTickReplication &msg,
+                                    std::optional<client_id_t> src) {
+    TRACE_ZONE("Room.BroadcastTickReplication");
+    for (const auto &[clientID, state] : this->clientStates_) {
+        if (state != ClientState::Joined || clientID == src) {
+            continue;
+        }
+
+        auto &baselines = this->baselines_[clientID];
+        net::MessageTickReplication clientMsg{
+            .generation = msg.generation,
+            .keyframe = this->pendingKeyframes_.erase(clientID) != 0,
+            .instantiations = msg.instantiations,
+            .replications = {},
+            .destructions = msg.destructions,
+        };
+        clientMsg.replications.reserve(msg.replications.size());
+        for (const auto &replication : msg.replications) {
+            this->stats_.replicatedStateBytes += replication.packed.size();
+            auto &encoded = clientMsg.replications.emplace_back(baselines.encode(replication));
+            this->stats_.replicatedSentBytes += encoded.packed.size();
+        }
+        // Destructions are applied after replications, on the client too
+        for (auto id : net::SharedElements(msg.destructions)) {
+            baselines.erase(id);
+        }
+        this->host_->postMessage(clientID, std::move(clientMsg));
+    }
+}
+
+void Room::processMessage(client_id_t clientID, const net::MessageResyncRequest &m) {
+    // The client couldn't apply a delta. Drop its baselines so that the next
+    // replications are sent in full, and have it drop its own.
+    if (m.generation != this->generation_) {
+        // Loading the scene already dropped them
+        return;
+    }
+    this->baselines_[clientID].clear();
+    this->pendingKeyframes_.insert(clientID);
+}
+
+void Room::broadcastRoomState() {
+    // Broadcast the joined clients to all clients
+    this->broadcastToJoined(net::MessageRoomState{
+        .joinedClients = this->joinedClients(),
+    });
+}
+
+bool Room::isJoined(client_id_t clientID) const {
+    auto it = this->clientStates_.find(clientID);
+    if (it == this->clientStates_.end()) {
+        return false;
+    }
+    return it->second == ClientState::Joined;
+}
+
+void Room::doAfterUpdate(std::function<void()> f) {
+    this->afterUpdate_.emplace_back(std::move(f));
+}
+
+void Room::executeAfterUpdates() {
+    for (const auto &after : this->afterUpdate_) {
+        std::invoke(after);
+    }
+    this->afterUpdate_.clear();
+}
+
+Room &CurrentRoom() {
+    assert(CurrentThreadRoom != nullptr);
+    return *CurrentThreadRoom;
+}
+
+} // namespace server
+
+game::Game &CurrentGame() {
+    return server::CurrentRoom().game();
+}
+
+game::Scene &CurrentScene() {
+    return CurrentGame().currentScene();
+}
+
+bool GameOffline() {
+    return false;
+}
+
+} // namespace sge
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "Common.hpp" // IWYU pragma: keep
+#include "Types.hpp"
+#include "game/Game.hpp"
+#include "net/DeltaReplication.hpp"
+#include "net/Host.hpp"
+#include "net/Messages.hpp"
+#include "net/Replicator.hpp"
+#include "resources/Configs.hpp"
+#include "scripting/Environment.hpp"
+#include "scripting/GcController.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace sge::server {
+
+enum class ClientState {
+    Initializing,
+    Joined,
+};
+
+/**
+ * @brief Counters describing the load of a room. Written by the thread ticking
+ * the room and safe to read from any thread.
+ */
+struct RoomStats {
+    std::atomic<std::uint64_t> ticks{0};
+    std::atomic<std::uint64_t> totalTickTimeUs{0};
+    std::atomic<std::uint64_t> maxTickTimeUs{0};
+    // Lua heap size after the last tick or collection
+    std::atomic<std::size_t> luaMemoryBytes{0};
+    // Time spent collecting Lua garbage between ticks
+    std::atomic<std::uint64_t> totalGcTimeUs{0};
+    std::atomic<std::uint64_t> maxGcTimeUs{0};
+    std::atomic<std::uint64_t> gcEmergencies{0};
+    std::atomic<std::size_t> actors{0};
+    std::atomic<std::size_t> clients{0};
+    // Instantiations of pooled templates that reused or cloned components
+    std::atomic<std::uint64_t> poolHits{0};
+    std::atomic<std::uint64_t> poolMisses{0};
+    // Component state replicated to clients, in full and as actually sent
+    // after delta encoding
+    std::atomic<std::uint64_t> replicatedStateBytes{0};
+    std::atomic<std::uint64_t> replicatedSentBytes{0};
+};
+
+/**
+ * @brief A single independent game hosted by the server. Each room owns its
+ * own Game (and with it a Scene and physics World), ReplicatorService, and
+ * scripting environment, and only ever talks to the clients that joined it.
+ *
+ * A room is ticked by one thread at a time. Network traffic for the room is
+ * handed over by the server through post(), which is safe to call from any
+ * thread. A room that never has clients (e.g. in sge-bench) may be created
+ * without a network host.
+ */
+class Room {
+public:
+    Room(std::string name, const resources::ServerConfig &serverConfig,
+         const resources::GameConfig &gameConfig, net::Host::pointer host);
+    ~Room();
+
+    Room(const Room &) = delete;
+    Room &operator=(const Room &) = delete;
+
+    /**
+     * @brief Run one server tick of the room with the room made current on the
+     * calling thread.
+     */
+    void tick();
+
+    /**
+     * @brief Collect Lua garbage in the idle time after a tick, until a
+     * deadline or until there is nothing worth collecting.
+     */
+    void collectGarbage(std::chrono::steady_clock::time_point until);
+
+    /**
+     * @brief Queue a client connection event to be processed at the start of
+     * the next tick.
+     */
+    void post(net::ClientEvent event);
+
+    /**
+     * @brief Queue a client message to be processed at the start of the next
+     * tick.
+     */
+    void post(std::unique_ptr<net::ClientMessage> msg);
+
+    const std::string &name() const;
+    const RoomStats &stats() const;
+
+    /**
+     * @brief Mark the room as closed. The thread ticking the room drops it
+     * instead of ticking it again.
+     */
+    void close();
+    bool closed() const;
+
+    game::Game &game();
+    net::ReplicatorService &replicatorService();
+
+    unsigned int tickNum() const;
+    std::vector<client_id_t> joinedClients() const;
+
+    void setNextScene(std::string_view name);
+
+private:
+    void tickInScope();
+    void initGame();
+    void updateGame();
+    void swapScene(const std::string &name);
+    void updateStats(std::chrono::microseconds tickTime);
+    // Write the Lua profile of the tick if it was slow, and start the next one
+    void profileSlowTick(std::chrono::microseconds tickTime);
+
+    void clientJoined(client_id_t clientID);
+    void clientLeft(client_id_t clientID);
+
+    void processNetwork();
+    void processMessage(std::unique_ptr<net::ClientMessage> msg);
+    void processMessage(client_id_t clientID, const net::MessageError &m);
+    void processMessage(client_id_t clientID, const net::MessageHello &m);
+    void processMessage(client_id_t clientID, const net::MessageLoadSceneRequest &m);
+    void processMessage(client_id_t clientID, net::MessageTickReplication &m);
+    void processMessage(client_id_t clientID, net::MessageRemoteEvents &m);
+    void processMessage(client_id_t clientID, const net::MessageResyncRequest &m);
+
+    void executeReplications();
+    void executeTickReplication();
+    void executeRemoteEvents();
+    void processReplicationRequest(const net::ComponentReplication &replication);
+
+    void sendInvalidMessage(client_id_t clientID);
+    void broadcastToJoined(const net::SMessage &msg);
+    void broadcastToOthers(const net::SMessage &msg, client_id_t src);
+    void broadcastRoomState();
+    // Send a tick replication to every joined client but src, with component
+    // states delta encoded against each client's baselines. The rest of the
+    // message is shared by every client's copy.
+    void broadcastTickReplication(const net::MessageTickReplication &msg,
+                                  std::optional<client_id_t> src = std::nullopt);
+
+    bool isJoined(client_id_t clientID) const;
+
+    void doAfterUpdate(std::function<void()> f);
+    void executeAfterUpdates();
+
+    std::string name_;
+    const resources::ServerConfig &serverConfig_;
+    const resources::GameConfig &gameConfig_;
+
+    net::Host::pointer host_;
+
+    // Important: environment_ must be before game_ so that the game is torn
+    // down before the Lua state it references is closed.
+    std::unique_ptr<scripting::Environment> environment_;
+    scripting::GcController gc_;
+
+    net::ReplicatorService replicatorService_;
+    std::unordered_map<client_id_t, ClientState> clientStates_;
+    // Last component states sent to each joined client
+    std::unordered_map<client_id_t, net::ReplicationBaselines> baselines_;
+    // Clients whose baselines were dropped for a resync, whose next tick
+    // replication is a keyframe
+    std::unordered_set<client_id_t> pendingKeyframes_;
+
+    std::unique_ptr<game::Game> game_{nullptr};
+
+    unsigned int tickNum_{0};
+    unsigned int generation_{0};
+
+    std::string nextScene_{};
+    bool roomStateChanged_{false};
+
+    std::vector<std::function<void()>> afterUpdate_;
+
+    // Network traffic handed over by the server, consumed at the start of a tick
+    std::mutex inboxMu_;
+    std::vector<net::ClientEvent> pendingEvents_;
+    std::vector<std::unique_ptr<net::ClientMessage>> pendingMessages_;
+
+    std::atomic<bool> closed_{false};
+    RoomStats stats_;
+    std::optional<std::chrono::steady_clock::time_point> lastSlowTickProfile_;
+};
+
+/**
+ * @brief Get the room being ticked on the calling thread.
+ */
+Room &CurrentRoom();
+
+} // namespace sge::server
@@ -2,64 +2,62 @@
 
 #include <boost/asio/io_context.hpp>
 
-#include "Common.hpp"
-#include "Constants.hpp"
 #include "Types.hpp"
-#include "game/Actor.hpp"
-#include "game/Game.hpp"
-#include "game/Scene.hpp"
 #include "net/Host.hpp"
 #include "net/Messages.hpp"
-#include "net/Replicator.hpp"
 #include "resources/Configs.hpp"
 #include "scripting/Libs.hpp"
-#include "scripting/Scripting.hpp"
+#include "server/Room.hpp"
 #include "server/ServerInterface.hpp"
+#include "util/TickScheduler.hpp"
+#include "util/Trace.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
-#include <functional>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
-#include <string_view>
 #include <thread>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#ifdef __linux__
+#    include <unistd.h>
+#endif
+
 #ifdef TRACK_FPS
 #    include "util/FPS.hpp"
 #endif
 
-namespace sge {
-
-namespace server {
-
-using std::chrono::high_resolution_clock;
-using std::chrono::time_point;
+namespace sge::server {
 
 namespace {
 
-void sleepToTargetTickRate(const time_point<high_resolution_clock> &tickStart,
-                           std::chrono::microseconds targetTickTime) {
-    using std::chrono::duration_cast;
-    using std::chrono::microseconds;
-    using std::chrono::milliseconds;
-
-    time_point<high_resolution_clock> now;
-    microseconds delta;
-
-    now = high_resolution_clock::now();
-    delta = duration_cast<microseconds>(now - tickStart);
-    while (delta < std::max(targetTickTime, microseconds(1000))) {
-        std::this_thread::sleep_for(microseconds(500));
-        now = high_resolution_clock::now();
-        delta = duration_cast<microseconds>(now - tickStart);
+constexpr double BytesPerKiB = 1024.0;
+constexpr double BytesPerMiB = 1024.0 * 1024.0;
+
+/**
+ * @brief Resident set size of the process, if the platform exposes it.
+ */
+std::optional<std::size_t> residentMemoryBytes() {
+#ifdef __linux__
+    std::ifstream statm{"/proc/self/statm"};
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+    if (statm >> totalPages >> residentPages) {
+        return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
     }
+#endif
+    return std::nullopt;
 }
 
 } // namespace
@@ -68,37 +66,59 @@ Server::Server(resources::ServerConfig serverConfig, resources::GameConfig gameC
                boost::asio::io_context &ioContext)
     : serverConfig_(std::move(serverConfig))
     , gameConfig_(std::move(gameConfig))
-    , host_(net::Host::create(ioContext, this->serverConfig_.port)) {
-    scripting::Initialize();
+    , host_(net::Host::create(ioContext, this->serverConfig_.port))
+    , scheduler_(this->serverConfig_.tick_rate, this->serverConfig_.tick_overrun_policy,
+                 std::chrono::microseconds{this->serverConfig_.tick_spin_us}) {
     scripting::InitializeInterface(std::make_unique<ServerInterface>());
 
-    if (this->serverConfig_.tick_rate > 100) {
-        std::cerr << "Error: server tick_rate of " << this->serverConfig_.tick_rate
-                  << " is too high (limit: 100)" << std::endl;
-        std::exit(0);
-    }
-
-    // Initialize game and load initial scene
-    this->initGame();
+    // Create the default room, which clients join when they don't ask for a
+    // specific room. It lives for as long as the server does.
+    this->findOrCreateRoom("");
 
     // Start hosting server
     this->host_->start();
 }
 
+Server::~Server() {
+    this->running_ = false;
+    for (auto &tickThread : this->tickThreads_) {
+        if (tickThread->thread.joinable()) {
+            tickThread->thread.join();
+        }
+    }
+}
+
 void Server::run() {
-    assert(this->game_ != nullptr);
+    // Spawn the tick threads. Rooms are assigned to threads as they are created,
+    // so hand over any rooms that already exist.
+    for (unsigned int i = 0; i < this->serverConfig_.tick_threads; ++i) {
+        auto &tickThread = this->tickThreads_.emplace_back(
+            std::make_unique<TickThread>(this->serverConfig_));
+        this->lastBusyTimeUs_.push_back(0);
+        tickThread->thread = std::thread([this, i, &tickThread = *tickThread] {
+            util::SetTraceThreadName("Tick thread " + std::to_string(i));
+            this->tickThreadMain(tickThread);
+        });
+    }
+    for (const auto &room : this->rooms_) {
+        auto &tickThread = *this->tickThreads_[0];
+        std::lock_guard guard(tickThread.mu);
+        tickThread.addedRooms.push_back(room.second);
+    }
 
-    auto targetTickTime = std::chrono::microseconds(1000000) / this->serverConfig_.tick_rate;
-    time_point<high_resolution_clock> tickStart;
+    this->lastStatsReport_ = std::chrono::steady_clock::now();
+    util::SetTraceThreadName("Server");
 
+    // Network traffic is routed on the same schedule that rooms tick on
+    this->scheduler_.start();
     while (this->running_) {
 #ifdef TRACK_FPS
         util::StartFrame();
 #endif
 
-        tickStart = high_resolution_clock::now();
-        this->tick();
-        sleepToTargetTickRate(tickStart, targetTickTime);
+        this->processNetwork();
+        this->reportStats();
+        this->scheduler_.waitForNextTick();
 
 #ifdef TRACK_FPS
         util::EndFrame();
@@ -106,448 +126,264 @@ void Server::run() {
     }
 }
 
-net::ReplicatorService &Server::replicatorService() {
-    return this->replicatorService_;
-}
+void Server::tickThreadMain(TickThread &tickThread) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::steady_clock;
 
-unsigned int Server::tickNum() const {
-    return this->tickNum_;
-}
+    tickThread.scheduler.start();
+    while (this->running_) {
+        auto tickStart = steady_clock::now();
 
-std::vector<client_id_t> Server::joinedClients() const {
-    // Find all joined clients
-    std::vector<client_id_t> joinedClients;
-    for (const auto &state : this->clientStates_) {
-        if (state.second == ClientState::Joined) {
-            joinedClients.push_back(state.first);
+        // Pick up any rooms assigned to this thread since the last tick
+        {
+            std::lock_guard guard(tickThread.mu);
+            for (auto &room : tickThread.addedRooms) {
+                tickThread.rooms.push_back(std::move(room));
+            }
+            tickThread.addedRooms.clear();
         }
-    }
-    return joinedClients;
-}
-
-void Server::tick() {
-    // 1. Process network events and messages. This includes client join/leave
-    // events and all other general messages like MessageHello.
-    this->processNetwork();
-
-    // If there are no clients connected, conditionally proceed based on server
-    // configuration's empty_behavior value.
-    if (this->clientStates_.empty() &&
-        this->serverConfig_.empty_behavior != resources::ServerEmptyBehavior::Run) {
-        // Behavior is either pause or reset, either way don't update.
-        return;
-    }
-
-    // 2. Run the game update loop. Executes OnStart, OnUpdate, etc.
-    this->updateGame();
 
-    // 3. Gather any replication requests that were created during the previous
-    // update loop and broadcast them to all joined clients.
-    this->executeReplications();
+        // Drop closed rooms. The last reference to a room is usually held
+        // here, so the room is torn down on this thread.
+        std::erase_if(tickThread.rooms, [](const std::shared_ptr<Room> &room) {
+            return room->closed();
+        });
+        tickThread.roomCount = tickThread.rooms.size();
 
-    // 4. Execute any deferred actions.
-    this->executeAfterUpdates();
-
-    // 5. Increment the tick counter. Note that if the game is paused due to no
-    // connected clients, the tick counter will not increase.
-    ++this->tickNum_;
-}
-
-void Server::initGame() {
-    // Create game instance
-    this->game_ = std::make_unique<game::Game>(this->gameConfig_);
-    this->game_->loadScene(this->serverConfig_.initial_scene);
-}
+        for (auto &room : tickThread.rooms) {
+            room->tick();
+        }
+        this->collectGarbage(tickThread);
 
-void Server::updateGame() {
-    // Check for going to another scene
-    if (!this->nextScene_.empty()) {
-        this->swapScene(this->nextScene_);
-        this->nextScene_.clear();
-    }
+        tickThread.busyTimeUs +=
+            duration_cast<microseconds>(steady_clock::now() - tickStart).count();
 
-    // Check for sending out room state updates
-    if (this->roomStateChanged_) {
-        this->broadcastRoomState();
-        this->roomStateChanged_ = false;
+        tickThread.scheduler.waitForNextTick();
     }
-
-    // Run the game update logic
-    this->game_->update();
-}
-
-void Server::swapScene(const std::string &name) {
-    // Increment the generation counter ahead of the scene loading
-    ++this->generation_;
-
-    // Clear any pending replications
-    this->replicatorService_.clear();
-
-    // Switch the scene
-    this->game_->loadScene(name);
-
-    // Inform all connected clients about the new scene
-    this->host_->broadcastMessage(net::MessageLoadScene{
-        .generation = this->generation_,
-        .sceneName = name,
-        .runtimeActors = {}, // No updates yet = no runtime actors
-        .sceneState = {},    // Fresh scene, no additional state to replicate
-    });
-}
-
-void Server::setNextScene(std::string_view name) {
-    this->nextScene_ = name;
 }
 
-void Server::clientJoined(client_id_t clientID) {
-    // Update client state map
-    assert(this->clientStates_.contains(clientID));
-    this->clientStates_[clientID] = ClientState::Joined;
-
-    // Mark server as needing to send out a room state update this tick
-    this->roomStateChanged_ = true;
-
-    this->doAfterUpdate([this, clientID] {
-        // Process any subscriptions to client join events
-        this->game_->eventSub().publish(events::MultiplayerOnClientJoin, clientID);
-    });
-}
-
-void Server::clientLeft(client_id_t clientID) {
-    // Erase client from state map
-    this->clientStates_.erase(clientID);
-
-    // Destroy any actors owned by the client that left
-    for (auto &actor : this->game_->currentScene().actors()) {
-        if (actor->ownerClient == clientID) {
-            actor->destroy();
-        }
+void Server::collectGarbage(TickThread &tickThread) {
+    using std::chrono::steady_clock;
+
+    // Share the idle time left before the next tick between the rooms. Stop
+    // short of the deadline by the spin time, so that collecting can't delay
+    // the next tick.
+    auto idleEnd = tickThread.scheduler.nextDeadline() -
+                   std::chrono::microseconds{this->serverConfig_.tick_spin_us};
+    auto budget = std::chrono::microseconds{this->serverConfig_.lua_gc_budget_us};
+    auto remainingRooms = static_cast<steady_clock::rep>(tickThread.rooms.size());
+    for (auto &room : tickThread.rooms) {
+        auto now = steady_clock::now();
+        auto share = now < idleEnd ? (idleEnd - now) / remainingRooms : steady_clock::duration{0};
+        room->collectGarbage(now + std::min<steady_clock::duration>(share, budget));
+        --remainingRooms;
     }
-
-    if (this->clientStates_.empty() &&
-        this->serverConfig_.empty_behavior == resources::ServerEmptyBehavior::Reset) {
-        // There are no connected clients, we are supposed to reset the game now.
-        this->initGame();
-        // Because there are no connected clients, we also don't need to send out
-        // room state updates (there are no clients connected to receive them!).
-        // We also just initialized a new game so it doesn't make sense to publish
-        // any events::MultiplayerOnClientLeave events, so just return.
-        return;
-    }
-
-    // Mark server as needing to send out a room state update this tick
-    this->roomStateChanged_ = true;
-
-    this->doAfterUpdate([this, clientID] {
-        // Process any subscriptions to client leave events
-        this->game_->eventSub().publish(events::MultiplayerOnClientLeave, clientID);
-    });
 }
 
 void Server::processNetwork() {
+    TRACE_ZONE("Server.ProcessNetwork");
     // 1. Process "ClientEvent" events. These are socket/connection level events
     // like connect/disconnect.
     this->host_->consumeAllClientEvents([&](std::unique_ptr<net::ClientEvent> event) {
-        switch (event->event) {
-        case net::ClientEventType::Connected:
-            this->clientStates_.emplace(event->clientID, ClientState::Initializing);
-            break;
-        case net::ClientEventType::Disconnected:
-            this->clientLeft(event->clientID);
-            break;
-        }
+        this->routeClientEvent(*event);
     });
 
-    // 2. Process messages from clients. Execute all required handling logic and
-    // send all required messages/broadcasts as a result of executing the handlers.
+    // 2. Hand messages from clients over to the room each client joined.
     this->host_->consumeAllClientMessages([&](std::unique_ptr<net::ClientMessage> msg) {
-        this->processMessage(std::move(msg));
+        this->routeClientMessage(std::move(msg));
     });
 }
 
-void Server::executeReplications() {
-    this->executeTickReplication();
-    this->executeRemoteEvents();
-}
+void Server::routeClientEvent(const net::ClientEvent &event) {
+    switch (event.event) {
+    case net::ClientEventType::Connected:
+        // The client isn't part of any room until it sends a MessageHello
+        break;
+    case net::ClientEventType::Disconnected: {
+        auto it = this->clientRooms_.find(event.clientID);
+        if (it == this->clientRooms_.end()) {
+            // Client never joined a room
+            break;
+        }
+        auto room = std::move(it->second);
+        this->clientRooms_.erase(it);
+        room->post(event);
 
-void Server::executeTickReplication() {
-    if (!this->replicatorService_.hasPendingReplications()) {
-        // No replication data to send
-        return;
+        // Close rooms other than the default room once everyone has left
+        if (--this->roomClientCounts_[room.get()] == 0 && !room->name().empty()) {
+            this->closeRoom(room->name());
+        }
+        break;
     }
-
-    // Server-side actor instantiations or state replications have occurred.
-    // Serialize them and broadcast them to all joined clients.
-    auto instantiations = this->replicatorService_.serializeInstantiations();
-    auto replicationRequests = this->replicatorService_.serializeComponents();
-    auto destructions = this->replicatorService_.serializeDestructions();
-    assert(!instantiations.empty() || !replicationRequests.empty() || !destructions.empty());
-
-    this->broadcastToJoined(net::MessageTickReplication{
-        .generation = this->generation_,
-        .instantiations = std::move(instantiations),
-        .replications = std::move(replicationRequests),
-        .destructions = std::move(destructions),
-    });
-}
-
-void Server::executeRemoteEvents() {
-    if (!this->replicatorService_.hasPendingEventPublishes()) {
-        // No remote events to send
-        return;
     }
-
-    auto publishes = this->replicatorService_.serializeEventPublishes();
-    assert(!publishes.empty());
-
-    this->broadcastToJoined(net::MessageRemoteEvents{
-        .generation = this->generation_,
-        .publishes = std::move(publishes),
-    });
-}
-
-//-----------------------------------------------------------------------------
-// Client message processing
-
-void Server::processMessage(std::unique_ptr<net::ClientMessage> msg) {
-    if (!this->clientStates_.contains(msg->clientID)) {
-        std::cerr << "warning: dropping message from client " << msg->clientID
-                  << " because it appears to no longer be connected" << std::endl;
-        return;
-    };
-    std::visit(
-        [this, cid = msg->clientID](auto &m) {
-            this->processMessage(cid, m);
-        },
-        *msg->msg);
-}
-
-void Server::processMessage(client_id_t clientID, const net::MessageError &m) {
-    std::cerr << "[ MSG_ERROR ] Client " << clientID << ": " << m.error << std::endl;
-    this->host_->disconnectClient(clientID);
 }
 
-void Server::processMessage(client_id_t clientID, const net::MessageHello &m) {
-    // Mark client ID as joined to game
-    this->clientJoined(clientID);
-
-    // Replicate any actors created at runtime
-    auto runtimeActors = net::ReplicatorService::replicateRuntimeActors(*this->game_);
-    // Replicate entire game state in form of ReplicationRequests
-    auto sceneState = this->replicatorService_.replicateGame(*this->game_);
-
-    // Send MessageWelcome with assigned client ID and tick rate
-    this->host_->postMessage(clientID,
-                             net::MessageWelcome{
-                                 .clientID = clientID,
-                                 .serverTickRate = this->serverConfig_.tick_rate,
-                             });
-
-    // Send current scene state
-    this->host_->postMessage(clientID,
-                             net::MessageLoadScene{
-                                 .generation = this->generation_,
-                                 .sceneName = this->game_->currentScene().name(),
-                                 .runtimeActors = std::move(runtimeActors),
-                                 .sceneState = std::move(sceneState),
-                             });
-}
+void Server::routeClientMessage(std::unique_ptr<net::ClientMessage> msg) {
+    auto clientID = msg->clientID;
 
-void Server::processMessage(client_id_t clientID, const net::MessageLoadSceneRequest &m) {
-    // A client wants to swap to another scene. Check to make sure the
-    // generation number matches before confirming the switch.
-    if (m.generation != this->generation_) {
-        // Silently drop the request
+    // Clients that already joined a room talk only to that room
+    auto it = this->clientRooms_.find(clientID);
+    if (it != this->clientRooms_.end()) {
+        it->second->post(std::move(msg));
         return;
     }
-    // Set the next scene to load at the beginning of the game update
-    // phase. This means that if another client comes along and also
-    // requests to load a different scene, the later client will win.
-    this->setNextScene(m.sceneName);
-}
 
-void Server::processMessage(client_id_t clientID, net::MessageTickReplication &m) {
-    // A client has updated the game state and has requested to replicate
-    // the state to the server and other clients.
-    // 1. Instantiate any new actors.
-    // 2. Process any replication requests.
-    // 3. Acknowledge the tick replication to the sender client.
-    // 4. Broadcast the replication to all other clients.
-    auto &scene = this->game_->currentScene();
-
-    if (m.generation != this->generation_) {
-        // Mismatched generation. The server has loaded a new scene but
-        // the client has not yet processed the new load. Reject any actor
-        // instantiations and let the client know so they can appropriately
-        // keep the game in sync.
-        if (!m.instantiations.empty()) {
-            std::vector<actor_id_t> rejectedInstantiations;
-            rejectedInstantiations.reserve(m.instantiations.size());
-            for (const auto &instantiation : m.instantiations) {
-                rejectedInstantiations.push_back(instantiation.id);
-            }
-            this->host_->postMessage(
-                clientID,
-                net::MessageTickReplicationReject{
-                    .serverGeneration = this->generation_,
-                    .rejectedInstantiations = std::move(rejectedInstantiations),
-                });
-        }
-        // Drop the replication message -- the state to replicate no
-        // longer exists as we are in a different scene.
+    const auto* hello = std::get_if<net::MessageHello>(msg->msg.get());
+    if (hello == nullptr) {
+        std::cerr << "warning: dropping message from client " << clientID
+                  << " because it has not joined a room" << std::endl;
         return;
     }
 
-    // Clients shouldn't send tick replications for no reason, but avoid
-    // doing work that we don't need to do
-    if (m.instantiations.empty() && m.replications.empty() && m.destructions.empty()) {
+    auto room = this->findOrCreateRoom(hello->room);
+    if (room == nullptr) {
+        this->host_->postMessage(clientID,
+                                 net::MessageError{
+                                     .error = "server is full",
+                                 });
+        this->host_->disconnectClient(clientID);
         return;
     }
 
-    // Process all actor instantiations
-    std::vector<net::RemoteIDMapping> remoteIDMappings;
-    std::vector<net::InstantiatedActor> rewrittenInstantiations;
-    remoteIDMappings.reserve(m.instantiations.size());
-    rewrittenInstantiations.reserve(m.instantiations.size());
-    for (auto &instantiation : m.instantiations) {
-        // Instantiate the runtime actor
-        auto* a = scene.instantiateRuntimeActor(instantiation.actorTemplate, instantiation.owner);
-        // Map client-side id to server-side id
-        remoteIDMappings.emplace_back(instantiation.id, a->id);
-        // Reconstruct the instantiation with server-side actor id so
-        // we can broadcast to other clients.
-        rewrittenInstantiations.emplace_back(instantiation.actorTemplate,
-                                             a->id,
-                                             a->ownerClient,
-                                             std::move(instantiation.componentState));
-    }
-
-    // Process all replication requests, updating the game state.
-    // Note that the client should only be replicating components from
-    // actors who are intrinsic to the scene or have been ack'd.
-    for (const auto &req : m.replications) {
-        this->processReplicationRequest(req);
-    }
+    // Register the client with the room, then let the room process the hello
+    this->clientRooms_.emplace(clientID, room);
+    ++this->roomClientCounts_[room.get()];
+    room->post(net::ClientEvent{
+        .clientID = clientID,
+        .event = net::ClientEventType::Connected,
+    });
+    room->post(std::move(msg));
+}
 
-    // Process all actor destructions
-    for (auto id : m.destructions) {
-        // Find the actor we want to destroy
-        auto* a = scene.findActorByID(id);
-        if (a == nullptr) {
-            continue;
-        }
-        // Found it, so destroy it. Don't replicate it to clients later
-        // because we are going to do so below.
-        a->destroyLocally();
+std::shared_ptr<Room> Server::findOrCreateRoom(const std::string &name) {
+    auto it = this->rooms_.find(name);
+    if (it != this->rooms_.end()) {
+        return it->second;
     }
 
-    // Acknowledge tick replication if required
-    if (!remoteIDMappings.empty()) {
-        this->host_->postMessage(clientID,
-                                 net::MessageTickReplicationAck{
-                                     .remoteIDMappings = std::move(remoteIDMappings),
-                                 });
+    if (this->rooms_.size() >= this->serverConfig_.max_rooms) {
+        std::cerr << "warning: refusing to create room \"" << name << "\" because the server is "
+                  << "hosting the maximum of " << this->serverConfig_.max_rooms << " rooms"
+                  << std::endl;
+        return nullptr;
     }
 
-    // Broadcast replication message to all other connected clients
-    this->broadcastToOthers(
-        net::MessageTickReplication{
-            .generation = this->generation_,
-            .instantiations = std::move(rewrittenInstantiations),
-            .replications = std::move(m.replications),
-            .destructions = std::move(m.destructions),
-        },
-        clientID);
-}
+    auto room =
+        std::make_shared<Room>(name, this->serverConfig_, this->gameConfig_, this->host_);
+    this->rooms_.emplace(name, room);
+    this->roomClientCounts_.emplace(room.get(), 0);
 
-void Server::processMessage(client_id_t clientID, net::MessageRemoteEvents &m) {
-    // The client has some remote events for us.
-    // 1. Verify the generation number
-    // 2. Forward the remote events to all other clients
-    // 3. Dispatch the published events to the server's EventSub instance
-
-    if (m.generation != this->generation_) {
-        // Silently drop the request
-        return;
+    if (this->tickThreads_.empty()) {
+        // Not running yet, run() hands the room to a tick thread
+        return room;
     }
 
-    // Clients shouldn't send empty publishes but check so we don't end up
-    // doing any unneeded work.
-    if (m.publishes.empty()) {
-        return;
+    // Assign the room to the tick thread with the fewest rooms
+    TickThread* target = nullptr;
+    std::size_t targetRooms = 0;
+    for (auto &tickThread : this->tickThreads_) {
+        std::lock_guard guard(tickThread->mu);
+        auto rooms = tickThread->roomCount + tickThread->addedRooms.size();
+        if (target == nullptr || rooms < targetRooms) {
+            target = tickThread.get();
+            targetRooms = rooms;
+        }
     }
+    std::lock_guard guard(target->mu);
+    target->addedRooms.push_back(room);
 
-    // Forward this publish to other clients
-    this->broadcastToOthers(m, clientID);
-
-    this->doAfterUpdate([this, publishes = std::move(m.publishes)] {
-        // Dispatch to game EventSub
-        for (const auto &p : publishes) {
-            this->game_->eventSub().publish(p.event, p.value);
-        }
-    });
+    return room;
 }
 
-//-----------------------------------------------------------------------------
-
-void Server::processReplicationRequest(const net::ComponentReplication &replication) {
-    // No interp on server
-    net::ReplicatorService::dispatchReplication(*this->game_, replication, false);
+void Server::closeRoom(const std::string &name) {
+    auto it = this->rooms_.find(name);
+    assert(it != this->rooms_.end());
+    it->second->close();
+    this->roomClientCounts_.erase(it->second.get());
+    this->rooms_.erase(it);
 }
 
-void Server::sendInvalidMessage(client_id_t clientID) {
-    this->host_->postMessage(clientID,
-                             net::MessageError{
-                                 .error = "invalid message received",
-                             });
-    this->host_->disconnectClient(clientID);
-}
+void Server::reportStats() {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    using std::chrono::seconds;
+    using std::chrono::steady_clock;
 
-void Server::broadcastToJoined(const net::SMessage &msg) {
-    if (this->clientStates_.empty()) {
-        // No clients to broadcast to
+    if (this->serverConfig_.stats_interval == 0) {
         return;
     }
-    this->host_->broadcastMessage(msg, [&](client_id_t cid) {
-        return this->isJoined(cid);
-    });
-}
 
-void Server::broadcastToOthers(const net::SMessage &msg, client_id_t src) {
-    assert(this->isJoined(src));
-    if (this->clientStates_.size() <= 1) {
-        // No other clients to broadcast to
+    auto now = steady_clock::now();
+    auto elapsed = now - this->lastStatsReport_;
+    if (elapsed < seconds(this->serverConfig_.stats_interval)) {
         return;
     }
-    this->host_->broadcastMessage(msg, [&](client_id_t cid) {
-        return cid != src && this->isJoined(cid);
-    });
-}
-
-void Server::broadcastRoomState() {
-    // Broadcast the joined clients to all clients
-    this->broadcastToJoined(net::MessageRoomState{
-        .joinedClients = this->joinedClients(),
-    });
-}
-
-bool Server::isJoined(client_id_t clientID) const {
-    auto it = this->clientStates_.find(clientID);
-    if (it == this->clientStates_.end()) {
-        return false;
+    this->lastStatsReport_ = now;
+    auto elapsedUs = static_cast<double>(duration_cast<microseconds>(elapsed).count());
+
+    // Fraction of wall time each tick thread spent ticking rooms
+    std::vector<double> busy(this->tickThreads_.size());
+    double busyCores = 0.0;
+    for (std::size_t i = 0; i < this->tickThreads_.size(); ++i) {
+        auto busyUs = this->tickThreads_[i]->busyTimeUs.load();
+        busy[i] = static_cast<double>(busyUs - this->lastBusyTimeUs_[i]) / elapsedUs;
+        busyCores += busy[i];
+        this->lastBusyTimeUs_[i] = busyUs;
     }
-    return it->second == ClientState::Joined;
-}
 
-void Server::doAfterUpdate(std::function<void()> f) {
-    this->afterUpdate_.emplace_back(std::move(f));
-}
+    auto roomCount = this->rooms_.size();
+    std::cout << "[ STATS ] " << roomCount << " rooms on " << this->tickThreads_.size()
+              << " tick threads, " << std::fixed << std::setprecision(1) << busyCores * 100.0
+              << "% of a core busy";
+    if (busyCores > 0.0) {
+        std::cout << ", ~" << static_cast<double>(roomCount) / busyCores << " rooms/core";
+    }
+    auto rss = residentMemoryBytes();
+    if (rss.has_value()) {
+        std::cout << ", rss " << static_cast<double>(*rss) / BytesPerMiB << " MiB (~"
+                  << static_cast<double>(*rss) / BytesPerMiB / static_cast<double>(roomCount)
+                  << " MiB/room)";
+    }
+    std::cout << std::endl;
+
+    for (std::size_t i = 0; i < this->tickThreads_.size(); ++i) {
+        auto &tickThread = *this->tickThreads_[i];
+        const auto &scheduling = tickThread.scheduler.stats();
+        auto onTimeTicks = scheduling.ticks - scheduling.lateTicks;
+        auto avgJitterUs = onTimeTicks == 0 ? 0.0
+                                            : static_cast<double>(scheduling.jitterTotalUs) /
+                                                  static_cast<double>(onTimeTicks);
+        std::cout << "[ STATS ]   tick thread " << i << ": " << tickThread.roomCount
+                  << " rooms, " << std::setprecision(1) << busy[i] * 100.0 << "% busy, "
+                  << scheduling.lateTicks << " late / " << scheduling.skippedTicks
+                  << " skipped ticks, jitter avg " << avgJitterUs << " us max "
+                  << tickThread.scheduler.takeMaxJitterUs() << " us" << std::endl;
+    }
 
-void Server::executeAfterUpdates() {
-    for (const auto &after : this->afterUpdate_) {
-        std::invoke(after);
+    for (const auto &[name, room] : this->rooms_) {
+        const auto &stats = room->stats();
+        auto ticks = stats.ticks.load();
+        auto avgTickMs = ticks == 0 ? 0.0
+                                    : static_cast<double>(stats.totalTickTimeUs) /
+                                          static_cast<double>(ticks) / 1000.0;
+        auto avgGcMs = ticks == 0 ? 0.0
+                                  : static_cast<double>(stats.totalGcTimeUs) /
+                                        static_cast<double>(ticks) / 1000.0;
+        std::cout << "[ STATS ]   room \"" << name << "\": " << stats.clients << " clients, "
+                  << stats.actors << " actors, lua " << std::setprecision(1)
+                  << static_cast<double>(stats.luaMemoryBytes) / BytesPerKiB
+                  << " KiB, pool " << stats.poolHits << " hits / " << stats.poolMisses
+                  << " misses, tick avg " << std::setprecision(2) << avgTickMs << " ms max "
+                  << static_cast<double>(stats.maxTickTimeUs) / 1000.0 << " ms, gc avg "
+                  << avgGcMs << " ms max " << static_cast<double>(stats.maxGcTimeUs) / 1000.0
+                  << " ms, " << stats.gcEmergencies << " full gcs, replication "
+                  << std::setprecision(1)
+                  << static_cast<double>(stats.replicatedSentBytes) / BytesPerKiB << " of "
+                  << static_cast<double>(stats.replicatedStateBytes) / BytesPerKiB
+                  << " KiB sent" << std::endl;
     }
-    this->afterUpdate_.clear();
+    std::cout << std::defaultfloat;
 }
 
 std::unique_ptr<Server> EngineServer = nullptr;
@@ -567,18 +403,4 @@ Server &CurrentServer() {
     return *EngineServer;
 }
 
-} // namespace server
-
-game::Game &CurrentGame() {
-    return *server::CurrentServer().game_;
-}
-
-game::Scene &CurrentScene() {
-    return CurrentGame().currentScene();
-}
-
-bool GameOffline() {
-    return false;
-}
-
-} // namespace sge
+} // namespace sge::server
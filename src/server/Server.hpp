@@ -4,91 +4,98 @@
 
 #include "Common.hpp" // IWYU pragma: keep
 #include "Types.hpp"
-#include "game/Game.hpp"
 #include "net/Host.hpp"
 #include "net/Messages.hpp"
-#include "net/Replicator.hpp"
 #include "resources/Configs.hpp"
+#include "server/Room.hpp"
+#include "util/TickScheduler.hpp"
 
-#include <functional>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
-#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 namespace sge::server {
 
-enum class ClientState {
-    Initializing,
-    Joined,
-};
-
+/**
+ * @brief Hosts any number of independent rooms in one process. The server owns
+ * the network host, routes clients to rooms when they send a MessageHello, and
+ * spreads rooms across a pool of tick threads.
+ */
 class Server {
 public:
     Server(resources::ServerConfig serverConfig, resources::GameConfig gameConfig,
            boost::asio::io_context &ioContext);
+    ~Server();
 
-    void run();
-
-    net::ReplicatorService &replicatorService();
-
-    unsigned int tickNum() const;
-    std::vector<client_id_t> joinedClients() const;
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
 
-    void setNextScene(std::string_view name);
+    /**
+     * @brief Start the tick threads and route network traffic to rooms until
+     * the server stops.
+     */
+    void run();
 
 private:
-    friend game::Game & ::sge::CurrentGame();
-
-    void tick();
-    void initGame();
-    void updateGame();
-    void swapScene(const std::string &name);
-
-    void clientJoined(client_id_t clientID);
-    void clientLeft(client_id_t clientID);
+    /**
+     * @brief A thread that ticks a fixed set of rooms at the server tick rate.
+     */
+    struct TickThread {
+        explicit TickThread(const resources::ServerConfig &config)
+            : scheduler(config.tick_rate, config.tick_overrun_policy,
+                        std::chrono::microseconds{config.tick_spin_us}) {}
+
+        std::thread thread;
+        util::TickScheduler scheduler;
+
+        std::mutex mu;
+        std::vector<std::shared_ptr<Room>> rooms;
+        std::vector<std::shared_ptr<Room>> addedRooms;
+
+        std::atomic<std::size_t> roomCount{0};
+        std::atomic<std::uint64_t> busyTimeUs{0};
+    };
+
+    void tickThreadMain(TickThread &tickThread);
+    /**
+     * @brief Collect the Lua garbage of a tick thread's rooms in the time left
+     * until its next tick.
+     */
+    void collectGarbage(TickThread &tickThread);
 
     void processNetwork();
-    void processMessage(std::unique_ptr<net::ClientMessage> msg);
-    void processMessage(client_id_t clientID, const net::MessageError &m);
-    void processMessage(client_id_t clientID, const net::MessageHello &m);
-    void processMessage(client_id_t clientID, const net::MessageLoadSceneRequest &m);
-    void processMessage(client_id_t clientID, net::MessageTickReplication &m);
-    void processMessage(client_id_t clientID, net::MessageRemoteEvents &m);
-
-    void executeReplications();
-    void executeTickReplication();
-    void executeRemoteEvents();
-    void processReplicationRequest(const net::ComponentReplication &replication);
-
-    void sendInvalidMessage(client_id_t clientID);
-    void broadcastToJoined(const net::SMessage &msg);
-    void broadcastToOthers(const net::SMessage &msg, client_id_t src);
-    void broadcastRoomState();
+    void routeClientEvent(const net::ClientEvent &event);
+    void routeClientMessage(std::unique_ptr<net::ClientMessage> msg);
 
-    bool isJoined(client_id_t clientID) const;
+    std::shared_ptr<Room> findOrCreateRoom(const std::string &name);
+    void closeRoom(const std::string &name);
 
-    void doAfterUpdate(std::function<void()> f);
-    void executeAfterUpdates();
+    void reportStats();
 
     resources::ServerConfig serverConfig_;
     resources::GameConfig gameConfig_;
 
     net::Host::pointer host_;
-    net::ReplicatorService replicatorService_;
-    std::unordered_map<client_id_t, ClientState> clientStates_;
 
-    std::unique_ptr<game::Game> game_{nullptr};
+    std::atomic<bool> running_{true};
+    util::TickScheduler scheduler_;
 
-    bool running_{true};
-    unsigned int tickNum_{0};
-    unsigned int generation_{0};
+    // Room bookkeeping. Only touched by the thread calling run().
+    std::map<std::string, std::shared_ptr<Room>> rooms_;
+    std::unordered_map<client_id_t, std::shared_ptr<Room>> clientRooms_;
+    std::unordered_map<Room*, std::size_t> roomClientCounts_;
 
-    std::string nextScene_{};
-    bool roomStateChanged_{false};
+    std::vector<std::unique_ptr<TickThread>> tickThreads_;
 
-    std::vector<std::function<void()>> afterUpdate_;
+    std::chrono::steady_clock::time_point lastStatsReport_;
+    std::vector<std::uint64_t> lastBusyTimeUs_;
 };
 
 void InitServer(resources::ServerConfig serverConfig, resources::GameConfig gameConfig,
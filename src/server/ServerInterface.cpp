@@ -6,8 +6,9 @@
 #include "physics/Raycast.hpp"
 #include "scripting/Component.hpp"
 #include "scripting/EventSub.hpp"
-#include "server/Server.hpp"
+#include "server/Room.hpp"
 
+#include <chrono>
 #include <iostream>
 #include <optional>
 #include <string>
@@ -30,7 +31,7 @@ void ServerInterface::applicationQuit() {}
 void ServerInterface::applicationSleep(int ms) {}
 
 unsigned int ServerInterface::applicationGetFrame() {
-    return CurrentServer().tickNum();
+    return CurrentRoom().tickNum();
 }
 
 void ServerInterface::applicationOpenURL(std::string_view url) {}
@@ -75,7 +76,7 @@ game::Actor* ServerInterface::actorFind(std::string_view name) {
     return CurrentScene().findActor(name);
 }
 
-std::vector<game::Actor*> ServerInterface::actorFindAll(std::string_view name) {
+const std::vector<game::Actor*> &ServerInterface::actorFindAll(std::string_view name) {
     return CurrentScene().findAllActors(name);
 }
 
@@ -83,7 +84,7 @@ game::Actor* ServerInterface::actorInstantiate(std::string_view templateName,
                                                std::optional<client_id_t> ownerClient) {
     auto owner = ownerClient.value_or(0);
     auto* a = CurrentScene().instantiateRuntimeActor(templateName, owner);
-    CurrentServer().replicatorService().instantiate(a);
+    CurrentRoom().replicatorService().instantiate(a);
     return a;
 }
 
@@ -130,7 +131,7 @@ float ServerInterface::cameraGetZoom() {
 }
 
 void ServerInterface::sceneLoad(std::string_view name) {
-    CurrentServer().setNextScene(name);
+    CurrentRoom().setNextScene(name);
 }
 
 std::string ServerInterface::sceneGetCurrent() {
@@ -153,14 +154,21 @@ std::vector<physics::HitResult> ServerInterface::physicsRaycastAll(const b2Vec2
     return CurrentGame().physicsWorld().raycastAll(pos, direction, distance);
 }
 
+float ServerInterface::physicsGetInterpolationAlpha() {
+    return CurrentGame().physicsAlpha();
+}
+
+float ServerInterface::physicsGetTimeStep() {
+    return std::chrono::duration<float>(CurrentGame().physicsStepDuration()).count();
+}
+
 void ServerInterface::eventPublish(std::string_view eventType, const luabridge::LuaRef &value) {
     CurrentGame().eventSub().publish(eventType, value);
 }
 
 void ServerInterface::eventPublishRemote(std::string_view eventType, const luabridge::LuaRef &value,
                                          bool publishLocally) {
-    auto replicableValue = value.cast<scripting::LuaValue>();
-    CurrentServer().replicatorService().eventPublish(eventType, std::move(replicableValue));
+    CurrentRoom().replicatorService().eventPublish(eventType, value);
     if (publishLocally) {
         CurrentGame().eventSub().publish(eventType, value);
     }
@@ -175,7 +183,8 @@ void ServerInterface::eventUnsubscribe(scripting::subscription_handle handle) {
     CurrentGame().eventSub().unsubscribe(handle);
 }
 
-void ServerInterface::multiplayerConnect(std::string_view host, std::string_view port) {}
+void ServerInterface::multiplayerConnect(std::string_view host, std::string_view port,
+                                         std::string_view room) {}
 
 void ServerInterface::multiplayerDisconnect() {}
 
@@ -184,11 +193,11 @@ client_id_t ServerInterface::multiplayerClientID() {
 }
 
 std::vector<client_id_t> ServerInterface::multiplayerJoinedClients() {
-    return CurrentServer().joinedClients();
+    return CurrentRoom().joinedClients();
 }
 
 void ServerInterface::replicatorServiceReplicate(scripting::Component* component) {
-    CurrentServer().replicatorService().replicate(component);
+    CurrentRoom().replicatorService().replicate(component);
 }
 
 } // namespace sge::server
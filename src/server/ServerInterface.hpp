@@ -39,7 +39,7 @@ public:
     float inputGetMouseScrollDelta() override;
 
     game::Actor* actorFind(std::string_view name) override;
-    std::vector<game::Actor*> actorFindAll(std::string_view name) override;
+    const std::vector<game::Actor*> &actorFindAll(std::string_view name) override;
     game::Actor* actorInstantiate(std::string_view templateName,
                                   std::optional<client_id_t> ownerClient) override;
     void actorDestroy(game::Actor* actor) override;
@@ -74,6 +74,8 @@ public:
                                                      float distance) override;
     std::vector<physics::HitResult> physicsRaycastAll(const b2Vec2 &pos, const b2Vec2 &direction,
                                                       float distance) override;
+    float physicsGetInterpolationAlpha() override;
+    float physicsGetTimeStep() override;
 
     void eventPublish(std::string_view eventType, const luabridge::LuaRef &value) override;
     void eventPublishRemote(std::string_view eventType, const luabridge::LuaRef &value,
@@ -82,7 +84,8 @@ public:
         std::string_view event, const luabridge::LuaRef &function) override;
     void eventUnsubscribe(scripting::subscription_handle handle) override;
 
-    void multiplayerConnect(std::string_view host, std::string_view port) override;
+    void multiplayerConnect(std::string_view host, std::string_view port,
+                            std::string_view room) override;
     void multiplayerDisconnect() override;
     client_id_t multiplayerClientID() override;
     std::vector<client_id_t> multiplayerJoinedClients() override;
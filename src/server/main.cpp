@@ -15,10 +15,23 @@ int main(int /*argc*/, char** /*argv*/) {
     auto serverConfig = sge::resources::LoadServerConfig();
     auto gameConfig = sge::resources::LoadGameConfig();
 
+    if (serverConfig.tick_rate == 0 || serverConfig.tick_rate > sge::resources::MaxServerTickRate) {
+        std::cerr << "tick_rate must be between 1 and " << sge::resources::MaxServerTickRate
+                  << std::endl;
+        std::exit(1);
+    }
     if (serverConfig.io_workers == 0) {
         std::cerr << "io_workers must be greater than zero" << std::endl;
         std::exit(1);
     }
+    if (serverConfig.tick_threads == 0) {
+        std::cerr << "tick_threads must be greater than zero" << std::endl;
+        std::exit(1);
+    }
+    if (serverConfig.max_rooms == 0) {
+        std::cerr << "max_rooms must be greater than zero" << std::endl;
+        std::exit(1);
+    }
 
     std::cout << "starting server on 0.0.0.0:" << serverConfig.port << std::endl;
 
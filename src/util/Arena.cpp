@@ -0,0 +1,120 @@
+#include "util/Arena.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace sge::util {
+
+namespace {
+
+thread_local Arena* ThreadArena = nullptr;
+
+// Precedes every ArenaAllocated object. Sized to keep objects aligned like
+// operator new would.
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) AllocationHeader {
+    // nullptr if allocated from the heap
+    Arena* arena;
+};
+
+constexpr std::size_t sizeClassIndex(std::size_t size) {
+    for (std::size_t i = 0; i < Arena::SizeClasses.size(); ++i) {
+        if (size <= Arena::SizeClasses[i]) {
+            return i;
+        }
+    }
+    return Arena::SizeClasses.size();
+}
+
+static_assert(Arena::SizeClasses[0] >= sizeof(AllocationHeader) * 2);
+static_assert(Arena::SizeClasses[0] % __STDCPP_DEFAULT_NEW_ALIGNMENT__ == 0);
+static_assert(Arena::ChunkSize % Arena::SizeClasses.back() == 0);
+
+} // namespace
+
+Arena::~Arena() {
+    assert(this->stats_.allocations == this->stats_.deallocations &&
+           "arena destroyed with live blocks");
+}
+
+void* Arena::allocate(std::size_t size) {
+    auto index = sizeClassIndex(size);
+    if (index == SizeClasses.size()) {
+        ++this->stats_.oversized;
+        return nullptr;
+    }
+
+    auto &sizeClass = this->classes_[index];
+    ++this->stats_.allocations;
+    if (sizeClass.freeList != nullptr) {
+        // Reuse a freed block
+        auto* block = sizeClass.freeList;
+        sizeClass.freeList = block->next;
+        return block;
+    }
+
+    if (sizeClass.bump == sizeClass.bumpEnd) {
+        // Carve blocks out of a new chunk
+        auto &chunk =
+            this->chunks_.emplace_back(std::make_unique_for_overwrite<std::byte[]>(ChunkSize));
+        sizeClass.bump = chunk.get();
+        sizeClass.bumpEnd = chunk.get() + ChunkSize;
+        ++this->stats_.chunks;
+    }
+    auto* block = sizeClass.bump;
+    sizeClass.bump += SizeClasses[index];
+    return block;
+}
+
+void Arena::deallocate(void* block, std::size_t size) {
+    auto index = sizeClassIndex(size);
+    assert(index < SizeClasses.size());
+    auto &sizeClass = this->classes_[index];
+    sizeClass.freeList = new (block) FreeBlock{sizeClass.freeList};
+    ++this->stats_.deallocations;
+}
+
+const ArenaStats &Arena::stats() const {
+    return this->stats_;
+}
+
+Arena* CurrentArena() {
+    return ThreadArena;
+}
+
+ArenaScope::ArenaScope(Arena* arena)
+    : previous_(ThreadArena) {
+    ThreadArena = arena;
+}
+
+ArenaScope::~ArenaScope() {
+    ThreadArena = this->previous_;
+}
+
+void* ArenaAllocated::operator new(std::size_t size) {
+    auto total = sizeof(AllocationHeader) + size;
+    auto* arena = ThreadArena;
+    void* block = arena != nullptr ? arena->allocate(total) : nullptr;
+    if (block == nullptr) {
+        arena = nullptr;
+        block = ::operator new(total);
+    }
+    auto* header = new (block) AllocationHeader{arena};
+    return header + 1;
+}
+
+void ArenaAllocated::operator delete(void* ptr, std::size_t size) {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto* header = static_cast<AllocationHeader*>(ptr) - 1;
+    auto total = sizeof(AllocationHeader) + size;
+    if (header->arena != nullptr) {
+        header->arena->deallocate(header, total);
+    } else {
+        ::operator delete(header, total);
+    }
+}
+
+} // namespace sge::util
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace sge::util {
+
+struct ArenaStats {
+    // Chunks allocated from the heap
+    std::size_t chunks{0};
+    // Blocks handed out, including reused ones
+    std::size_t allocations{0};
+    std::size_t deallocations{0};
+    // Requests too large for any size class, which went to the heap instead
+    std::size_t oversized{0};
+};
+
+/**
+ * @brief Allocates small objects from free lists of fixed size classes, which
+ * are carved out of large chunks. Freed blocks are reused by later allocations
+ * of the same size class, and chunks are only released all at once when the
+ * arena is destroyed. Not thread-safe.
+ *
+ * Every block must be deallocated before the arena is destroyed.
+ */
+class Arena {
+public:
+    static constexpr std::array<std::size_t, 4> SizeClasses{64, 128, 256, 512};
+    static constexpr std::size_t ChunkSize = 16 * 1024;
+
+    Arena() = default;
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * @brief Allocate a block of at least size bytes, aligned like operator new.
+     *
+     * @return The block, or nullptr if size is larger than every size class.
+     */
+    void* allocate(std::size_t size);
+
+    /**
+     * @brief Return a block to its free list.
+     *
+     * @param block Block returned by allocate.
+     * @param size Size that the block was allocated with.
+     */
+    void deallocate(void* block, std::size_t size);
+
+    const ArenaStats &stats() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct SizeClass {
+        FreeBlock* freeList{nullptr};
+        // Unused remainder of the newest chunk of this size class
+        std::byte* bump{nullptr};
+        std::byte* bumpEnd{nullptr};
+    };
+
+    std::array<SizeClass, SizeClasses.size()> classes_{};
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    ArenaStats stats_{};
+};
+
+/**
+ * @brief Get the arena that ArenaAllocated objects are currently allocated
+ * from on the calling thread, or nullptr for the heap.
+ */
+Arena* CurrentArena();
+
+/**
+ * @brief Makes ArenaAllocated objects allocate from an arena (or the heap, if
+ * nullptr) on the calling thread for the lifetime of the scope, restoring the
+ * previous arena afterwards.
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena* arena);
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+private:
+    Arena* previous_;
+};
+
+/**
+ * @brief Base for classes whose instances are allocated from the current arena
+ * (see ArenaScope) when one is set, and from the heap otherwise. Each instance
+ * remembers where it came from, so it can be deleted under any scope.
+ */
+class ArenaAllocated {
+public:
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr, std::size_t size);
+};
+
+} // namespace sge::util
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <dnsge/HashMap.hpp>
+
 #include <cstddef>
 #include <functional>
 #include <string>
@@ -29,3 +31,7 @@ struct StringHash {
 template <typename V>
 using unordered_string_map =
     std::unordered_map<std::string, V, detail::StringHash, std::equal_to<>>;
+
+// Stores values inline, so values may move when inserting
+template <typename V>
+using flat_string_map = dnsge::HashMap<std::string, V, detail::StringHash, std::equal_to<>>;
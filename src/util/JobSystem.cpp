@@ -0,0 +1,181 @@
+#include "util/JobSystem.hpp"
+
+#include "util/Trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace sge::util {
+
+namespace {
+
+/**
+ * @brief State of a parallelFor call, shared with the jobs that help run it.
+ * Chunks are claimed from a counter rather than assigned up front, so a
+ * helper that starts late simply finds nothing left to do.
+ */
+struct Batch {
+    std::size_t count;
+    std::size_t grain;
+    std::size_t chunks;
+    const std::function<void(std::size_t, std::size_t)>* f;
+
+    std::atomic<std::size_t> nextChunk{0};
+    std::atomic<std::size_t> doneChunks{0};
+    std::mutex mu;
+    std::condition_variable finished;
+};
+
+void runChunks(Batch &batch) {
+    while (true) {
+        auto chunk = batch.nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= batch.chunks) {
+            return;
+        }
+        auto begin = chunk * batch.grain;
+        auto end = std::min(begin + batch.grain, batch.count);
+        (*batch.f)(begin, end);
+
+        if (batch.doneChunks.fetch_add(1, std::memory_order_acq_rel) + 1 == batch.chunks) {
+            std::lock_guard guard(batch.mu);
+            batch.finished.notify_all();
+        }
+    }
+}
+
+} // namespace
+
+JobSystem::JobSystem(unsigned int workers) {
+    for (unsigned int i = 0; i < workers; ++i) {
+        this->queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned int i = 0; i < workers; ++i) {
+        this->threads_.emplace_back([this, i] {
+            SetTraceThreadName("Job worker " + std::to_string(i));
+            this->workerMain(i);
+        });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard guard(this->sleepMu_);
+        this->stopping_ = true;
+    }
+    this->wake_.notify_all();
+    for (auto &thread : this->threads_) {
+        thread.join();
+    }
+}
+
+unsigned int JobSystem::workerCount() const {
+    return static_cast<unsigned int>(this->threads_.size());
+}
+
+void JobSystem::parallelFor(std::size_t count, std::size_t grain,
+                            const std::function<void(std::size_t, std::size_t)> &f) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    auto chunks = (count + grain - 1) / grain;
+    if (chunks == 1 || this->threads_.empty()) {
+        f(0, count);
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->count = count;
+    batch->grain = grain;
+    batch->chunks = chunks;
+    batch->f = &f;
+
+    // The calling thread takes chunks too, so it needs one helper fewer
+    auto helpers = std::min<std::size_t>(chunks - 1, this->threads_.size());
+    for (std::size_t i = 0; i < helpers; ++i) {
+        this->submit([batch] {
+            runChunks(*batch);
+        });
+    }
+    runChunks(*batch);
+
+    // Wait for chunks still running on workers. Helpers that haven't started by
+    // now will find no chunks left and never touch f.
+    std::unique_lock lock(batch->mu);
+    batch->finished.wait(lock, [&batch] {
+        return batch->doneChunks.load(std::memory_order_acquire) == batch->chunks;
+    });
+}
+
+void JobSystem::submit(Job job) {
+    auto index = this->nextQueue_.fetch_add(1, std::memory_order_relaxed) % this->queues_.size();
+    auto &queue = *this->queues_[index];
+    // Counted before it is queued, so the count never drops below zero
+    this->queuedJobs_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard guard(queue.mu);
+        queue.jobs.push_back(std::move(job));
+    }
+    {
+        // Pairs with the predicate check in workerMain, so the wake-up can't
+        // slip in between a worker checking for jobs and going to sleep
+        std::lock_guard guard(this->sleepMu_);
+    }
+    this->wake_.notify_one();
+}
+
+bool JobSystem::tryRunJob(std::size_t home) {
+    Job job;
+    for (std::size_t i = 0; i < this->queues_.size() && !job; ++i) {
+        auto &queue = *this->queues_[(home + i) % this->queues_.size()];
+        std::lock_guard guard(queue.mu);
+        if (queue.jobs.empty()) {
+            continue;
+        }
+        if (i == 0) {
+            // Newest job of our own queue, which is likely still in cache
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        } else {
+            // Steal the oldest job of another worker
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+    }
+    if (!job) {
+        return false;
+    }
+    this->queuedJobs_.fetch_sub(1, std::memory_order_acq_rel);
+    job();
+    return true;
+}
+
+void JobSystem::workerMain(std::size_t index) {
+    while (true) {
+        if (this->tryRunJob(index)) {
+            continue;
+        }
+        std::unique_lock lock(this->sleepMu_);
+        this->wake_.wait(lock, [this] {
+            return this->stopping_ || this->queuedJobs_.load(std::memory_order_acquire) > 0;
+        });
+        if (this->stopping_ && this->queuedJobs_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+JobSystem &Jobs() {
+    static JobSystem jobs{std::max(std::thread::hardware_concurrency(), 1U) - 1};
+    return jobs;
+}
+
+} // namespace sge::util
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sge::util {
+
+/**
+ * @brief A pool of worker threads that run jobs from per-worker queues. A
+ * worker takes jobs from the back of its own queue and, once that is empty,
+ * steals from the front of the others', so uneven batches still keep every
+ * worker busy.
+ *
+ * Any number of threads may submit work at once.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * @param workers Number of worker threads. With zero workers, every job
+     * runs on the thread that waits for it.
+     */
+    explicit JobSystem(unsigned int workers);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    unsigned int workerCount() const;
+
+    /**
+     * @brief Call f(begin, end) over consecutive chunks of [0, count) of at
+     * most grain indices each, spread across the workers and the calling
+     * thread. Returns once every chunk has run. f must not throw.
+     *
+     * Runs f(0, count) inline if count fits in a single chunk.
+     */
+    void parallelFor(std::size_t count, std::size_t grain,
+                     const std::function<void(std::size_t, std::size_t)> &f);
+
+private:
+    struct WorkerQueue {
+        std::mutex mu;
+        std::deque<Job> jobs;
+    };
+
+    void submit(Job job);
+    bool tryRunJob(std::size_t home);
+    void workerMain(std::size_t index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    // Idle workers sleep until jobs are submitted
+    std::mutex sleepMu_;
+    std::condition_variable wake_;
+    std::atomic<std::size_t> queuedJobs_{0};
+    std::atomic<std::size_t> nextQueue_{0};
+    bool stopping_{false};
+};
+
+/**
+ * @brief Get the process-wide job system, with one worker per hardware thread
+ * besides the calling one. Created on first use.
+ */
+JobSystem &Jobs();
+
+} // namespace sge::util
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace sge::util {
+
+constexpr std::size_t DefaultMpscQueueCapacity = 1000;
+
+// NOLINTBEGIN(readability-identifier-naming)
+
+/**
+ * @brief A bounded queue that any number of threads may push onto while one
+ * thread consumes it. Guarded by a mutex, unlike AsyncSpscQueue, since its
+ * producers aren't known up front.
+ */
+template <typename T, std::size_t Capacity = DefaultMpscQueueCapacity>
+class MpscQueue {
+public:
+    using owning_ptr = std::unique_ptr<T>;
+
+    /**
+     * @brief Attempt to push an item onto the queue.
+     *
+     * @param item Item to push.
+     * @return true If the push succeeds.
+     * @return false If the push fails.
+     */
+    bool push(owning_ptr &item) {
+        assert(item != nullptr);
+        std::lock_guard guard(this->mu_);
+        if (this->queue_.size() >= Capacity) {
+            return false;
+        }
+        this->queue_.push_back(std::move(item));
+        return true;
+    }
+
+    /**
+     * @brief Attempt to push an item onto the queue.
+     *
+     * @param item Item to push.
+     * @return true If the push succeeds.
+     * @return false If the push fails.
+     */
+    bool push(const T &item) {
+        auto owned = std::make_unique<T>(item);
+        return this->push(owned);
+    }
+
+    /**
+     * @brief Attempt to push an item onto the queue.
+     *
+     * @param item Item to push.
+     * @return true If the push succeeds.
+     * @return false If the push fails.
+     */
+    bool push(T &&item) {
+        auto owned = std::make_unique<T>(std::move(item));
+        return this->push(owned);
+    }
+
+    /**
+     * @brief Attempt to consume one item from the queue.
+     *
+     * @param f Functor to process the consumed item.
+     * @return true If an item was consumed.
+     * @return false If an item was not consumed.
+     */
+    template <typename F>
+    bool consume_one(F f) {
+        owning_ptr item;
+        {
+            std::lock_guard guard(this->mu_);
+            if (this->queue_.empty()) {
+                return false;
+            }
+            item = std::move(this->queue_.front());
+            this->queue_.pop_front();
+        }
+        f(std::move(item));
+        return true;
+    }
+
+    /**
+     * @brief Attempt to consume all items in the queue. Items pushed while
+     * they are being consumed are left for the next call.
+     *
+     * @param f Functor to process the consumed items.
+     * @return The number of items consumed.
+     */
+    template <typename F>
+    std::size_t consume_all(F f) {
+        // Take the items first, so that producers aren't held up by f
+        std::deque<owning_ptr> items;
+        {
+            std::lock_guard guard(this->mu_);
+            items.swap(this->queue_);
+        }
+        for (auto &item : items) {
+            f(std::move(item));
+        }
+        return items.size();
+    }
+
+private:
+    std::mutex mu_;
+    std::deque<owning_ptr> queue_;
+};
+
+// NOLINTEND(readability-identifier-naming)
+
+} // namespace sge::util
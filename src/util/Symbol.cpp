@@ -0,0 +1,83 @@
+#include "util/Symbol.hpp"
+
+#include "util/HeterogeneousLookup.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+namespace sge::util {
+
+namespace {
+
+struct SymbolTable {
+    std::shared_mutex mu;
+    // Node-based, so symbol data can view the keys
+    unordered_string_map<const detail::SymbolData*> symbols;
+    // A deque, so symbol data never moves
+    std::deque<detail::SymbolData> data;
+};
+
+SymbolTable &Table() {
+    static SymbolTable table;
+    return table;
+}
+
+// Symbols this thread has already looked up, so that repeated lookups of a
+// string don't contend on the table lock
+thread_local unordered_string_map<const detail::SymbolData*> LocalSymbols;
+
+} // namespace
+
+Symbol Intern(std::string_view s) {
+    if (s.empty()) {
+        return Symbol{};
+    }
+    if (auto local = LocalSymbols.find(s); local != LocalSymbols.end()) {
+        return Symbol{local->second};
+    }
+
+    auto &table = Table();
+    const detail::SymbolData* data = nullptr;
+    {
+        std::lock_guard lock(table.mu);
+        auto it = table.symbols.find(s);
+        if (it == table.symbols.end()) {
+            it = table.symbols.emplace(std::string{s}, nullptr).first;
+            // Id 0 is the empty string
+            auto id = static_cast<std::uint32_t>(table.data.size() + 1);
+            it->second = &table.data.emplace_back(detail::SymbolData{it->first, id});
+        }
+        data = it->second;
+    }
+    LocalSymbols.emplace(std::string{s}, data);
+    return Symbol{data};
+}
+
+std::optional<Symbol> FindSymbol(std::string_view s) {
+    if (s.empty()) {
+        return Symbol{};
+    }
+    if (auto local = LocalSymbols.find(s); local != LocalSymbols.end()) {
+        return Symbol{local->second};
+    }
+
+    auto &table = Table();
+    const detail::SymbolData* data = nullptr;
+    {
+        std::shared_lock lock(table.mu);
+        auto it = table.symbols.find(s);
+        if (it == table.symbols.end()) {
+            return std::nullopt;
+        }
+        data = it->second;
+    }
+    LocalSymbols.emplace(std::string{s}, data);
+    return Symbol{data};
+}
+
+} // namespace sge::util
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+
+namespace sge::util {
+
+namespace detail {
+
+struct SymbolData {
+    std::string_view str;
+    std::uint32_t id;
+};
+
+inline constexpr SymbolData EmptySymbolData{"", 0};
+
+} // namespace detail
+
+/**
+ * @brief An interned string. Every thread gets the same symbol for the same
+ * string, so symbols compare and hash as integers and their string can be
+ * read without a lookup. Symbols are never freed.
+ */
+class Symbol {
+public:
+    /**
+     * @brief The symbol of the empty string.
+     */
+    constexpr Symbol() = default;
+
+    constexpr std::uint32_t id() const {
+        return this->data_->id;
+    }
+
+    /**
+     * @brief The interned string. Valid for the lifetime of the process.
+     */
+    constexpr std::string_view str() const {
+        return this->data_->str;
+    }
+
+    constexpr bool empty() const {
+        return this->data_->id == 0;
+    }
+
+    constexpr bool operator==(const Symbol &other) const {
+        return this->data_ == other.data_;
+    }
+
+    /**
+     * @brief Orders symbols by when they were interned, not by their strings.
+     */
+    constexpr std::strong_ordering operator<=>(const Symbol &other) const {
+        return this->id() <=> other.id();
+    }
+
+private:
+    friend Symbol Intern(std::string_view s);
+    friend std::optional<Symbol> FindSymbol(std::string_view s);
+
+    constexpr explicit Symbol(const detail::SymbolData* data)
+        : data_(data) {}
+
+    const detail::SymbolData* data_{&detail::EmptySymbolData};
+};
+
+/**
+ * @brief Get the symbol of a string, interning it if needed.
+ */
+Symbol Intern(std::string_view s);
+
+/**
+ * @brief Get the symbol of a string if it has been interned. Use this for
+ * lookups with strings from scripts, so arbitrary strings aren't kept alive.
+ */
+std::optional<Symbol> FindSymbol(std::string_view s);
+
+} // namespace sge::util
+
+template <>
+struct std::hash<sge::util::Symbol> {
+    std::size_t operator()(const sge::util::Symbol &symbol) const {
+        return std::hash<std::uint32_t>{}(symbol.id());
+    }
+};
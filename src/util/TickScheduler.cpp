@@ -0,0 +1,91 @@
+#include "util/TickScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace sge::util {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+TickScheduler::TickScheduler(unsigned int tickRate, TickOverrunPolicy policy,
+                             std::chrono::microseconds spinTime)
+    : period_(nanoseconds(std::chrono::seconds(1)) / tickRate)
+    , policy_(policy)
+    , spinTime_(spinTime) {}
+
+void TickScheduler::start() {
+    this->deadline_ = clock::now();
+    ++this->stats_.ticks;
+}
+
+void TickScheduler::waitForNextTick() {
+    if (this->advance(clock::now())) {
+        return;
+    }
+
+    this->sleepUntil(this->deadline_);
+
+    // Record how late the wake-up was
+    auto late = duration_cast<microseconds>(clock::now() - this->deadline_);
+    auto lateUs = static_cast<std::uint64_t>(late.count());
+    this->stats_.jitterTotalUs += lateUs;
+    if (lateUs > this->stats_.jitterMaxUs) {
+        this->stats_.jitterMaxUs = lateUs;
+    }
+}
+
+bool TickScheduler::advance(clock::time_point now) {
+    this->deadline_ += this->period_;
+    ++this->stats_.ticks;
+    if (now < this->deadline_) {
+        return false;
+    }
+
+    // The previous tick ran past this tick's deadline. Start the tick right
+    // away. The deadlines that were missed entirely are either run
+    // back-to-back (catch up, up to MaxCatchUpTicks of them) or dropped (skip).
+    ++this->stats_.lateTicks;
+    auto missed = static_cast<std::uint64_t>((now - this->deadline_) / this->period_);
+    auto kept = this->policy_ == TickOverrunPolicy::CatchUp ? std::min(missed, MaxCatchUpTicks)
+                                                             : std::uint64_t{0};
+    auto dropped = missed - kept;
+    this->deadline_ += this->period_ * dropped;
+    this->stats_.skippedTicks += dropped;
+    return true;
+}
+
+std::chrono::nanoseconds TickScheduler::period() const {
+    return this->period_;
+}
+
+const TickSchedulerStats &TickScheduler::stats() const {
+    return this->stats_;
+}
+
+TickScheduler::clock::time_point TickScheduler::nextDeadline() const {
+    return this->deadline_ + this->period_;
+}
+
+std::uint64_t TickScheduler::takeMaxJitterUs() {
+    return this->stats_.jitterMaxUs.exchange(0);
+}
+
+void TickScheduler::sleepUntil(clock::time_point deadline) const {
+    // Sleep for the bulk of the wait. The OS may oversleep by a scheduler
+    // quantum, so wake up spinTime_ early.
+    auto sleepDeadline = deadline - this->spinTime_;
+    if (clock::now() < sleepDeadline) {
+        std::this_thread::sleep_until(sleepDeadline);
+    }
+
+    // Spin for the remainder
+    while (clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace sge::util
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace sge::util {
+
+/**
+ * @brief What a TickScheduler does when a tick finishes after the deadline of
+ * the following tick.
+ */
+enum class TickOverrunPolicy {
+    // Run the missed ticks back-to-back until the schedule is caught up, up to
+    // MaxCatchUpTicks of them
+    CatchUp,
+    // Drop the missed ticks and continue on the next deadline
+    Skip,
+};
+
+constexpr TickOverrunPolicy TickOverrunPolicyOfString(std::string_view s) {
+    using namespace std::string_view_literals;
+    if (s == "catch_up"sv) {
+        return TickOverrunPolicy::CatchUp;
+    } else if (s == "skip"sv) {
+        return TickOverrunPolicy::Skip;
+    } else {
+        return TickOverrunPolicy::Skip;
+    }
+}
+
+/**
+ * @brief Maximum number of missed ticks that TickOverrunPolicy::CatchUp will
+ * run back-to-back. Falling further behind than this drops the excess ticks so
+ * that a long stall can't turn into a burst of hundreds of ticks.
+ */
+constexpr std::uint64_t MaxCatchUpTicks = 5;
+
+/**
+ * @brief Counters kept by a TickScheduler. Written by the scheduling thread and
+ * safe to read from any thread.
+ */
+struct TickSchedulerStats {
+    // Number of ticks started
+    std::atomic<std::uint64_t> ticks{0};
+    // Ticks that started after their deadline because the previous tick overran
+    std::atomic<std::uint64_t> lateTicks{0};
+    // Ticks dropped because of an overrun
+    std::atomic<std::uint64_t> skippedTicks{0};
+    // Sum and maximum of how far past the deadline on-time ticks woke up
+    std::atomic<std::uint64_t> jitterTotalUs{0};
+    std::atomic<std::uint64_t> jitterMaxUs{0};
+};
+
+/**
+ * @brief Paces a loop at a fixed tick rate using absolute deadlines, so time
+ * spent ticking never shifts the schedule.
+ *
+ * Waiting sleeps until shortly before the deadline and spins for the remainder,
+ * trading a little CPU for wake-ups that land within microseconds of the
+ * deadline.
+ */
+class TickScheduler {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * @param tickRate Ticks per second.
+     * @param policy What to do when a tick overruns.
+     * @param spinTime How long before a deadline to stop sleeping and start
+     * spinning.
+     */
+    TickScheduler(unsigned int tickRate, TickOverrunPolicy policy,
+                  std::chrono::microseconds spinTime);
+
+    /**
+     * @brief Start the schedule. The first tick is due immediately.
+     */
+    void start();
+
+    /**
+     * @brief Block until the next tick is due.
+     */
+    void waitForNextTick();
+
+    /**
+     * @brief Move the schedule on to the next tick and count it, as if the
+     * current time were now. Returns true if the tick is late, i.e. due right
+     * away because the previous one overran, after applying the overrun
+     * policy. waitForNextTick does this, then sleeps until the deadline of a
+     * tick that isn't late. Exposed so that overruns can be checked with
+     * made-up times.
+     */
+    bool advance(clock::time_point now);
+
+    /**
+     * @brief Deadline that the next waitForNextTick waits for, unless the
+     * current tick overruns it.
+     */
+    clock::time_point nextDeadline() const;
+
+    std::chrono::nanoseconds period() const;
+    const TickSchedulerStats &stats() const;
+
+    /**
+     * @brief Reset the maximum jitter, returning the previous value.
+     */
+    std::uint64_t takeMaxJitterUs();
+
+private:
+    void sleepUntil(clock::time_point deadline) const;
+
+    std::chrono::nanoseconds period_;
+    TickOverrunPolicy policy_;
+    std::chrono::microseconds spinTime_;
+
+    clock::time_point deadline_{};
+    TickSchedulerStats stats_;
+};
+
+} // namespace sge::util
@@ -0,0 +1,271 @@
+#include "util/Trace.hpp"
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace sge::util {
+
+namespace detail {
+
+std::atomic<bool> TracingEnabledFlag{false};
+
+} // namespace detail
+
+namespace {
+
+static_assert((TraceEventsPerThread & (TraceEventsPerThread - 1)) == 0,
+              "TraceEventsPerThread must be a power of two");
+
+using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
+/**
+ * @brief A slot in a thread's ring buffer. Fields are atomics so that a dump
+ * can read slots while the owning thread keeps recording; relaxed accesses
+ * compile to plain loads and stores.
+ */
+struct TraceEvent {
+    std::atomic<std::uint64_t> timestampNs{0};
+    // Zone name for the start of a zone, nullptr for the end of one
+    std::atomic<const char*> name{nullptr};
+    std::atomic<const char*> detail{nullptr};
+};
+
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const {
+        return std::hash<std::string_view>{}(s);
+    }
+};
+
+/**
+ * @brief Events recorded by one thread. Only the owning thread writes events
+ * and interns strings; dumps may read from any thread.
+ */
+struct ThreadBuffer {
+    explicit ThreadBuffer(std::uint32_t id)
+        : threadID(id)
+        , events(std::make_unique<TraceEvent[]>(TraceEventsPerThread)) {}
+
+    std::uint32_t threadID;
+    std::atomic<const char*> threadName{nullptr};
+
+    std::unique_ptr<TraceEvent[]> events;
+    // Total number of events ever recorded. The next event goes in slot
+    // head % TraceEventsPerThread.
+    std::atomic<std::uint64_t> head{0};
+
+    // Node-based, so interned pointers stay valid as the set grows
+    std::unordered_set<std::string, StringHash, std::equal_to<>> interned;
+};
+
+const auto TraceEpoch = std::chrono::steady_clock::now();
+std::atomic<std::uint64_t> TraceStartNs{0};
+
+// Buffers of every thread that has recorded an event. Buffers are never
+// removed, so a dump still includes threads that have exited.
+std::mutex BuffersMu;
+std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+
+thread_local ThreadBuffer* CurrentBuffer = nullptr;
+
+std::uint64_t NowNs() {
+    auto elapsed = std::chrono::steady_clock::now() - TraceEpoch;
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+ThreadBuffer &CurrentThreadBuffer() {
+    if (CurrentBuffer == nullptr) [[unlikely]] {
+        std::lock_guard guard(BuffersMu);
+        auto id = static_cast<std::uint32_t>(Buffers.size());
+        CurrentBuffer = Buffers.emplace_back(std::make_unique<ThreadBuffer>(id)).get();
+    }
+    return *CurrentBuffer;
+}
+
+void RecordEvent(const char* name, const char* detail) {
+    auto &buffer = CurrentThreadBuffer();
+    auto index = buffer.head.load(std::memory_order_relaxed);
+    auto &event = buffer.events[index & (TraceEventsPerThread - 1)];
+    event.timestampNs.store(NowNs(), std::memory_order_relaxed);
+    event.name.store(name, std::memory_order_relaxed);
+    event.detail.store(detail, std::memory_order_relaxed);
+    buffer.head.store(index + 1, std::memory_order_release);
+}
+
+struct EventCopy {
+    std::uint64_t timestampNs;
+    const char* name;
+    const char* detail;
+};
+
+/**
+ * @brief Copy the events of a buffer that are still intact, oldest first.
+ */
+std::vector<EventCopy> CopyEvents(const ThreadBuffer &buffer) {
+    auto head = buffer.head.load(std::memory_order_acquire);
+    auto first = head > TraceEventsPerThread ? head - TraceEventsPerThread : 0;
+
+    std::vector<EventCopy> events;
+    events.reserve(head - first);
+    for (auto i = first; i < head; ++i) {
+        const auto &event = buffer.events[i & (TraceEventsPerThread - 1)];
+        events.push_back(EventCopy{
+            .timestampNs = event.timestampNs.load(std::memory_order_relaxed),
+            .name = event.name.load(std::memory_order_relaxed),
+            .detail = event.detail.load(std::memory_order_relaxed),
+        });
+    }
+
+    // The owning thread may have lapped us while copying. Drop every event
+    // whose slot has been (or is being) overwritten since.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto headAfter = buffer.head.load(std::memory_order_relaxed);
+    auto firstIntact = headAfter + 1 > TraceEventsPerThread ? headAfter + 1 - TraceEventsPerThread
+                                                            : 0;
+    if (firstIntact > first) {
+        auto dropped = std::min<std::uint64_t>(firstIntact - first, events.size());
+        events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(dropped));
+    }
+    return events;
+}
+
+void WriteEventHeader(JsonWriter &writer, const char* phase, std::uint32_t threadID,
+                      std::uint64_t timestampNs) {
+    writer.Key("ph");
+    writer.String(phase);
+    writer.Key("pid");
+    writer.Uint(1);
+    writer.Key("tid");
+    writer.Uint(threadID);
+    writer.Key("ts");
+    writer.Double(static_cast<double>(timestampNs) / 1000.0);
+}
+
+void WriteThreadEvents(JsonWriter &writer, const ThreadBuffer &buffer, std::uint64_t startNs,
+                       std::uint64_t endNs) {
+    const auto* threadName = buffer.threadName.load(std::memory_order_relaxed);
+    if (threadName != nullptr) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String("thread_name");
+        WriteEventHeader(writer, "M", buffer.threadID, 0);
+        writer.Key("args");
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(threadName);
+        writer.EndObject();
+        writer.EndObject();
+    }
+
+    // Zones can be cut in half by the start of the recording or by the ring
+    // buffer wrapping around. Skip ends without a matching begin, and close
+    // zones that are still open at the time of the dump.
+    std::size_t depth = 0;
+    for (const auto &event : CopyEvents(buffer)) {
+        if (event.timestampNs < startNs) {
+            continue;
+        }
+
+        if (event.name != nullptr) {
+            ++depth;
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(event.name);
+            WriteEventHeader(writer, "B", buffer.threadID, event.timestampNs);
+            if (event.detail != nullptr) {
+                writer.Key("args");
+                writer.StartObject();
+                writer.Key("detail");
+                writer.String(event.detail);
+                writer.EndObject();
+            }
+            writer.EndObject();
+        } else if (depth > 0) {
+            --depth;
+            writer.StartObject();
+            WriteEventHeader(writer, "E", buffer.threadID, event.timestampNs);
+            writer.EndObject();
+        }
+    }
+
+    for (; depth > 0; --depth) {
+        writer.StartObject();
+        WriteEventHeader(writer, "E", buffer.threadID, endNs);
+        writer.EndObject();
+    }
+}
+
+} // namespace
+
+void StartTracing() {
+    TraceStartNs.store(NowNs(), std::memory_order_relaxed);
+    detail::TracingEnabledFlag.store(true, std::memory_order_relaxed);
+}
+
+void StopTracing() {
+    detail::TracingEnabledFlag.store(false, std::memory_order_relaxed);
+}
+
+void BeginTraceZone(const char* name, const char* detail) {
+    RecordEvent(name, detail);
+}
+
+void EndTraceZone() {
+    RecordEvent(nullptr, nullptr);
+}
+
+const char* InternTraceString(std::string_view s) {
+    auto &interned = CurrentThreadBuffer().interned;
+    auto it = interned.find(s);
+    if (it == interned.end()) {
+        it = interned.emplace(s).first;
+    }
+    return it->c_str();
+}
+
+void SetTraceThreadName(std::string_view name) {
+    CurrentThreadBuffer().threadName.store(InternTraceString(name), std::memory_order_relaxed);
+}
+
+bool WriteChromeTrace(const std::filesystem::path &path) {
+    auto startNs = TraceStartNs.load(std::memory_order_relaxed);
+    auto endNs = NowNs();
+
+    rapidjson::StringBuffer out;
+    JsonWriter writer{out};
+    writer.StartObject();
+    writer.Key("displayTimeUnit");
+    writer.String("ms");
+    writer.Key("traceEvents");
+    writer.StartArray();
+    {
+        std::lock_guard guard(BuffersMu);
+        for (const auto &buffer : Buffers) {
+            WriteThreadEvents(writer, *buffer, startNs, endNs);
+        }
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    std::ofstream file{path, std::ios::trunc};
+    file << out.GetString();
+    return file.good();
+}
+
+} // namespace sge::util
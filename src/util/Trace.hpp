@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace sge::util {
+
+/**
+ * @brief Number of events each thread keeps. Older events are overwritten once
+ * a thread's buffer is full, so a dump holds the most recent activity.
+ */
+constexpr std::size_t TraceEventsPerThread = 1 << 16;
+
+namespace detail {
+
+extern std::atomic<bool> TracingEnabledFlag;
+
+} // namespace detail
+
+/**
+ * @brief Whether trace zones are currently being recorded.
+ */
+inline bool TracingEnabled() {
+    return detail::TracingEnabledFlag.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Start recording trace zones on all threads.
+ */
+void StartTracing();
+
+/**
+ * @brief Stop recording trace zones. Recorded events are kept until they are
+ * overwritten by a later recording.
+ */
+void StopTracing();
+
+/**
+ * @brief Record the start of a zone on the calling thread.
+ *
+ * @param name Zone name. Must outlive the trace, e.g. a string literal or a
+ * string returned by InternTraceString.
+ * @param detail Optional detail shown with the zone, with the same lifetime
+ * requirement as name.
+ */
+void BeginTraceZone(const char* name, const char* detail = nullptr);
+
+/**
+ * @brief Record the end of the innermost open zone on the calling thread.
+ */
+void EndTraceZone();
+
+/**
+ * @brief Get a copy of a string that lives as long as the process, for use as
+ * a zone name or detail. Repeated calls with the same string on a thread
+ * return the same pointer.
+ */
+const char* InternTraceString(std::string_view s);
+
+/**
+ * @brief Name the calling thread in trace dumps.
+ */
+void SetTraceThreadName(std::string_view name);
+
+/**
+ * @brief Write the events recorded on all threads as Chrome trace JSON
+ * (loadable in chrome://tracing or Perfetto).
+ *
+ * @return Whether the file was written.
+ */
+bool WriteChromeTrace(const std::filesystem::path &path);
+
+/**
+ * @brief Records a zone spanning its lifetime. Costs a single relaxed load when
+ * tracing is disabled.
+ */
+class TraceZone {
+public:
+    explicit TraceZone(const char* name) {
+        if (TracingEnabled()) [[unlikely]] {
+            BeginTraceZone(name);
+            this->active_ = true;
+        }
+    }
+
+    TraceZone(const char* name, std::string_view detail) {
+        if (TracingEnabled()) [[unlikely]] {
+            BeginTraceZone(name, InternTraceString(detail));
+            this->active_ = true;
+        }
+    }
+
+    ~TraceZone() {
+        if (this->active_) [[unlikely]] {
+            EndTraceZone();
+        }
+    }
+
+    TraceZone(const TraceZone &) = delete;
+    TraceZone &operator=(const TraceZone &) = delete;
+
+private:
+    bool active_{false};
+};
+
+} // namespace sge::util
+
+#define SGE_TRACE_CONCAT_INNER(a, b) a##b
+#define SGE_TRACE_CONCAT(a, b) SGE_TRACE_CONCAT_INNER(a, b)
+
+#ifdef SGE_TRACING
+#    define TRACE_ZONE(name) \
+        ::sge::util::TraceZone SGE_TRACE_CONCAT(traceZone_, __LINE__) { name }
+#    define TRACE_ZONE_DETAIL(name, detail) \
+        ::sge::util::TraceZone SGE_TRACE_CONCAT(traceZone_, __LINE__) { name, detail }
+#else
+#    define TRACE_ZONE(name) ((void)0)
+#    define TRACE_ZONE_DETAIL(name, detail) ((void)0)
+#endif